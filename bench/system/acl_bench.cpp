@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <benchmark/benchmark.h>
+#include <protocols/ip/acl.h>
+
+#include <random>
+#include <vector>
+
+namespace bro::protocols::bench {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::prefix;
+
+static std::vector<prefix> make_prefixes(size_t count) {
+  std::mt19937 gen(1);
+  std::vector<prefix> prefixes;
+  for (size_t i = 0; i < count; ++i)
+    prefixes.emplace_back(address(bro::net::proto::ip::v4::address(static_cast<uint32_t>(gen()))),
+                          static_cast<uint8_t>(gen() % 17 + 16));
+  return prefixes;
+}
+
+static std::vector<bro::net::proto::ip::v4::address> make_addresses() {
+  std::mt19937 gen(2);
+  std::vector<bro::net::proto::ip::v4::address> addrs(4096);
+  for (auto &addr : addrs)
+    addr = bro::net::proto::ip::v4::address(static_cast<uint32_t>(gen()));
+  return addrs;
+}
+
+static void acl_linear(benchmark::State &state) {
+  auto const prefixes = make_prefixes(static_cast<size_t>(state.range(0)));
+  auto const addrs = make_addresses();
+  std::vector<uint32_t> indices(addrs.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < addrs.size(); ++i) {
+      indices[i] = bro::net::proto::ip::acl::e_no_match;
+      for (size_t j = 0; j < prefixes.size(); ++j) {
+        if (prefixes[j].contains(address(addrs[i]))) {
+          indices[i] = static_cast<uint32_t>(j);
+          break;
+        }
+      }
+    }
+    benchmark::DoNotOptimize(indices.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * addrs.size()));
+}
+
+static void acl_batch(benchmark::State &state) {
+  bro::net::proto::ip::acl const list(make_prefixes(static_cast<size_t>(state.range(0))));
+  auto const addrs = make_addresses();
+  std::vector<uint32_t> indices(addrs.size());
+  for (auto _ : state) {
+    list.match(addrs.data(), addrs.size(), indices.data());
+    benchmark::DoNotOptimize(indices.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * addrs.size()));
+}
+
+BENCHMARK(acl_linear)->Arg(8)->Arg(32)->Arg(64);
+BENCHMARK(acl_batch)->Arg(8)->Arg(32)->Arg(64);
+
+} // namespace bro::protocols::bench
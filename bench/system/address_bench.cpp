@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <benchmark/benchmark.h>
+#include <protocols/ip/address.h>
+
+#include <random>
+#include <vector>
+
+namespace bro::protocols::bench {
+
+using bro::net::proto::ip::address;
+
+namespace v6 = bro::net::proto::ip::v6;
+
+static std::vector<v6::address> make_addresses() {
+  std::mt19937_64 gen(1);
+  std::vector<v6::address> addrs;
+  for (size_t i = 0; i < 4096; ++i)
+    addrs.emplace_back(gen(), gen());
+  return addrs;
+}
+
+static void address_mask_dynamic(benchmark::State &state) {
+  auto const v6_addrs = make_addresses();
+  std::vector<address> addrs(v6_addrs.begin(), v6_addrs.end()), res(addrs.size());
+  address const mask("ffff:ffff:ffff:ffff::");
+  for (auto _ : state) {
+    for (size_t i = 0; i < addrs.size(); ++i)
+      res[i] = addrs[i] & mask;
+    benchmark::DoNotOptimize(res.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * addrs.size()));
+}
+
+static void address_mask_static(benchmark::State &state) {
+  auto const addrs = make_addresses();
+  std::vector<v6::address> res(addrs.size());
+  v6::address const mask("ffff:ffff:ffff:ffff::");
+  for (auto _ : state) {
+    bro::net::proto::ip::mask_addresses(addrs.data(), addrs.size(), mask, res.data());
+    benchmark::DoNotOptimize(res.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * addrs.size()));
+}
+
+BENCHMARK(address_mask_dynamic);
+BENCHMARK(address_mask_static);
+
+} // namespace bro::protocols::bench
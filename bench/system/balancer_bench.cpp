@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <benchmark/benchmark.h>
+#include <protocols/ip/balancer.h>
+#include <protocols/ip/numeric.h>
+
+#include <random>
+#include <vector>
+
+namespace bro::protocols::bench {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::full_address;
+using bro::net::proto::ip::maglev_balancer;
+using bro::net::proto::ip::maglev_table;
+using bro::net::proto::ip::rendezvous;
+
+static std::vector<full_address> make_endpoints(size_t count, uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::vector<full_address> endpoints;
+  for (size_t i = 0; i < count; ++i) {
+    endpoints.emplace_back(address(bro::net::proto::ip::to_v4_address(static_cast<uint32_t>(gen()))),
+                           static_cast<uint16_t>(gen()));
+  }
+  return endpoints;
+}
+
+static void maglev_build(benchmark::State &state) {
+  auto const backends = make_endpoints(static_cast<size_t>(state.range(0)), 1);
+  for (auto _ : state) {
+    maglev_table const table(backends);
+    benchmark::DoNotOptimize(table.get_slot(0));
+  }
+}
+
+static void maglev_lookup(benchmark::State &state) {
+  maglev_table const table(make_endpoints(static_cast<size_t>(state.range(0)), 1));
+  auto const clients = make_endpoints(4096, 2);
+  for (auto _ : state) {
+    for (auto const &client : clients)
+      benchmark::DoNotOptimize(table.lookup(client));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * clients.size()));
+}
+
+static void maglev_select(benchmark::State &state) {
+  maglev_balancer balancer;
+  balancer.update(make_endpoints(static_cast<size_t>(state.range(0)), 1));
+  auto const clients = make_endpoints(4096, 2);
+  full_address backend;
+  for (auto _ : state) {
+    for (auto const &client : clients)
+      benchmark::DoNotOptimize(balancer.select(client, backend));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * clients.size()));
+}
+
+static void rendezvous_lookup(benchmark::State &state) {
+  rendezvous const hrw(make_endpoints(static_cast<size_t>(state.range(0)), 1));
+  auto const clients = make_endpoints(4096, 2);
+  for (auto _ : state) {
+    for (auto const &client : clients)
+      benchmark::DoNotOptimize(hrw.lookup(client));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * clients.size()));
+}
+
+BENCHMARK(maglev_build)->Arg(10)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK(maglev_lookup)->Arg(1000);
+BENCHMARK(maglev_select)->Arg(1000);
+BENCHMARK(rendezvous_lookup)->Arg(10)->Arg(100);
+
+} // namespace bro::protocols::bench
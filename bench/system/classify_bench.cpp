@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <benchmark/benchmark.h>
+#include <protocols/ip/classify.h>
+
+#include <random>
+#include <vector>
+
+namespace bro::protocols::bench {
+
+using bro::net::proto::ip::flow_keys;
+using bro::net::proto::ip::packet;
+
+/**
+ * tcp/udp over ipv4 and ipv6 frames, some of them vlan tagged
+ */
+static std::vector<std::vector<uint8_t>> make_frames(size_t count) {
+  std::mt19937 gen(3);
+  std::vector<std::vector<uint8_t>> frames(count);
+  for (auto &frame : frames) {
+    frame.assign(12, 0);
+    if (gen() % 4 == 0) {
+      frame.insert(frame.end(), {0x81, 0x00, 0x00, static_cast<uint8_t>(gen() % 4096)});
+    }
+    bool const v6 = gen() % 2;
+    uint8_t const protocol = (gen() % 2) ? 6 : 17;
+    if (v6) {
+      frame.insert(frame.end(), {0x86, 0xdd, 0x60, 0, 0, 0, 0, 28, protocol, 64});
+      for (size_t i = 0; i < 32; ++i)
+        frame.push_back(static_cast<uint8_t>(gen()));
+    } else {
+      frame.insert(frame.end(), {0x08, 0x00, 0x45, 0, 0, 48, 0, 0, 0x40, 0, 64, protocol, 0, 0});
+      for (size_t i = 0; i < 8; ++i)
+        frame.push_back(static_cast<uint8_t>(gen()));
+    }
+    for (size_t i = 0; i < 28; ++i)
+      frame.push_back(static_cast<uint8_t>(gen()));
+  }
+  return frames;
+}
+
+static void classify_burst(benchmark::State &state) {
+  size_t const burst = static_cast<size_t>(state.range(0));
+  auto const frames = make_frames(4096);
+  std::vector<packet> packets;
+  for (auto const &frame : frames)
+    packets.push_back({frame.data(), frame.size()});
+  flow_keys keys(burst);
+  for (auto _ : state) {
+    for (size_t i = 0; i < packets.size(); i += burst)
+      benchmark::DoNotOptimize(bro::net::proto::ip::classify(packets.data() + i, burst, keys));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * packets.size()));
+}
+BENCHMARK(classify_burst)->Arg(1)->Arg(32)->Arg(64);
+
+} // namespace bro::protocols::bench
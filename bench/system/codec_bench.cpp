@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <benchmark/benchmark.h>
+#include <protocols/ip/codec.h>
+
+#include <random>
+#include <vector>
+
+namespace bro::protocols::bench {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::address_column;
+using bro::net::proto::ip::codec;
+
+/**
+ * hosts of 256 /64 networks and of ipv4 /16
+ *
+ * @param v4_percent share of ipv4 addresses
+ */
+static std::vector<address> make_addresses(int64_t v4_percent) {
+  std::mt19937_64 gen(1);
+  std::vector<address> addrs(1 << 16);
+  for (auto &addr : addrs) {
+    if (int64_t(gen() % 100) < v4_percent) {
+      addr = address(bro::net::proto::ip::v4::address(__builtin_bswap32(0x0a000000U | static_cast<uint32_t>(gen() % 65536))));
+    } else {
+      uint64_t const net = 0x20010db800000000ULL | (gen() % 256);
+      addr = address(bro::net::proto::ip::v6::address(__builtin_bswap64(net), __builtin_bswap64(gen() % 65536)));
+    }
+  }
+  return addrs;
+}
+
+static void codec_encode(benchmark::State &state) {
+  auto const addrs = make_addresses(state.range(0));
+  std::vector<uint8_t> data;
+  for (auto _ : state) {
+    bro::net::proto::ip::encode_addresses(addrs.data(), addrs.size(), data);
+    benchmark::DoNotOptimize(data.data());
+  }
+  state.counters["ratio"] = double(addrs.size() * sizeof(address)) / double(data.size());
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * addrs.size()));
+}
+
+static void codec_decode(benchmark::State &state) {
+  auto const addrs = make_addresses(state.range(0));
+  std::vector<uint8_t> data;
+  bro::net::proto::ip::encode_addresses(addrs.data(), addrs.size(), data);
+  address_column column;
+  column.open(data.data(), data.size());
+  std::vector<address> decoded(addrs.size());
+  for (auto _ : state) {
+    column.decode(decoded.data());
+    benchmark::DoNotOptimize(decoded.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * addrs.size()));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * addrs.size() * sizeof(address)));
+}
+
+static void codec_get(benchmark::State &state) {
+  auto const addrs = make_addresses(state.range(0));
+  std::vector<uint8_t> data;
+  bro::net::proto::ip::encode_addresses(addrs.data(), addrs.size(), data);
+  address_column column;
+  column.open(data.data(), data.size());
+  std::mt19937 gen(2);
+  std::vector<size_t> indexes(4096);
+  for (auto &index : indexes)
+    index = gen() % addrs.size();
+  for (auto _ : state) {
+    for (auto index : indexes)
+      benchmark::DoNotOptimize(column.get(index));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * indexes.size()));
+}
+
+BENCHMARK(codec_encode)->Arg(0)->Arg(30)->Arg(100);
+BENCHMARK(codec_decode)->Arg(0)->Arg(30)->Arg(100);
+BENCHMARK(codec_get)->Arg(0)->Arg(30)->Arg(100);
+
+} // namespace bro::protocols::bench
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <benchmark/benchmark.h>
+#include <protocols/ip/proxy_protocol.h>
+
+namespace bro::protocols::bench {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::full_address;
+namespace proxy = bro::net::proto::ip::proxy;
+
+static proxy::header make_header(char const *source, char const *destination) {
+  proxy::header hdr;
+  hdr._source = full_address(address(source), 56324);
+  hdr._destination = full_address(address(destination), 443);
+  return hdr;
+}
+
+static void proxy_parse(benchmark::State &state, uint8_t const *data, size_t size) {
+  proxy::header hdr;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(proxy::parse(data, size, hdr));
+    benchmark::DoNotOptimize(hdr);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+
+static void proxy_v1_parse(benchmark::State &state, char const *source, char const *destination) {
+  uint8_t buffer[proxy::e_v1_max_size];
+  size_t const size = proxy::serialize_v1(make_header(source, destination), buffer, sizeof(buffer));
+  proxy_parse(state, buffer, size);
+}
+
+static void proxy_v2_parse(benchmark::State &state, char const *source, char const *destination) {
+  uint8_t const alpn[] = {'h', '2'};
+  proxy::tlv const tlvs[] = {{proxy::e_alpn, sizeof(alpn), alpn}};
+  uint8_t buffer[128];
+  size_t const size = proxy::serialize_v2(make_header(source, destination), tlvs, 1, buffer, sizeof(buffer));
+  proxy_parse(state, buffer, size);
+}
+
+static void proxy_v1_serialize(benchmark::State &state, char const *source, char const *destination) {
+  auto const hdr = make_header(source, destination);
+  uint8_t buffer[proxy::e_v1_max_size];
+  for (auto _ : state)
+    benchmark::DoNotOptimize(proxy::serialize_v1(hdr, buffer, sizeof(buffer)));
+}
+
+static void proxy_v2_serialize(benchmark::State &state, char const *source, char const *destination) {
+  auto const hdr = make_header(source, destination);
+  uint8_t buffer[128];
+  for (auto _ : state)
+    benchmark::DoNotOptimize(proxy::serialize_v2(hdr, nullptr, 0, buffer, sizeof(buffer)));
+}
+
+BENCHMARK_CAPTURE(proxy_v1_parse, tcp4, "192.168.100.1", "10.0.0.254");
+BENCHMARK_CAPTURE(proxy_v1_parse, tcp6, "2001:db8:85a3::8a2e:370:7334", "2001:db8::1");
+BENCHMARK_CAPTURE(proxy_v2_parse, tcp4, "192.168.100.1", "10.0.0.254");
+BENCHMARK_CAPTURE(proxy_v2_parse, tcp6, "2001:db8:85a3::8a2e:370:7334", "2001:db8::1");
+BENCHMARK_CAPTURE(proxy_v1_serialize, tcp4, "192.168.100.1", "10.0.0.254");
+BENCHMARK_CAPTURE(proxy_v1_serialize, tcp6, "2001:db8:85a3::8a2e:370:7334", "2001:db8::1");
+BENCHMARK_CAPTURE(proxy_v2_serialize, tcp4, "192.168.100.1", "10.0.0.254");
+BENCHMARK_CAPTURE(proxy_v2_serialize, tcp6, "2001:db8:85a3::8a2e:370:7334", "2001:db8::1");
+
+} // namespace bro::protocols::bench
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <benchmark/benchmark.h>
+#include <protocols/ip/range_map.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace bro::protocols::bench {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::range_entry;
+using bro::net::proto::ip::range_map;
+
+/**
+ * disjoint ipv4 ranges covering half of address space
+ */
+static std::vector<range_entry<uint32_t>> make_ranges(size_t count) {
+  std::mt19937 gen(1);
+  std::vector<uint32_t> bounds(count * 2);
+  for (auto &bound : bounds)
+    bound = static_cast<uint32_t>(gen());
+  std::sort(bounds.begin(), bounds.end());
+  std::vector<range_entry<uint32_t>> ranges;
+  for (size_t i = 0; i < count; ++i) {
+    ranges.push_back({address(bro::net::proto::ip::to_v4_address(bounds[2 * i])),
+                      address(bro::net::proto::ip::to_v4_address(bounds[2 * i + 1])), static_cast<uint32_t>(i)});
+  }
+  return ranges;
+}
+
+static std::vector<address> make_addresses() {
+  std::mt19937 gen(2);
+  std::vector<address> addrs(4096);
+  for (auto &addr : addrs)
+    addr = address(bro::net::proto::ip::to_v4_address(static_cast<uint32_t>(gen())));
+  return addrs;
+}
+
+static void range_map_sorted(benchmark::State &state) {
+  auto const ranges = make_ranges(static_cast<size_t>(state.range(0)));
+  std::vector<uint32_t> firsts, lasts;
+  for (auto const &range : ranges) {
+    firsts.push_back(bro::net::proto::ip::to_number(range._first.to_v4()));
+    lasts.push_back(bro::net::proto::ip::to_number(range._last.to_v4()));
+  }
+  auto const addrs = make_addresses();
+  for (auto _ : state) {
+    for (auto const &addr : addrs) {
+      uint32_t const key = bro::net::proto::ip::to_number(addr.to_v4());
+      auto const it = std::upper_bound(firsts.begin(), firsts.end(), key);
+      bool const found = it != firsts.begin() && key <= lasts[static_cast<size_t>(it - firsts.begin()) - 1];
+      benchmark::DoNotOptimize(found);
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * addrs.size()));
+}
+
+static void range_map_find(benchmark::State &state) {
+  range_map<uint32_t> const map(make_ranges(static_cast<size_t>(state.range(0))));
+  auto const addrs = make_addresses();
+  for (auto _ : state) {
+    for (auto const &addr : addrs)
+      benchmark::DoNotOptimize(map.find(addr));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * addrs.size()));
+}
+
+BENCHMARK(range_map_sorted)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(range_map_find)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+} // namespace bro::protocols::bench
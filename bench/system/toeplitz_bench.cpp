@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <benchmark/benchmark.h>
+#include <protocols/ip/numeric.h>
+#include <protocols/ip/toeplitz.h>
+
+#include <random>
+#include <vector>
+
+namespace bro::protocols::bench {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::full_address;
+using bro::net::proto::ip::rss_hash;
+using bro::net::proto::ip::toeplitz;
+
+/**
+ * random endpoints (state.range(0) is 4 for ipv4, 6 for ipv6)
+ */
+static std::vector<full_address> make_endpoints(int64_t version, uint32_t seed) {
+  std::mt19937_64 gen(seed);
+  std::vector<full_address> endpoints;
+  for (size_t i = 0; i < 1024; ++i) {
+    auto const port = static_cast<uint16_t>(gen());
+    if (version == 4)
+      endpoints.emplace_back(address(bro::net::proto::ip::to_v4_address(static_cast<uint32_t>(gen()))), port);
+    else
+      endpoints.emplace_back(address(bro::net::proto::ip::v6::address(gen(), gen())), port);
+  }
+  return endpoints;
+}
+
+static void toeplitz_bitwise(benchmark::State &state) {
+  auto const sources = make_endpoints(state.range(0), 1);
+  auto const destinations = make_endpoints(state.range(0), 2);
+  for (auto _ : state) {
+    for (size_t i = 0; i < sources.size(); ++i)
+      benchmark::DoNotOptimize(rss_hash(sources[i], destinations[i]));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * sources.size()));
+}
+
+static void toeplitz_table(benchmark::State &state) {
+  toeplitz const hasher;
+  auto const sources = make_endpoints(state.range(0), 1);
+  auto const destinations = make_endpoints(state.range(0), 2);
+  for (auto _ : state) {
+    for (size_t i = 0; i < sources.size(); ++i)
+      benchmark::DoNotOptimize(hasher.hash(sources[i], destinations[i]));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * sources.size()));
+}
+
+static void toeplitz_burst(benchmark::State &state) {
+  toeplitz const hasher;
+  auto const sources = make_endpoints(state.range(0), 1);
+  auto const destinations = make_endpoints(state.range(0), 2);
+  std::vector<uint32_t> res(sources.size());
+  for (auto _ : state) {
+    hasher.hash(sources.data(), destinations.data(), sources.size(), res.data());
+    benchmark::DoNotOptimize(res.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * sources.size()));
+}
+
+BENCHMARK(toeplitz_bitwise)->Arg(4)->Arg(6);
+BENCHMARK(toeplitz_table)->Arg(4)->Arg(6);
+BENCHMARK(toeplitz_burst)->Arg(4)->Arg(6);
+
+} // namespace bro::protocols::bench
@@ -0,0 +1,20 @@
+cmake_minimum_required(VERSION 3.14.0)
+
+find_package(benchmark QUIET)
+if (benchmark_FOUND)
+    return()
+endif()
+
+message(STATUS "couldn't find google benchmark in system. will download it")
+
+include(FetchContent)
+FetchContent_Declare(
+  benchmark
+  GIT_REPOSITORY https://github.com/google/benchmark.git
+  GIT_TAG        v1.8.3
+)
+
+set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "" FORCE)
+
+FetchContent_MakeAvailable(benchmark)
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include "fuzz.h"
+
+#include <protocols/ip/endpoint.h>
+#include <protocols/ip/format.h>
+
+#include <arpa/inet.h>
+#include <cstring>
+#include <string>
+
+using namespace bro::net::proto::ip;
+
+/**
+ * address parsers must accept the same strings as inet_pton and produce
+ * the same bytes, formatted address must be the same as inet_ntop output
+ */
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const *data, size_t size) {
+  std::string const str(reinterpret_cast<char const *>(data), size);
+  bool const has_nul = str.find('\0') != std::string::npos;
+  bool const is_v6 = str.find(':') != std::string::npos;
+
+  address addr;
+  bool const parsed = static_cast<bool>(parse_address(str, addr));
+  uint8_t expected[v6::address::e_bytes_size];
+  // inet_pton sees only the part before nul, parse_address rejects nul
+  bool const reference = !has_nul && inet_pton(is_v6 ? AF_INET6 : AF_INET, str.c_str(), expected) == 1;
+  FUZZ_CHECK(parsed == reference);
+
+  // string_to_address wrappers must stay drop-in replacements of inet_pton
+  uint8_t libc_data[v6::address::e_bytes_size];
+  uint32_t v4_data = 0;
+  bool const v4_reference = inet_pton(AF_INET, str.c_str(), libc_data) == 1;
+  FUZZ_CHECK(v4::string_to_address(str, v4_data) == v4_reference);
+  FUZZ_CHECK(!v4_reference || !memcmp(&v4_data, libc_data, v4::address::e_bytes_size));
+  uint8_t v6_data[v6::address::e_bytes_size];
+  bool const v6_reference = inet_pton(AF_INET6, str.c_str(), libc_data) == 1;
+  FUZZ_CHECK(v6::string_to_address(str, v6_data) == v6_reference);
+  FUZZ_CHECK(!v6_reference || !memcmp(v6_data, libc_data, v6::address::e_bytes_size));
+  if (!parsed)
+    return 0;
+
+  char buffer[e_max_v6_string];
+  char reference_buffer[INET6_ADDRSTRLEN];
+  if (is_v6) {
+    FUZZ_CHECK(addr.get_version() == address::version::e_v6);
+    FUZZ_CHECK(!memcmp(addr.to_v6().get_data(), expected, v6::address::e_bytes_size));
+    inet_ntop(AF_INET6, expected, reference_buffer, sizeof(reference_buffer));
+  } else {
+    FUZZ_CHECK(addr.get_version() == address::version::e_v4);
+    uint32_t const dword = addr.to_v4().get_data();
+    FUZZ_CHECK(!memcmp(&dword, expected, v4::address::e_bytes_size));
+    inet_ntop(AF_INET, expected, reference_buffer, sizeof(reference_buffer));
+  }
+  std::string_view const formatted(buffer, static_cast<size_t>(format_to(buffer, addr) - buffer));
+  FUZZ_CHECK(formatted == reference_buffer);
+
+  address round_trip;
+  FUZZ_CHECK(parse_address(formatted, round_trip) && round_trip == addr);
+  return 0;
+}
@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include "fuzz.h"
+
+#include <protocols/ip/classify.h>
+
+using namespace bro::net::proto::ip;
+
+/**
+ * classification stays inside frame and fills fields according to status
+ */
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const *data, size_t size) {
+  static flow_keys keys(1);
+  packet const pkt{data, size};
+  size_t const classified = classify(&pkt, 1, keys);
+  FUZZ_CHECK(keys._size == 1);
+  FUZZ_CHECK(classified == (keys._statuses[0] == packet_status::e_ok));
+  FUZZ_CHECK(keys._l3_offsets[0] <= size && keys._l4_offsets[0] <= size);
+  FUZZ_CHECK(!keys._l4_offsets[0] || keys._l4_offsets[0] > keys._l3_offsets[0]);
+
+  switch (keys._statuses[0]) {
+  case packet_status::e_ok:
+  case packet_status::e_fragment:
+    FUZZ_CHECK(keys._l3_offsets[0] && keys._sources[0].get_version() == keys._destinations[0].get_version());
+    break;
+  case packet_status::e_not_ip:
+  case packet_status::e_invalid:
+    FUZZ_CHECK(!keys._l3_offsets[0] && keys._sources[0] == address());
+    break;
+  default:
+    break;
+  }
+  if (keys._statuses[0] == packet_status::e_fragment)
+    FUZZ_CHECK(!keys._source_ports[0] && !keys._destination_ports[0]);
+  return 0;
+}
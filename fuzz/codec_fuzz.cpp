@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include "fuzz.h"
+
+#include <protocols/ip/codec.h>
+
+#include <vector>
+
+using namespace bro::net::proto::ip;
+
+/**
+ * accepted column decodes without out of bounds reads and survives re-encoding
+ */
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const *data, size_t size) {
+  address_column column;
+  if (!column.open(data, size))
+    return 0;
+
+  std::vector<address> addrs(column.get_block_count() * codec::e_block_size);
+  column.decode(addrs.data());
+  addrs.resize(column.size());
+  for (size_t i = 0; i < addrs.size(); ++i)
+    FUZZ_CHECK(column.get(i) == addrs[i]);
+
+  std::vector<uint8_t> encoded;
+  FUZZ_CHECK(encode_addresses(addrs.data(), addrs.size(), encoded));
+  address_column round_trip;
+  FUZZ_CHECK(round_trip.open(encoded.data(), encoded.size()));
+  std::vector<address> decoded(round_trip.get_block_count() * codec::e_block_size);
+  round_trip.decode(decoded.data());
+  decoded.resize(round_trip.size());
+  FUZZ_CHECK(decoded == addrs);
+  return 0;
+}
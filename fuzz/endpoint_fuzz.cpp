@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include "fuzz.h"
+
+#include <protocols/ip/endpoint.h>
+
+#include <string_view>
+
+using namespace bro::net::proto::ip;
+
+/**
+ * parsed endpoint must be written and parsed back unchanged, error position
+ * must stay inside input
+ */
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const *data, size_t size) {
+  std::string_view const str(reinterpret_cast<char const *>(data), size);
+  full_address addr;
+  endpoint_result const result = parse_endpoint(str, addr);
+  FUZZ_CHECK(result._position <= size);
+  if (!result)
+    return 0;
+
+  char buffer[e_max_endpoint_string];
+  std::string_view const written(buffer, static_cast<size_t>(endpoint_to_chars(buffer, addr) - buffer));
+  full_address round_trip;
+  FUZZ_CHECK(parse_endpoint(written, round_trip));
+  FUZZ_CHECK(round_trip == addr);
+  FUZZ_CHECK(round_trip.get_scope_id() == addr.get_scope_id());
+  return 0;
+}
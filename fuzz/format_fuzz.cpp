@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include "fuzz.h"
+
+#include <protocols/ip/endpoint.h>
+#include <protocols/ip/format.h>
+
+#include <arpa/inet.h>
+#include <cstring>
+#include <string_view>
+
+using namespace bro::net::proto::ip;
+
+/**
+ * formatted addresses must be the same as inet_ntop/inet_ntoa output and
+ * every format option must parse back to the same address
+ */
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const *data, size_t size) {
+  char buffer[e_max_v6_string];
+  char reference[INET6_ADDRSTRLEN];
+
+  if (size >= v6::address::e_bytes_size) {
+    uint8_t bytes[v6::address::e_bytes_size];
+    memcpy(bytes, data, sizeof(bytes));
+    v6::address const addr(bytes);
+    inet_ntop(AF_INET6, bytes, reference, sizeof(reference));
+    FUZZ_CHECK(std::string_view(buffer, static_cast<size_t>(format_to(buffer, addr) - buffer)) == reference);
+
+    address parsed;
+    std::string_view const expanded(buffer, static_cast<size_t>(format_to(buffer, addr, {true}) - buffer));
+    FUZZ_CHECK(expanded.size() == 39 && parse_address(expanded, parsed) && parsed == address(addr));
+    std::string_view const reversed(buffer,
+                                    static_cast<size_t>(format_to(buffer, addr, {false, false, true}) - buffer));
+    FUZZ_CHECK(parse_address(reversed, parsed) && parsed == address(addr.reverse_order()));
+    std::string_view const bracketed(buffer,
+                                     static_cast<size_t>(format_to(buffer, addr, {false, true}) - buffer));
+    FUZZ_CHECK(bracketed.front() == '[' && bracketed.back() == ']');
+    FUZZ_CHECK(parse_address(bracketed.substr(1, bracketed.size() - 2), parsed) && parsed == address(addr));
+  }
+
+  if (size >= v4::address::e_bytes_size) {
+    uint32_t dword;
+    memcpy(&dword, data, sizeof(dword));
+    v4::address const addr(dword);
+    std::string_view const formatted(buffer, static_cast<size_t>(format_to(buffer, addr) - buffer));
+    inet_ntop(AF_INET, &dword, reference, sizeof(reference));
+    FUZZ_CHECK(formatted == reference);
+    in_addr native;
+    native.s_addr = dword;
+    FUZZ_CHECK(formatted == inet_ntoa(native));
+
+    std::string_view const padded(buffer,
+                                  static_cast<size_t>(format_to(buffer, addr, {false, false, false, true}) - buffer));
+    FUZZ_CHECK(padded.size() == e_max_v4_string);
+    std::string_view const reversed(buffer,
+                                    static_cast<size_t>(format_to(buffer, addr, {false, false, true}) - buffer));
+    address parsed;
+    FUZZ_CHECK(parse_address(reversed, parsed) && parsed == address(addr.reverse_order()));
+  }
+  return 0;
+}
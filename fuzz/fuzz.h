@@ -0,0 +1,15 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * abort fuzz target if condition doesn't hold (reported by libFuzzer as crash)
+ */
+#define FUZZ_CHECK(cond)                                                                                               \
+  do {                                                                                                                 \
+    if (!(cond)) {                                                                                                     \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);                                       \
+      abort();                                                                                                         \
+    }                                                                                                                  \
+  } while (false)
@@ -0,0 +1,25 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include "fuzz.h"
+
+#include <protocols/ip/prefix.h>
+
+#include <string>
+
+using namespace bro::net::proto::ip;
+
+/**
+ * parsed prefix has zero host bits and survives string round trip
+ */
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const *data, size_t size) {
+  std::string const str(reinterpret_cast<char const *>(data), size);
+  prefix pref;
+  if (!string_to_prefix(str, pref))
+    return 0;
+
+  FUZZ_CHECK(pref.get_length() <= max_prefix_length(pref.get_version()));
+  FUZZ_CHECK((pref.get_address() & make_mask(pref.get_version(), pref.get_length())) == pref.get_address());
+  prefix round_trip;
+  FUZZ_CHECK(string_to_prefix(pref.to_string(), round_trip));
+  FUZZ_CHECK(round_trip == pref);
+  return 0;
+}
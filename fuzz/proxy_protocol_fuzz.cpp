@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include "fuzz.h"
+
+#include <protocols/ip/proxy_protocol.h>
+
+#include <vector>
+
+using namespace bro::net::proto::ip;
+
+/**
+ * parsed header stays inside input, its tlvs are iterable and it survives
+ * serialize/parse round trip
+ */
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const *data, size_t size) {
+  proxy::header hdr;
+  if (proxy::parse(data, size, hdr) != proxy::status::e_ok)
+    return 0;
+  FUZZ_CHECK(hdr._size <= size);
+  FUZZ_CHECK(!hdr._tlvs_size || (hdr._tlvs >= data && hdr._tlvs + hdr._tlvs_size <= data + hdr._size));
+
+  std::vector<proxy::tlv> tlvs;
+  size_t offset = 0;
+  for (proxy::tlv value; proxy::next_tlv(hdr, offset, value);) {
+    FUZZ_CHECK(value._value >= hdr._tlvs && value._value + value._length <= hdr._tlvs + hdr._tlvs_size);
+    tlvs.push_back(value);
+  }
+  FUZZ_CHECK(offset == hdr._tlvs_size);
+
+  std::vector<uint8_t> buffer(hdr._version == 1 ? size_t(proxy::e_v1_max_size) : hdr._size);
+  size_t const written = hdr._version == 1
+                           ? proxy::serialize_v1(hdr, buffer.data(), buffer.size())
+                           : proxy::serialize_v2(hdr, tlvs.data(), tlvs.size(), buffer.data(), buffer.size());
+  FUZZ_CHECK(written);
+  proxy::header round_trip;
+  FUZZ_CHECK(proxy::parse(buffer.data(), written, round_trip) == proxy::status::e_ok);
+  FUZZ_CHECK(round_trip._size == written);
+  FUZZ_CHECK(round_trip._command == hdr._command);
+  if (hdr._command == proxy::command::e_proxy) {
+    FUZZ_CHECK(round_trip._source == hdr._source);
+    FUZZ_CHECK(round_trip._destination == hdr._destination);
+  }
+  return 0;
+}
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include "fuzz.h"
+
+#include <protocols/ip/resolver.h>
+
+#include <algorithm>
+#include <string_view>
+
+using namespace bro::net::proto::ip;
+
+/**
+ * hosts and resolv.conf parsers must skip garbage without crashing, hosts
+ * names must map to non-empty lists of unique addresses and reparsing the
+ * same content must not add names, every name server must have a port
+ */
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const *data, size_t size) {
+  std::string_view const content(reinterpret_cast<char const *>(data), size);
+
+  hosts_table hosts;
+  hosts.parse(content);
+  size_t const names = hosts.size();
+  hosts.parse(content);
+  FUZZ_CHECK(hosts.size() == names);
+
+  size_t words = 0;
+  for (size_t pos = content.find_first_not_of(" \t\r\n"); pos != std::string_view::npos;
+       pos = content.find_first_not_of(" \t\r\n", pos)) {
+    size_t const end = std::min(content.find_first_of(" \t\r\n", pos), content.size());
+    ++words;
+    if (auto const *addrs = hosts.find(content.substr(pos, end - pos))) {
+      FUZZ_CHECK(!addrs->empty());
+      for (auto it = addrs->begin(); it != addrs->end(); ++it)
+        FUZZ_CHECK(std::find(std::next(it), addrs->end(), *it) == addrs->end());
+    }
+    pos = end;
+  }
+  FUZZ_CHECK(names <= words);
+
+  std::vector<full_address> servers(1);
+  parse_resolv_conf(content, servers);
+  FUZZ_CHECK(servers.front() == full_address());
+  size_t lines = 0;
+  for (size_t pos = content.find("nameserver"); pos != std::string_view::npos; pos = content.find("nameserver", pos + 1))
+    ++lines;
+  FUZZ_CHECK(servers.size() <= lines + 1);
+  for (size_t i = 1; i < servers.size(); ++i)
+    FUZZ_CHECK(servers[i].get_port());
+  return 0;
+}
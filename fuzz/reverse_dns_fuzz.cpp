@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include "fuzz.h"
+
+#include <protocols/ip/reverse_dns.h>
+
+#include <string_view>
+
+using namespace bro::net::proto::ip;
+
+/**
+ * parsed reverse dns name must be written and parsed back unchanged
+ */
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const *data, size_t size) {
+  std::string_view const name(reinterpret_cast<char const *>(data), size);
+  address addr;
+  if (!from_ptr_name(name, addr))
+    return 0;
+
+  char buffer[e_max_ptr_name];
+  std::string_view const written(buffer, static_cast<size_t>(to_ptr_name(buffer, addr) - buffer));
+  FUZZ_CHECK(written.size() <= e_max_ptr_name);
+  address round_trip;
+  FUZZ_CHECK(from_ptr_name(written, round_trip));
+  FUZZ_CHECK(round_trip == addr);
+  return 0;
+}
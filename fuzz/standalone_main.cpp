@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const *data, size_t size);
+
+/**
+ * replay corpus files for compilers without libFuzzer
+ *
+ * arguments are files or directories, options ("-runs=...") are ignored
+ */
+int main(int argc, char **argv) {
+  size_t runs = 0;
+  auto const run = [&runs](std::filesystem::path const &path) {
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> const data{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    LLVMFuzzerTestOneInput(data.data(), data.size());
+    ++runs;
+  };
+
+  for (int i = 1; i < argc; ++i) {
+    if (argv[i][0] == '-')
+      continue;
+    std::filesystem::path const path(argv[i]);
+    if (std::filesystem::is_directory(path)) {
+      for (auto const &entry : std::filesystem::recursive_directory_iterator(path)) {
+        if (entry.is_regular_file())
+          run(entry.path());
+      }
+    } else {
+      run(path);
+    }
+  }
+  printf("executed %zu inputs\n", runs);
+  return 0;
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "prefix.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * \brief compiled list of prefixes for first match lookups
+ *
+ * intended for small lists (up to a few dozen prefixes). ipv4 and ipv6
+ * prefixes are packed separately into arrays of masks and values, so one
+ * address is tested against 8 ipv4 or 4 ipv6 prefixes by a single AVX2
+ * compare (scalar loop if AVX2 is not enabled).
+ */
+class acl {
+public:
+  static constexpr uint32_t e_no_match = UINT32_MAX; ///< index for addresses without match
+
+  /**
+   * default constructor (nothing matches)
+   */
+  acl() = default;
+
+  /**
+   * ctor from prefixes
+   *
+   * @param prefixes prefixes in priority order (unset prefixes never match)
+   */
+  explicit acl(std::vector<prefix> const &prefixes);
+
+  /**
+   * get number of prefixes
+   */
+  size_t size() const noexcept {
+    return _size;
+  }
+
+  /**
+   * find first prefix containing address
+   *
+   * @return prefix index or e_no_match
+   */
+  uint32_t match(address const &addr) const noexcept;
+
+  /**
+   * find first prefix containing ipv4 address
+   *
+   * @return prefix index or e_no_match
+   */
+  uint32_t match(v4::address const &addr) const noexcept;
+
+  /**
+   * find first prefix containing ipv6 address
+   *
+   * @return prefix index or e_no_match
+   */
+  uint32_t match(v6::address const &addr) const noexcept;
+
+  /**
+   * find first matching prefixes for batch of addresses
+   *
+   * @param addrs addresses
+   * @param size number of addresses
+   * @param indices prefix indexes or e_no_match (size elements)
+   */
+  void match(address const *addrs, size_t size, uint32_t *indices) const noexcept;
+
+  /**
+   * find first matching prefixes for batch of ipv4 addresses
+   */
+  void match(v4::address const *addrs, size_t size, uint32_t *indices) const noexcept;
+
+  /**
+   * find first matching prefixes for batch of ipv6 addresses
+   */
+  void match(v6::address const *addrs, size_t size, uint32_t *indices) const noexcept;
+
+private:
+  enum {
+    e_v4_lanes = 8, ///< ipv4 prefixes per register
+    e_v6_lanes = 4  ///< ipv6 prefixes per register
+  };
+
+  std::vector<uint32_t> _v4_masks;   ///< ipv4 masks (network order, padded to e_v4_lanes)
+  std::vector<uint32_t> _v4_values;  ///< ipv4 prefix addresses
+  std::vector<uint32_t> _v4_indices; ///< ipv4 prefix indexes
+  std::vector<uint64_t> _v6_masks[2];  ///< ipv6 masks qwords (padded to e_v6_lanes)
+  std::vector<uint64_t> _v6_values[2]; ///< ipv6 prefix addresses qwords
+  std::vector<uint32_t> _v6_indices;   ///< ipv6 prefix indexes
+  size_t _size = 0;                    ///< number of prefixes
+};
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
@@ -1,4 +1,7 @@
 #pragma once
+#include <cstring>
+#include <type_traits>
+
 #include "v4.h"
 #include "v6.h"
 #ifdef __linux__
@@ -12,6 +15,10 @@ namespace bro::net::proto::ip {
 
 /**
  * \brief ip v4/v6 address wrapper
+ *
+ * thin runtime tagged variant over family cores: storage is ipv6 address,
+ * ipv4 address takes its first 4 bytes and the rest is zero. code which
+ * knows family statically takes it by get<family>() and skips dispatch.
  */
 class address {
 public:
@@ -41,56 +48,56 @@ public:
    * ctor from ipv4 native linux
    */
   address(in_addr const &addr) noexcept
-    : _dword{addr.s_addr, 0, 0, 0}
-    , _version(version::e_v4) {}
+    : address(ip::v4::address(addr)) {}
 
   /**
    * ctor from ipv6 native linux
    */
-  address(in6_addr const &addr) noexcept;
+  address(in6_addr const &addr) noexcept
+    : _storage(addr)
+    , _version(version::e_v6) {}
 #endif
 
   /**
    * ctor from ipv4
    */
   address(ip::v4::address const &addr) noexcept
-    : _dword{addr.get_data(), 0, 0, 0}
+    : _storage(addr.get_data(), 0, 0, 0)
     , _version(version::e_v4) {}
 
   /**
    * ctor from ipv6
    */
-  address(ip::v6::address const &addr) noexcept;
+  address(ip::v6::address const &addr) noexcept
+    : _storage(addr)
+    , _version(version::e_v6) {}
 
   /**
    * ctor from address
    */
-  address(address const &addr) noexcept
-    : _qword{addr._qword[0], addr._qword[1]}
-    , _version{addr._version} {}
+  address(address const &addr) noexcept = default;
 
 #ifdef __linux__
   /**
    * assign operator from ipv4 native linux
    */
   address &operator=(in_addr const &addr) noexcept {
-    _dword[0] = addr.s_addr;
-    _version = (version::e_v4);
-    return *this;
+    return *this = ip::v4::address(addr);
   }
 
   /**
    * assign operator from ipv6 native linux
    */
-  address &operator=(in6_addr const &addr) noexcept;
+  address &operator=(in6_addr const &addr) noexcept {
+    return *this = ip::v6::address(addr);
+  }
 #endif
 
   /**
    * assign operator from ipv4
    */
   address &operator=(ip::v4::address const &addr) noexcept {
-    _dword[0] = addr.get_data();
-    _dword[1] = _dword[2] = _dword[3] = 0;
+    _storage = ip::v6::address(addr.get_data(), 0, 0, 0);
     _version = version::e_v4;
     return *this;
   }
@@ -98,25 +105,29 @@ public:
   /**
    * assign operator from ipv6
    */
-  address &operator=(ip::v6::address const &addr) noexcept;
+  address &operator=(ip::v6::address const &addr) noexcept {
+    _storage = addr;
+    _version = version::e_v6;
+    return *this;
+  }
 
   /**
    * assign operator from ip_addr
    */
-  address &operator=(address const &addr) noexcept;
+  address &operator=(address const &addr) noexcept = default;
 
   /**
    * operator less
    */
   bool operator<(address const &addr) const noexcept {
-    return _qword[0] < addr._qword[0] || (!(addr._qword[0] < _qword[0]) && _qword[1] < addr._qword[1]);
+    return _storage < addr._storage;
   }
 
   /**
    * operator equal
    */
   bool operator==(address const &addr) const noexcept {
-    return _version == addr._version && _qword[0] == addr._qword[0] && _qword[1] == addr._qword[1];
+    return _version == addr._version && _storage == addr._storage;
   }
 
   /**
@@ -135,14 +146,47 @@ public:
    * create ipv4 address from current address
    */
   ip::v4::address to_v4() const noexcept {
-    return ip::v4::address(_dword[0]);
+    uint32_t dword;
+    memcpy(&dword, _storage.get_data(), sizeof(dword));
+    return ip::v4::address(dword);
   }
 
   /**
    * create ipv6 address from current address
    */
   ip::v6::address to_v6() const noexcept {
-    return ip::v6::address(_qword[0], _qword[1]);
+    return _storage;
+  }
+
+  /**
+   * get address of statically known family
+   *
+   * \note family isn't checked, as for to_v4() and to_v6()
+   */
+  template <family F> typename family_traits<F>::address_type get() const noexcept {
+    if constexpr (F == family::e_v4)
+      return to_v4();
+    else
+      return to_v6();
+  }
+
+  /**
+   * call visitor with address of current family
+   *
+   * @param visitor callable with v4::address and v6::address
+   * @return visitor result (value initialized for unset address)
+   */
+  template <typename Visitor> auto visit(Visitor &&visitor) const {
+    using result = std::common_type_t<decltype(visitor(to_v4())), decltype(visitor(to_v6()))>;
+    switch (_version) {
+    case version::e_v4:
+      return result(visitor(to_v4()));
+    case version::e_v6:
+      return result(visitor(to_v6()));
+    default:
+      break;
+    }
+    return result();
   }
 
 #ifdef __linux__
@@ -152,7 +196,7 @@ public:
    * \note we don't check here that current address is ipv4
    */
   in_addr to_native_v4() const noexcept {
-    return {_dword[0]};
+    return to_v4().to_native();
   }
 
   /**
@@ -160,7 +204,9 @@ public:
    *
    * \note we don't check here that current address is ipv6
    */
-  in6_addr to_native_v6() const noexcept;
+  in6_addr to_native_v6() const noexcept {
+    return _storage.to_native();
+  }
 #endif
 
   /**
@@ -188,7 +234,7 @@ public:
    * get address as uint8_t *
    */
   uint8_t const *get_data() const noexcept {
-    return _bytes;
+    return _storage.get_data();
   }
 
   /**
@@ -206,29 +252,7 @@ public:
   }
 
 private:
-  union {
-    struct {
-      uint8_t _byte1;  ///< byte 1
-      uint8_t _byte2;  ///< byte 2
-      uint8_t _byte3;  ///< byte 3
-      uint8_t _byte4;  ///< byte 4
-      uint8_t _byte5;  ///< byte 5
-      uint8_t _byte6;  ///< byte 6
-      uint8_t _byte7;  ///< byte 7
-      uint8_t _byte8;  ///< byte 8
-      uint8_t _byte9;  ///< byte 9
-      uint8_t _byte10; ///< byte 10
-      uint8_t _byte11; ///< byte 11
-      uint8_t _byte12; ///< byte 12
-      uint8_t _byte13; ///< byte 13
-      uint8_t _byte14; ///< byte 14
-      uint8_t _byte15; ///< byte 15
-      uint8_t _byte16; ///< byte 16
-    };
-    uint64_t _qword[ip::v6::address::e_qword_size]; ///< uint64_t array
-    uint32_t _dword[ip::v6::address::e_dword_size]; ///< uint32_t array
-    uint8_t _bytes[ip::v6::address::e_bytes_size];  ///< bytes array
-  };
+  ip::v6::address _storage;           ///< address (ipv4 in the first 4 bytes)
   version _version = version::e_none; ///< address type
 };
 
@@ -0,0 +1,68 @@
+#pragma once
+#include <utility>
+#include <vector>
+
+#include "address.h"
+#include "prefix.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * address range [first, last]
+ */
+using address_range = std::pair<address, address>;
+
+/**
+ * convert address range to minimal list of prefixes
+ *
+ * @param first first address in range
+ * @param last last address in range (must have the same version as first)
+ * @param res prefixes in ascending order will be appended here
+ * @return false if addresses have different versions or first > last
+ */
+bool range_to_prefixes(address const &first, address const &last, std::vector<prefix> &res);
+
+/**
+ * build minimal list of prefixes which covers exactly given addresses
+ *
+ * @param addrs addresses (sorted or unsorted, duplicates allowed)
+ * @param threads number of threads used for sorting (0 - use all cores)
+ * @return ipv4 prefixes followed by ipv6 prefixes in ascending order
+ */
+std::vector<prefix> aggregate(std::vector<address> addrs, size_t threads = 1);
+
+/**
+ * build minimal list of prefixes which covers exactly given prefixes
+ *
+ * @param prefixes prefixes (overlapping and adjacent prefixes are merged)
+ * @return ipv4 prefixes followed by ipv6 prefixes in ascending order
+ */
+std::vector<prefix> aggregate(std::vector<prefix> const &prefixes);
+
+/**
+ * build minimal list of prefixes which covers exactly given ranges
+ *
+ * \note ranges with different versions of bounds or first > last are ignored
+ *
+ * @param ranges address ranges
+ * @return ipv4 prefixes followed by ipv6 prefixes in ascending order
+ */
+std::vector<prefix> aggregate(std::vector<address_range> const &ranges);
+
+/**
+ * build minimal list of prefixes which covers addresses from one prefix list
+ * not covered by another
+ *
+ * @param from prefixes to subtract from
+ * @param remove prefixes to subtract
+ * @return ipv4 prefixes followed by ipv6 prefixes in ascending order
+ */
+std::vector<prefix> exclude(std::vector<prefix> const &from, std::vector<prefix> const &remove);
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,220 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "hash.h"
+#include "rcu.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * map key to one of buckets with jump consistent hash (Lamping, Veach)
+ *
+ * only 1/n keys move when bucket is added to the end, but buckets can't be
+ * removed from the middle (use maglev or rendezvous for arbitrary sets)
+ *
+ * @param key key hash
+ * @param bucket_count number of buckets
+ * @return bucket index (0 if there are no buckets)
+ */
+inline uint32_t jump_hash(uint64_t key, uint32_t bucket_count) noexcept {
+  int64_t bucket = -1, next = 0;
+  while (next < static_cast<int64_t>(bucket_count)) {
+    bucket = next;
+    key = key * 2862933555777941757ULL + 1;
+    next = static_cast<int64_t>(static_cast<double>(bucket + 1) *
+                                (static_cast<double>(1LL << 31) / static_cast<double>((key >> 33) + 1)));
+  }
+  return bucket < 0 ? 0 : static_cast<uint32_t>(bucket);
+}
+
+/**
+ * map client to one of buckets with jump consistent hash
+ *
+ * @param client client endpoint
+ * @param bucket_count number of buckets
+ * @param seed hash seed
+ * @return bucket index (0 if there are no buckets)
+ */
+inline uint32_t jump_hash(full_address const &client, uint32_t bucket_count, uint64_t seed = 0) noexcept {
+  return jump_hash(hash(client, seed), bucket_count);
+}
+
+/**
+ * \brief highest random weight (rendezvous) backend selection
+ *
+ * client goes to backend with max hash of (client, backend) pair, so only
+ * clients of removed backend move. lookup is O(n), good for small sets.
+ */
+class rendezvous {
+public:
+  /**
+   * ctor
+   *
+   * @param backends backend endpoints
+   * @param seed hash seed
+   */
+  explicit rendezvous(std::vector<full_address> const &backends, uint64_t seed = 0);
+
+  /**
+   * get number of backends
+   */
+  size_t size() const noexcept {
+    return _hashes.size();
+  }
+
+  /**
+   * select backend for client
+   *
+   * @return backend index (size() if there are no backends)
+   */
+  size_t lookup(full_address const &client) const noexcept;
+
+private:
+  uint64_t _seed;                ///< hash seed
+  std::vector<uint64_t> _hashes; ///< backend hashes
+};
+
+/**
+ * \brief maglev lookup table (Eisenbud et al., NSDI 2016)
+ *
+ * every backend has its own permutation of slots derived from its endpoint
+ * hash and backends take turns filling their next preferred free slot, so
+ * load is even and table built for changed set differs from previous one
+ * mostly in slots of added/removed backends. lookup is one hash and one
+ * load. table is immutable, publish new one through maglev_balancer.
+ */
+class maglev_table {
+public:
+  enum : uint32_t {
+    e_default_size = 65537, ///< default number of slots (prime)
+    e_no_backend = 0xffffffff ///< slot value of empty table
+  };
+
+  /**
+   * ctor (builds table)
+   *
+   * @param backends backend endpoints (duplicates get the same slots)
+   * @param weights relative backend weights (empty for equal weights, 0 disables backend)
+   * @param size number of slots (rounded up to prime, much larger than number of backends)
+   * @param seed hash seed
+   */
+  explicit maglev_table(std::vector<full_address> backends, std::vector<uint32_t> const &weights = {},
+                        uint32_t size = e_default_size, uint64_t seed = 0);
+
+  /**
+   * get number of slots
+   */
+  uint32_t size() const noexcept {
+    return static_cast<uint32_t>(_slots.size());
+  }
+
+  /**
+   * get backends
+   */
+  std::vector<full_address> const &get_backends() const noexcept {
+    return _backends;
+  }
+
+  /**
+   * get backend index of slot
+   */
+  uint32_t get_slot(uint32_t slot) const noexcept {
+    return _slots[slot];
+  }
+
+  /**
+   * select backend for client
+   *
+   * @return backend index (e_no_backend if there are no backends)
+   */
+  uint32_t lookup(full_address const &client) const noexcept {
+    if (_slots.empty())
+      return e_no_backend;
+    // multiply instead of modulo, slots are uniform either way
+    uint64_t const key = hash(client, _seed) >> 32;
+    return _slots[(key * _slots.size()) >> 32];
+  }
+
+  /**
+   * select backends for burst of clients
+   *
+   * @param clients client endpoints
+   * @param size number of clients
+   * @param res backend indexes
+   */
+  void lookup(full_address const *clients, size_t size, uint32_t *res) const noexcept;
+
+  /**
+   * select backend for client
+   *
+   * @return backend or nullptr if there are no backends
+   */
+  full_address const *select(full_address const &client) const noexcept {
+    uint32_t const index = lookup(client);
+    return index != e_no_backend ? &_backends[index] : nullptr;
+  }
+
+private:
+  uint64_t _seed;                      ///< hash seed
+  std::vector<full_address> _backends; ///< backends
+  std::vector<uint32_t> _slots;        ///< backend index per slot
+};
+
+/**
+ * \brief maglev table with lock-free replacement
+ *
+ * lookups read current table under rcu guard, update() builds new table
+ * aside and swaps it in without blocking readers.
+ */
+class maglev_balancer {
+public:
+  /**
+   * ctor
+   *
+   * @param size number of slots (rounded up to prime)
+   * @param seed hash seed
+   */
+  explicit maglev_balancer(uint32_t size = maglev_table::e_default_size, uint64_t seed = 0);
+
+  /**
+   * replace backends
+   *
+   * \note must not be called while current thread holds guard
+   *
+   * @param backends backend endpoints
+   * @param weights relative backend weights (empty for equal weights)
+   */
+  void update(std::vector<full_address> backends, std::vector<uint32_t> const &weights = {});
+
+  /**
+   * get current table (hold guard to look up burst of clients)
+   */
+  rcu_ptr<maglev_table>::guard read() const noexcept {
+    return _table.read();
+  }
+
+  /**
+   * select backend for client
+   *
+   * @param client client endpoint
+   * @param backend selected backend
+   * @return false if there are no backends
+   */
+  bool select(full_address const &client, full_address &backend) const;
+
+private:
+  uint32_t _size;               ///< number of slots
+  uint64_t _seed;               ///< hash seed
+  rcu_ptr<maglev_table> _table; ///< current table
+};
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
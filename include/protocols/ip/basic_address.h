@@ -0,0 +1,178 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace bro::net::proto::ip {
+
+namespace v4 {
+class address;
+} // namespace v4
+
+namespace v6 {
+class address;
+} // namespace v6
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * ip address family known at compile time
+ */
+enum class family : uint8_t {
+  e_v4, ///< ipv4
+  e_v6  ///< ipv6
+};
+
+/**
+ * \brief storage parameters of address family
+ */
+template <family F> struct family_traits;
+
+template <> struct family_traits<family::e_v4> {
+  using word_type = uint32_t;       ///< storage word
+  using address_type = v4::address; ///< address class of family
+
+  enum {
+    e_bytes_size = 4 ///< address size in bytes
+  };
+};
+
+template <> struct family_traits<family::e_v6> {
+  using word_type = uint64_t;       ///< storage word
+  using address_type = v6::address; ///< address class of family
+
+  enum {
+    e_bytes_size = 16 ///< address size in bytes
+  };
+};
+
+namespace detail {
+
+inline uint32_t byte_swap(uint32_t value) noexcept {
+  return __builtin_bswap32(value);
+}
+
+inline uint64_t byte_swap(uint64_t value) noexcept {
+  return __builtin_bswap64(value);
+}
+
+} // namespace detail
+
+/**
+ * \brief storage and operations shared by ipv4 and ipv6 addresses
+ *
+ * address is an array of machine words in network byte order, every
+ * operation is a loop over constant number of words, so it is unrolled at
+ * compile time and the same code serves both families. v4::address and
+ * v6::address add family specific ctors and conversions on top of it.
+ *
+ * @tparam F address family
+ */
+template <family F> class basic_address {
+public:
+  using traits = family_traits<F>;                    ///< family parameters
+  using word_type = typename traits::word_type;       ///< storage word
+  using address_type = typename traits::address_type; ///< address class of family
+
+  enum {
+    e_bytes_size = traits::e_bytes_size,                   ///< address size in bytes
+    e_words_size = traits::e_bytes_size / sizeof(word_type) ///< address size in words
+  };
+
+  static constexpr family address_family = F; ///< address family
+
+  /**
+   * default constructor (zero address)
+   */
+  basic_address() noexcept = default;
+
+  /**
+   * ctor from byte array
+   */
+  explicit basic_address(uint8_t const (&bytes)[e_bytes_size]) noexcept {
+    memcpy(_bytes, bytes, e_bytes_size);
+  }
+
+  /**
+   * operator less (compares words, not numeric values)
+   */
+  bool operator<(basic_address const &r) const noexcept {
+    for (size_t i = 0; i + 1 < e_words_size; ++i) {
+      if (_words[i] != r._words[i])
+        return _words[i] < r._words[i];
+    }
+    return _words[e_words_size - 1] < r._words[e_words_size - 1];
+  }
+
+  /**
+   * operator equal
+   */
+  bool operator==(basic_address const &r) const noexcept {
+    word_type diff = 0;
+    for (size_t i = 0; i < e_words_size; ++i)
+      diff |= _words[i] ^ r._words[i];
+    return !diff;
+  }
+
+  /**
+   * operator not equal
+   */
+  bool operator!=(basic_address const &r) const noexcept {
+    return !(*this == r);
+  }
+
+  /**
+   * operator&
+   */
+  address_type operator&(basic_address const &r) const noexcept {
+    basic_address res;
+    for (size_t i = 0; i < e_words_size; ++i)
+      res._words[i] = _words[i] & r._words[i];
+    return address_type(res);
+  }
+
+  /**
+   * get current address in reverse order
+   */
+  address_type reverse_order() const noexcept {
+    basic_address res;
+    for (size_t i = 0; i < e_words_size; ++i)
+      res._words[i] = detail::byte_swap(_words[e_words_size - 1 - i]);
+    return address_type(res);
+  }
+
+  /**
+   * get address bytes
+   */
+  uint8_t const *get_bytes() const noexcept {
+    return _bytes;
+  }
+
+protected:
+  union {
+    word_type _words[e_words_size] = {}; ///< words array
+    uint8_t _bytes[e_bytes_size];        ///< bytes array
+  };
+};
+
+/**
+ * mask burst of addresses of one family (ex. to get their /24 or /64 networks)
+ *
+ * @param addrs addresses
+ * @param size number of addresses
+ * @param mask network mask
+ * @param res masked addresses (can be the same as addrs)
+ */
+template <typename Address>
+void mask_addresses(Address const *addrs, size_t size, Address const &mask, Address *res) noexcept {
+  static_assert(std::is_base_of_v<basic_address<Address::address_family>, Address>, "ip address is expected");
+  for (size_t i = 0; i < size; ++i)
+    res[i] = addrs[i] & mask;
+}
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "address.h"
+#include "full_address.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * packet classification status
+ */
+enum class packet_status : uint8_t {
+  e_ok,        ///< addresses and ports (if transport has ports) are set
+  e_not_ip,    ///< ethertype is not ipv4/ipv6, only vlan is set
+  e_fragment,  ///< non first fragment, addresses are set, ports are 0
+  e_truncated, ///< packet ends inside a header, set fields are valid
+  e_invalid    ///< malformed ip header, only vlan is set
+};
+
+/**
+ * \brief packet buffer of burst (ex. DPDK mbuf or AF_XDP descriptor data)
+ */
+struct packet {
+  uint8_t const *_data = nullptr; ///< ethernet frame
+  size_t _size = 0;               ///< frame size
+};
+
+/**
+ * \brief flow keys of burst in structure of arrays layout
+ *
+ * arrays are allocated once by ctor, classify doesn't allocate. ports are in
+ * host order, offsets are from the beginning of frame (0 if header is absent).
+ */
+struct flow_keys {
+  std::vector<address> _sources;            ///< source addresses
+  std::vector<address> _destinations;       ///< destination addresses
+  std::vector<uint16_t> _source_ports;      ///< tcp/udp/sctp source ports
+  std::vector<uint16_t> _destination_ports; ///< tcp/udp/sctp destination ports
+  std::vector<uint8_t> _protocols;          ///< transport protocol (ipv6 header chain is skipped)
+  std::vector<uint16_t> _vlans;             ///< outer vlan id (0 if untagged)
+  std::vector<uint16_t> _l3_offsets;        ///< ip header offsets
+  std::vector<uint16_t> _l4_offsets;        ///< transport header offsets
+  std::vector<packet_status> _statuses;     ///< classification statuses
+  size_t _size = 0;                         ///< number of classified packets
+
+  /**
+   * ctor
+   *
+   * @param capacity max burst size
+   */
+  explicit flow_keys(size_t capacity);
+
+  /**
+   * get max burst size
+   */
+  size_t capacity() const noexcept {
+    return _statuses.size();
+  }
+
+  /**
+   * get source endpoint of packet
+   */
+  full_address get_source(size_t index) const {
+    return full_address(_sources[index], _source_ports[index]);
+  }
+
+  /**
+   * get destination endpoint of packet
+   */
+  full_address get_destination(size_t index) const {
+    return full_address(_destinations[index], _destination_ports[index]);
+  }
+};
+
+/**
+ * parse burst of ethernet frames into flow keys
+ *
+ * frames are parsed in one pass (ethernet, up to two vlan tags, ipv4 or
+ * ipv6 with extension headers, tcp/udp/sctp ports) while next frames are
+ * prefetched. at most keys.capacity() packets are classified.
+ *
+ * @param packets frames
+ * @param size number of frames
+ * @param keys flow keys to fill (keys._size is set to number of classified packets)
+ * @return number of packets with e_ok status
+ */
+size_t classify(packet const *packets, size_t size, flow_keys &keys) noexcept;
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,127 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "address.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * \brief compressed address column format
+ *
+ * ipv6 addresses are split into 64 bit prefix and 64 bit interface
+ * identifier, prefixes go to the sorted column dictionary. every block of
+ * e_block_size addresses keeps frame of reference (base and bit width) and
+ * fixed width bit packed values for prefix indexes, identifiers and ipv4
+ * addresses, so blocks are decoded independently. blocks with both
+ * versions have version bitmap. all numbers are little endian.
+ *
+ * layout:
+ *   header: magic, address count, prefix count (uint32_t each)
+ *   prefixes: prefix count * uint64_t
+ *   block offsets: (block count + 1) * uint32_t (from the first block)
+ *   blocks: header, version bitmap (mixed blocks), indexes, identifiers, ipv4 addresses
+ *   padding: e_padding zero bytes
+ */
+struct codec {
+  enum : size_t {
+    e_block_size = 128, ///< addresses per block
+    e_padding = 8       ///< trailing bytes for unaligned word loads
+  };
+
+  enum : uint32_t {
+    e_magic = 0x31435049 ///< "IPC1"
+  };
+};
+
+/**
+ * encode addresses
+ *
+ * @param addrs addresses (ipv4 and ipv6)
+ * @param size number of addresses
+ * @param res encoded column (replaced)
+ * @return false if some address isn't set
+ */
+bool encode_addresses(address const *addrs, size_t size, std::vector<uint8_t> &res);
+
+/**
+ * \brief read only view of encoded column
+ *
+ * view doesn't own data, data must outlive view
+ */
+class address_column {
+public:
+  /**
+   * default constructor
+   */
+  address_column() = default;
+
+  /**
+   * validate encoded column and attach to it
+   *
+   * @param data encoded column
+   * @param size data size
+   * @return false if data is malformed
+   */
+  bool open(uint8_t const *data, size_t size) noexcept;
+
+  /**
+   * get number of addresses
+   */
+  size_t size() const noexcept {
+    return _size;
+  }
+
+  /**
+   * get number of blocks
+   */
+  size_t get_block_count() const noexcept {
+    return (_size + codec::e_block_size - 1) / codec::e_block_size;
+  }
+
+  /**
+   * get number of distinct prefixes
+   */
+  size_t get_prefix_count() const noexcept {
+    return _prefix_count;
+  }
+
+  /**
+   * decode block
+   *
+   * @param block block index
+   * @param res output (codec::e_block_size addresses)
+   * @return number of decoded addresses (last block can be partial)
+   */
+  size_t decode_block(size_t block, address *res) const noexcept;
+
+  /**
+   * decode all addresses
+   *
+   * @param res output (size() addresses)
+   */
+  void decode(address *res) const noexcept;
+
+  /**
+   * get address by index
+   *
+   * \note decodes single value, use decode_block for scans
+   */
+  address get(size_t index) const noexcept;
+
+private:
+  uint8_t const *_prefixes = nullptr; ///< prefix dictionary
+  uint8_t const *_offsets = nullptr;  ///< block offsets
+  uint8_t const *_blocks = nullptr;   ///< first block
+  size_t _size = 0;                   ///< number of addresses
+  size_t _prefix_count = 0;           ///< number of prefixes
+};
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
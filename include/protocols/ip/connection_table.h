@@ -0,0 +1,277 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "hash.h"
+#include "toeplitz.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * \brief connection endpoints as seen in received packets
+ */
+struct connection_key {
+  full_address _source;      ///< packet source
+  full_address _destination; ///< packet destination
+
+  bool operator==(connection_key const &key) const noexcept {
+    return _source == key._source && _destination == key._destination;
+  }
+
+  bool operator!=(connection_key const &key) const noexcept {
+    return !(*this == key);
+  }
+};
+
+/**
+ * \brief connection table sharded by NIC receive queue
+ *
+ * shard of connection is chosen as NIC chooses receive queue: RSS hash of
+ * the key selects entry of indirection table. when every core reads its own
+ * receive queue and owns shard with the same index, all lookups are local
+ * and need no locks. the rest of API isn't thread safe: shard is used only
+ * by its owner, except for send() which any thread can call.
+ *
+ * connections are moved between cores by messages: owner of source shard
+ * calls migrate(), owner of target shard picks it up in poll().
+ *
+ * @tparam T connection state (movable)
+ */
+template <typename T> class connection_table {
+public:
+  enum : size_t {
+    e_indirection_size = 128 ///< default indirection table size (as most NICs)
+  };
+
+  /**
+   * \brief part of table owned by one core
+   */
+  class shard {
+  public:
+    shard(shard const &) = delete;
+    shard &operator=(shard const &) = delete;
+
+    /**
+     * dtor (drops pending messages)
+     */
+    ~shard() {
+      for (message *msg = _inbox.exchange(nullptr, std::memory_order_acquire); msg;)
+        delete std::exchange(msg, msg->_next);
+    }
+
+    /**
+     * find connection
+     *
+     * @return state or nullptr if connection isn't in shard
+     */
+    T *find(connection_key const &key) noexcept {
+      auto const it = _connections.find(key);
+      return it != _connections.end() ? &it->second : nullptr;
+    }
+
+    /**
+     * add connection
+     *
+     * @return state and false if connection already exists (state isn't changed)
+     */
+    std::pair<T *, bool> insert(connection_key const &key, T value) {
+      auto const [it, inserted] = _connections.try_emplace(key, std::move(value));
+      return {&it->second, inserted};
+    }
+
+    /**
+     * remove connection
+     *
+     * @return false if connection isn't in shard
+     */
+    bool erase(connection_key const &key) {
+      return _connections.erase(key) != 0;
+    }
+
+    /**
+     * get number of connections
+     */
+    size_t size() const noexcept {
+      return _connections.size();
+    }
+
+    /**
+     * call function for every connection (key, state)
+     */
+    template <typename F> void for_each(F &&func) {
+      for (auto &[key, value] : _connections)
+        func(key, value);
+    }
+
+    /**
+     * move connection to another shard
+     *
+     * @param key connection
+     * @param target target shard index
+     * @return false if connection isn't in shard or target is invalid
+     */
+    bool migrate(connection_key const &key, size_t target) {
+      auto const it = _connections.find(key);
+      if (it == _connections.end() || target >= _table.get_shard_count())
+        return false;
+      _table.get_shard(target).send(it->first, std::move(it->second));
+      _connections.erase(it);
+      return true;
+    }
+
+    /**
+     * put connection to inbox of shard (thread safe)
+     *
+     * state replaces existing one when owner polls
+     */
+    void send(connection_key const &key, T value) {
+      auto *msg = new message{key, std::move(value), _inbox.load(std::memory_order_relaxed)};
+      while (!_inbox.compare_exchange_weak(msg->_next, msg, std::memory_order_release, std::memory_order_relaxed)) {
+      }
+    }
+
+    /**
+     * take connections sent to shard
+     *
+     * @return number of received connections
+     */
+    size_t poll() {
+      // the whole list is taken at once, so nodes can't be reused under producers
+      message *msg = _inbox.exchange(nullptr, std::memory_order_acquire);
+      message *ordered = nullptr;
+      while (msg)
+        ordered = std::exchange(msg, std::exchange(msg->_next, ordered));
+
+      size_t res = 0;
+      for (; ordered; ++res) {
+        std::unique_ptr<message> const current(std::exchange(ordered, ordered->_next));
+        _connections.insert_or_assign(current->_key, std::move(current->_value));
+      }
+      return res;
+    }
+
+    /**
+     * get shard index
+     */
+    size_t get_index() const noexcept {
+      return _index;
+    }
+
+  private:
+    friend class connection_table;
+
+    /**
+     * \brief migrated connection
+     */
+    struct message {
+      connection_key _key; ///< connection
+      T _value;            ///< state
+      message *_next;      ///< next message (newer first)
+    };
+
+    /**
+     * \brief key hash
+     */
+    struct key_hash {
+      size_t operator()(connection_key const &key) const noexcept {
+        return hash(key._source, hash(key._destination));
+      }
+    };
+
+    shard(connection_table &table, size_t index)
+      : _table(table)
+      , _index(index) {}
+
+    connection_table &_table;                                   ///< owner
+    size_t _index;                                              ///< shard index
+    std::unordered_map<connection_key, T, key_hash> _connections; ///< connections
+    alignas(64) std::atomic<message *> _inbox{nullptr};         ///< received messages
+  };
+
+  /**
+   * ctor
+   *
+   * indirection table spreads entries round robin over shards
+   *
+   * @param shard_count number of shards (receive queues)
+   * @param key RSS key of NIC
+   * @param key_size key size
+   */
+  explicit connection_table(size_t shard_count, uint8_t const *key = rss::default_key,
+                            size_t key_size = rss::e_key_size)
+    : _hasher(key, key_size)
+    , _indirection(e_indirection_size) {
+    shard_count = shard_count ? shard_count : 1;
+    for (size_t i = 0; i < shard_count; ++i)
+      _shards.emplace_back(new shard(*this, i));
+    for (size_t i = 0; i < _indirection.size(); ++i)
+      _indirection[i] = static_cast<uint32_t>(i % shard_count);
+  }
+
+  connection_table(connection_table const &) = delete;
+  connection_table &operator=(connection_table const &) = delete;
+
+  /**
+   * set indirection table of NIC (call before shards are used)
+   *
+   * @param table shard indexes (size is power of two)
+   * @return false if table is empty, its size isn't power of two or it has invalid index
+   */
+  bool set_indirection(std::vector<uint32_t> const &table) {
+    if (table.empty() || (table.size() & (table.size() - 1)))
+      return false;
+    for (auto index : table) {
+      if (index >= _shards.size())
+        return false;
+    }
+    _indirection = table;
+    return true;
+  }
+
+  /**
+   * get number of shards
+   */
+  size_t get_shard_count() const noexcept {
+    return _shards.size();
+  }
+
+  /**
+   * get shard by index
+   */
+  shard &get_shard(size_t index) noexcept {
+    return *_shards[index];
+  }
+
+  /**
+   * get index of shard owning connection
+   */
+  size_t get_shard_index(connection_key const &key) const noexcept {
+    uint32_t const rss_value = _hasher.hash(key._source, key._destination);
+    return _indirection[rss_value & (_indirection.size() - 1)];
+  }
+
+  /**
+   * get shard owning connection
+   */
+  shard &get_shard(connection_key const &key) noexcept {
+    return get_shard(get_shard_index(key));
+  }
+
+private:
+  toeplitz _hasher;                            ///< RSS hash of NIC key
+  std::vector<uint32_t> _indirection;          ///< RSS hash to shard index
+  std::vector<std::unique_ptr<shard>> _shards; ///< shards
+};
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,154 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "mapped_file.h"
+#include "prefix.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * \brief read only prefix database (geo, asn, ...)
+ *
+ * file contains binary trie over ipv6 address bits (ipv4 prefixes are
+ * stored under ::/96) followed by data section. file is mapped, so opening
+ * doesn't depend on database size and page cache is shared between
+ * processes. lookups don't copy anything and return offset of value in data
+ * section.
+ *
+ * layout: 64 bytes header, node_count nodes of two little endian uint32
+ * records, data section of values prefixed by uint32 length. record value
+ * less than node_count is a node index, node_count means no value and
+ * greater values are data offsets plus node_count + 1.
+ */
+class database {
+public:
+  /**
+   * default constructor
+   */
+  database() = default;
+
+  /**
+   * open database file
+   *
+   * @param path path to file
+   * @return true if operation succeed
+   */
+  bool open(std::string const &path) noexcept;
+
+  /**
+   * close database
+   */
+  void close() noexcept;
+
+  /**
+   * check if database is opened
+   */
+  bool is_open() const noexcept {
+    return _file.is_open();
+  }
+
+  /**
+   * find value of the longest prefix containing address
+   *
+   * ipv4 mapped ipv6 addresses (::ffff:a.b.c.d) are looked up as ipv4
+   *
+   * @param addr address
+   * @param offset value offset in data section
+   * @param prefix_length length of the largest network around address with the
+   * same value, as mmdb netmask (ipv4 length for ipv4 lookups)
+   * @return true if address was found
+   */
+  bool lookup(address const &addr, uint32_t &offset, uint8_t &prefix_length) const noexcept;
+
+  /**
+   * find value of the longest prefix containing address
+   *
+   * @param addr address
+   * @param offset value offset in data section
+   * @return true if address was found
+   */
+  bool lookup(address const &addr, uint32_t &offset) const noexcept {
+    uint8_t prefix_length = 0;
+    return lookup(addr, offset, prefix_length);
+  }
+
+  /**
+   * get value by offset
+   *
+   * @return value (points to mapped file) or empty view if offset is invalid
+   */
+  std::string_view get_value(uint32_t offset) const noexcept;
+
+  /**
+   * get number of trie nodes
+   */
+  uint32_t get_node_count() const noexcept {
+    return _node_count;
+  }
+
+private:
+  mapped_file _file;               ///< mapped database
+  uint32_t const *_nodes = nullptr; ///< trie nodes
+  uint8_t const *_data = nullptr;   ///< data section
+  uint64_t _data_size = 0;          ///< data section size
+  uint32_t _node_count = 0;         ///< number of nodes
+  uint32_t _ipv4_start = 0;         ///< record of ::/96 (ipv4 subtree)
+};
+
+/**
+ * \brief database file builder
+ *
+ * equal values are stored once
+ */
+class database_builder {
+public:
+  /**
+   * default constructor
+   */
+  database_builder();
+
+  /**
+   * add prefix (value of existing prefix is replaced)
+   *
+   * @param pref prefix
+   * @param value value
+   * @return false if prefix is not set or data section is full
+   */
+  bool insert(prefix const &pref, std::string_view value);
+
+  /**
+   * write database file
+   *
+   * @param path path to file
+   * @return true if operation succeed
+   */
+  bool save(std::string const &path) const;
+
+private:
+  enum : uint32_t { e_no_value = UINT32_MAX };
+
+  /**
+   * \brief trie node (child 0 means no child)
+   */
+  struct node {
+    uint32_t _children[2] = {0, 0}; ///< children
+    uint32_t _value = e_no_value;   ///< value offset
+  };
+
+  std::vector<node> _nodes;                           ///< trie (node 0 is root)
+  std::string _data;                                  ///< data section
+  std::unordered_map<std::string, uint32_t> _offsets; ///< value to offset
+};
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+
+#include "format.h"
+#include "full_address.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * endpoint parse errors
+ */
+enum class endpoint_error : uint8_t {
+  e_ok,                ///< no error
+  e_empty,             ///< empty string
+  e_invalid_address,   ///< address part is not ipv4/ipv6 address
+  e_missing_bracket,   ///< '[' without ']'
+  e_invalid_scope,     ///< scope is empty, unknown interface or set for ipv4
+  e_invalid_port,      ///< port is empty, not a number or greater than 65535
+  e_trailing_data      ///< unexpected characters after endpoint
+};
+
+/**
+ * \brief endpoint parse result
+ */
+struct endpoint_result {
+  endpoint_error _error = endpoint_error::e_ok; ///< error
+  size_t _position = 0;                         ///< position of the first invalid character
+
+  /**
+   * check if parsing succeed
+   */
+  explicit operator bool() const noexcept {
+    return _error == endpoint_error::e_ok;
+  }
+};
+
+enum {
+  e_max_endpoint_string = e_max_v6_string + 11 + 6 ///< max endpoint string length ("[v6%scope]:port")
+};
+
+/**
+ * parse address without allocations
+ *
+ * accepts the same strings as inet_pton
+ *
+ * @param str address string (ex. "127.0.0.1" or "fe80::1")
+ * @param addr address to fill
+ * @return parse result
+ */
+endpoint_result parse_address(std::string_view str, address &addr) noexcept;
+
+/**
+ * parse endpoint without allocations
+ *
+ * accepted forms are "a.b.c.d:port", "[v6]:port", "[v6%scope]:port" and bare
+ * addresses ("a.b.c.d", "v6", "v6%scope", "[v6]") with port 0. scope is an
+ * interface index or name.
+ *
+ * @param str endpoint string
+ * @param addr full address to fill (scope id is set if it is in string)
+ * @return parse result
+ */
+endpoint_result parse_endpoint(std::string_view str, full_address &addr) noexcept;
+
+/**
+ * parse batch of endpoints
+ *
+ * @param strs endpoint strings
+ * @param size number of strings
+ * @param addrs full addresses to fill (size elements)
+ * @param results parse results (size elements, can be nullptr)
+ * @return number of successfully parsed endpoints
+ */
+size_t parse_endpoints(std::string_view const *strs, size_t size, full_address *addrs,
+                       endpoint_result *results) noexcept;
+
+/**
+ * write endpoint string representation
+ *
+ * ipv6 address is always bracketed, scope id is written as number if set
+ * ("[fe80::1%2]:80")
+ *
+ * @param out buffer with at least e_max_endpoint_string bytes
+ * @param addr full address
+ * @return pointer past the last written character
+ */
+char *endpoint_to_chars(char *out, full_address const &addr) noexcept;
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,312 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "address.h"
+#include "hash.h"
+#include "mapped_file.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * \brief blocked bloom filter for ip addresses
+ *
+ * every address sets 8 bits in one 256 bit block, so lookup touches one
+ * cache line. ipv4 and ipv6 addresses can be kept in the same filter.
+ */
+class bloom_filter {
+public:
+  enum {
+    e_block_words = 8 ///< 32 bit words in block
+  };
+
+  /**
+   * ctor
+   *
+   * @param entries expected number of entries
+   * @param bits_per_entry filter bits per entry (16 gives ~0.1% false positives)
+   * @param seed hash seed
+   */
+  explicit bloom_filter(size_t entries = 0, uint8_t bits_per_entry = 16, uint64_t seed = 0);
+
+  /**
+   * add address
+   *
+   * @return false if filter is read only (loaded from file)
+   */
+  bool add(v4::address const &addr) noexcept {
+    return add_hash(hash(addr, _seed));
+  }
+
+  /**
+   * add address
+   *
+   * @return false if filter is read only (loaded from file)
+   */
+  bool add(v6::address const &addr) noexcept {
+    return add_hash(hash(addr, _seed));
+  }
+
+  /**
+   * add address
+   *
+   * @return false if filter is read only (loaded from file)
+   */
+  bool add(address const &addr) noexcept {
+    return add_hash(hash(addr, _seed));
+  }
+
+  /**
+   * check if address may be in filter
+   */
+  bool contains(v4::address const &addr) const noexcept {
+    return contains_hash(hash(addr, _seed));
+  }
+
+  /**
+   * check if address may be in filter
+   */
+  bool contains(v6::address const &addr) const noexcept {
+    return contains_hash(hash(addr, _seed));
+  }
+
+  /**
+   * check if address may be in filter
+   */
+  bool contains(address const &addr) const noexcept {
+    return contains_hash(hash(addr, _seed));
+  }
+
+  /**
+   * check batch of addresses
+   *
+   * @param addrs addresses
+   * @param size number of addresses
+   * @param res results (size elements)
+   */
+  void contains(v4::address const *addrs, size_t size, bool *res) const noexcept;
+
+  /**
+   * check batch of addresses
+   *
+   * @param addrs addresses
+   * @param size number of addresses
+   * @param res results (size elements)
+   */
+  void contains(v6::address const *addrs, size_t size, bool *res) const noexcept;
+
+  /**
+   * check batch of addresses
+   *
+   * @param addrs addresses
+   * @param size number of addresses
+   * @param res results (size elements)
+   */
+  void contains(address const *addrs, size_t size, bool *res) const noexcept;
+
+  /**
+   * save filter to file
+   *
+   * @param path path to file
+   * @return true if operation succeed
+   */
+  bool save(std::string const &path) const noexcept;
+
+  /**
+   * map filter saved by save()
+   *
+   * \note filter will be read only
+   *
+   * @param path path to file
+   * @return true if operation succeed
+   */
+  bool load(std::string const &path) noexcept;
+
+  /**
+   * get filter size in bytes
+   */
+  size_t get_size_in_bytes() const noexcept {
+    return _block_count * e_block_words * sizeof(uint32_t);
+  }
+
+private:
+  bool add_hash(uint64_t h) noexcept;
+  bool contains_hash(uint64_t h) const noexcept;
+  uint32_t const *get_block(uint64_t h) const noexcept {
+    return _blocks + (((h >> 32) * _block_count) >> 32) * e_block_words;
+  }
+  template <typename T> void contains_batch(T const *addrs, size_t size, bool *res) const noexcept;
+
+  std::vector<uint32_t> _storage; ///< filter data if filter is writable
+  mapped_file _file;              ///< filter data if filter is loaded from file
+  uint32_t const *_blocks = nullptr; ///< filter blocks
+  uint64_t _block_count = 0;      ///< number of blocks
+  uint64_t _seed = 0;             ///< hash seed
+};
+
+/**
+ * \brief cuckoo filter for ip addresses
+ *
+ * keeps 16 bit fingerprints in buckets with 4 slots. unlike bloom filter
+ * supports remove. ipv4 and ipv6 addresses can be kept in the same filter.
+ */
+class cuckoo_filter {
+public:
+  enum {
+    e_bucket_slots = 4, ///< slots in bucket
+    e_max_kicks = 500   ///< max relocations on insert
+  };
+
+  /**
+   * ctor
+   *
+   * @param entries expected number of entries
+   * @param seed hash seed
+   */
+  explicit cuckoo_filter(size_t entries = 0, uint64_t seed = 0);
+
+  /**
+   * add address
+   *
+   * @return false if filter is full or read only (loaded from file)
+   */
+  bool add(v4::address const &addr) noexcept {
+    return add_hash(hash(addr, _seed));
+  }
+
+  /**
+   * add address
+   *
+   * @return false if filter is full or read only (loaded from file)
+   */
+  bool add(v6::address const &addr) noexcept {
+    return add_hash(hash(addr, _seed));
+  }
+
+  /**
+   * add address
+   *
+   * @return false if filter is full or read only (loaded from file)
+   */
+  bool add(address const &addr) noexcept {
+    return add_hash(hash(addr, _seed));
+  }
+
+  /**
+   * remove address
+   *
+   * \note only added addresses can be removed
+   *
+   * @return false if address wasn't found or filter is read only
+   */
+  bool remove(address const &addr) noexcept {
+    return remove_hash(hash(addr, _seed));
+  }
+
+  /**
+   * check if address may be in filter
+   */
+  bool contains(v4::address const &addr) const noexcept {
+    return contains_hash(hash(addr, _seed));
+  }
+
+  /**
+   * check if address may be in filter
+   */
+  bool contains(v6::address const &addr) const noexcept {
+    return contains_hash(hash(addr, _seed));
+  }
+
+  /**
+   * check if address may be in filter
+   */
+  bool contains(address const &addr) const noexcept {
+    return contains_hash(hash(addr, _seed));
+  }
+
+  /**
+   * check batch of addresses
+   *
+   * @param addrs addresses
+   * @param size number of addresses
+   * @param res results (size elements)
+   */
+  void contains(v4::address const *addrs, size_t size, bool *res) const noexcept;
+
+  /**
+   * check batch of addresses
+   *
+   * @param addrs addresses
+   * @param size number of addresses
+   * @param res results (size elements)
+   */
+  void contains(v6::address const *addrs, size_t size, bool *res) const noexcept;
+
+  /**
+   * check batch of addresses
+   *
+   * @param addrs addresses
+   * @param size number of addresses
+   * @param res results (size elements)
+   */
+  void contains(address const *addrs, size_t size, bool *res) const noexcept;
+
+  /**
+   * save filter to file
+   *
+   * @param path path to file
+   * @return true if operation succeed
+   */
+  bool save(std::string const &path) const noexcept;
+
+  /**
+   * map filter saved by save()
+   *
+   * \note filter will be read only
+   *
+   * @param path path to file
+   * @return true if operation succeed
+   */
+  bool load(std::string const &path) noexcept;
+
+  /**
+   * get number of entries in filter
+   */
+  size_t get_count() const noexcept {
+    return _count;
+  }
+
+  /**
+   * get filter size in bytes
+   */
+  size_t get_size_in_bytes() const noexcept {
+    return (_bucket_mask + 1) * sizeof(uint64_t);
+  }
+
+private:
+  bool add_hash(uint64_t h) noexcept;
+  bool insert(uint64_t index, uint16_t fingerprint) noexcept;
+  bool remove_hash(uint64_t h) noexcept;
+  bool contains_hash(uint64_t h) const noexcept;
+  uint64_t alt_index(uint64_t index, uint16_t fingerprint) const noexcept;
+  template <typename T> void contains_batch(T const *addrs, size_t size, bool *res) const noexcept;
+
+  std::vector<uint64_t> _storage;  ///< filter data if filter is writable
+  mapped_file _file;               ///< filter data if filter is loaded from file
+  uint64_t const *_buckets = nullptr; ///< buckets (4 x 16 bit fingerprints)
+  uint64_t _bucket_mask = 0;       ///< number of buckets - 1
+  uint64_t _seed = 0;              ///< hash seed
+  uint64_t _count = 0;             ///< number of entries
+  uint64_t _victim_index = 0;      ///< bucket of fingerprint which didn't fit
+  uint16_t _victim_fingerprint = 0; ///< fingerprint which didn't fit (0 if none)
+  uint64_t _rnd = 0;               ///< state of random generator for relocations
+};
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
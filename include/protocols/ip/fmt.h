@@ -0,0 +1,27 @@
+#pragma once
+#include <fmt/format.h>
+
+#include "format.h"
+
+/**
+ * fmt formatters for addresses (see format_spec for options)
+ */
+template <>
+struct fmt::formatter<bro::net::proto::ip::v4::address>
+  : bro::net::proto::ip::detail::formatter_base<bro::net::proto::ip::v4::address,
+                                                bro::net::proto::ip::e_max_v4_string, fmt::format_error> {};
+
+template <>
+struct fmt::formatter<bro::net::proto::ip::v6::address>
+  : bro::net::proto::ip::detail::formatter_base<bro::net::proto::ip::v6::address,
+                                                bro::net::proto::ip::e_max_v6_string, fmt::format_error> {};
+
+template <>
+struct fmt::formatter<bro::net::proto::ip::address>
+  : bro::net::proto::ip::detail::formatter_base<bro::net::proto::ip::address, bro::net::proto::ip::e_max_v6_string,
+                                                fmt::format_error> {};
+
+template <>
+struct fmt::formatter<bro::net::proto::ip::full_address>
+  : bro::net::proto::ip::detail::formatter_base<bro::net::proto::ip::full_address,
+                                                bro::net::proto::ip::e_max_full_string, fmt::format_error> {};
@@ -0,0 +1,234 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#if __has_include(<version>)
+#include <version>
+#endif
+
+#include "address.h"
+#include "full_address.h"
+#include "inline_string.h"
+
+#ifdef __cpp_lib_format
+#include <format>
+#endif
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * \brief address formatting options
+ *
+ * in format strings options are set by letters: "e" - expanded, "b" -
+ * bracketed, "r" - reversed, "z" - zero padded. ex. "{:eb}"
+ */
+struct format_spec {
+  bool _expanded = false;    ///< ipv6 without "::" and with leading zeros
+  bool _bracketed = false;   ///< ipv6 in brackets ("[fe80::1]" or "[fe80::1]:80")
+  bool _reversed = false;    ///< address in reverse order
+  bool _zero_padded = false; ///< ipv4 octets with leading zeros ("010.000.000.001")
+};
+
+enum {
+  e_max_v4_string = 15,                      ///< max ipv4 string length
+  e_max_v6_string = 47,                      ///< max ipv6 string length (bracketed)
+  e_max_full_string = e_max_v6_string + 6    ///< max full address string length
+};
+
+enum {
+  e_v4_string_size = e_max_v4_string + 1,    ///< ipv4 string size with terminating zero
+  e_v6_string_size = 46,                     ///< ipv6 string size with terminating zero (INET6_ADDRSTRLEN)
+  e_full_string_size = e_max_full_string + 1 ///< full address string size with terminating zero
+};
+
+using v4_string = inline_string<e_v4_string_size>;     ///< ipv4 address string
+using v6_string = inline_string<e_v6_string_size>;     ///< ipv6 or ip address string
+using full_string = inline_string<e_full_string_size>; ///< full address string
+
+/**
+ * write address string representation
+ *
+ * @param out buffer with at least e_max_v4_string bytes
+ * @param addr address
+ * @param spec format options
+ * @return pointer past the last written character
+ */
+char *format_to(char *out, v4::address const &addr, format_spec const &spec = {}) noexcept;
+
+/**
+ * write address string representation
+ *
+ * \note compressed form is the same as inet_ntop produces
+ *
+ * @param out buffer with at least e_max_v6_string bytes
+ * @param addr address
+ * @param spec format options
+ * @return pointer past the last written character
+ */
+char *format_to(char *out, v6::address const &addr, format_spec const &spec = {}) noexcept;
+
+/**
+ * write address string representation
+ *
+ * @param out buffer with at least e_max_v6_string bytes
+ * @param addr address
+ * @param spec format options
+ * @return pointer past the last written character (nothing is written for unset address)
+ */
+char *format_to(char *out, address const &addr, format_spec const &spec = {}) noexcept;
+
+/**
+ * write full address string representation ("addr:port")
+ *
+ * @param out buffer with at least e_max_full_string bytes
+ * @param addr address
+ * @param spec format options
+ * @return pointer past the last written character
+ */
+char *format_to(char *out, full_address const &addr, format_spec const &spec = {}) noexcept;
+
+/**
+ * write address string representation into bounded buffer
+ *
+ * @param first buffer begin
+ * @param last buffer end
+ * @param addr address
+ * @param spec format options
+ * @return pointer past the last written character, or last and value_too_large
+ *         if representation doesn't fit (buffer content is unspecified)
+ */
+std::to_chars_result to_chars(char *first, char *last, v4::address const &addr, format_spec const &spec = {}) noexcept;
+
+/**
+ * write address string representation into bounded buffer
+ *
+ * @see to_chars(char *, char *, v4::address const &, format_spec const &)
+ */
+std::to_chars_result to_chars(char *first, char *last, v6::address const &addr, format_spec const &spec = {}) noexcept;
+
+/**
+ * write address string representation into bounded buffer
+ *
+ * @see to_chars(char *, char *, v4::address const &, format_spec const &)
+ */
+std::to_chars_result to_chars(char *first, char *last, address const &addr, format_spec const &spec = {}) noexcept;
+
+/**
+ * write full address string representation ("addr:port") into bounded buffer
+ *
+ * @see to_chars(char *, char *, v4::address const &, format_spec const &)
+ */
+std::to_chars_result to_chars(char *first, char *last, full_address const &addr,
+                              format_spec const &spec = {}) noexcept;
+
+/**
+ * get address string representation without allocation
+ *
+ * @return the same string as address::to_string()
+ */
+v4_string to_inline_string(v4::address const &addr) noexcept;
+
+/**
+ * get address string representation without allocation
+ *
+ * @return the same string as address::to_string()
+ */
+v6_string to_inline_string(v6::address const &addr) noexcept;
+
+/**
+ * get address string representation without allocation
+ *
+ * @return the same string as address::to_string() (empty for unset address)
+ */
+v6_string to_inline_string(address const &addr) noexcept;
+
+/**
+ * get full address string representation without allocation
+ *
+ * @param addr address
+ * @param spec format options
+ * @return the same string as full_address::to_string() for default options
+ */
+full_string to_inline_string(full_address const &addr, format_spec const &spec = {}) noexcept;
+
+namespace detail {
+
+/**
+ * parse format spec letters up to '}'
+ *
+ * @tparam Error exception thrown on invalid spec (format_error of formatting library)
+ */
+template <typename Error, typename It> constexpr It parse_format_spec(It first, It last, format_spec &spec) {
+  for (; first != last && *first != '}'; ++first) {
+    switch (*first) {
+    case 'e':
+      spec._expanded = true;
+      break;
+    case 'b':
+      spec._bracketed = true;
+      break;
+    case 'r':
+      spec._reversed = true;
+      break;
+    case 'z':
+      spec._zero_padded = true;
+      break;
+    default:
+      throw Error("invalid address format spec");
+    }
+  }
+  return first;
+}
+
+/**
+ * \brief common part of std and fmt formatters
+ *
+ * address is rendered into stack buffer and copied to output iterator
+ *
+ * @tparam Error format_error of formatting library
+ */
+template <typename Address, size_t Size, typename Error> struct formatter_base {
+  format_spec _spec; ///< parsed options
+
+  template <typename Context> constexpr auto parse(Context &ctx) {
+    return parse_format_spec<Error>(ctx.begin(), ctx.end(), _spec);
+  }
+
+  template <typename Context> auto format(Address const &addr, Context &ctx) const {
+    char buffer[Size];
+    char *end = ::bro::net::proto::ip::format_to(buffer, addr, _spec);
+    return std::copy(buffer, end, ctx.out());
+  }
+};
+
+} // namespace detail
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
+
+#ifdef __cpp_lib_format
+template <>
+struct std::formatter<bro::net::proto::ip::v4::address>
+  : bro::net::proto::ip::detail::formatter_base<bro::net::proto::ip::v4::address,
+                                                bro::net::proto::ip::e_max_v4_string, std::format_error> {};
+
+template <>
+struct std::formatter<bro::net::proto::ip::v6::address>
+  : bro::net::proto::ip::detail::formatter_base<bro::net::proto::ip::v6::address,
+                                                bro::net::proto::ip::e_max_v6_string, std::format_error> {};
+
+template <>
+struct std::formatter<bro::net::proto::ip::address>
+  : bro::net::proto::ip::detail::formatter_base<bro::net::proto::ip::address, bro::net::proto::ip::e_max_v6_string,
+                                                std::format_error> {};
+
+template <>
+struct std::formatter<bro::net::proto::ip::full_address>
+  : bro::net::proto::ip::detail::formatter_base<bro::net::proto::ip::full_address,
+                                                bro::net::proto::ip::e_max_full_string, std::format_error> {};
+#endif // __cpp_lib_format
@@ -35,6 +35,7 @@ public:
    */
   full_address(full_address const &faddr)
     : _address(faddr._address)
+    , _scope_id(faddr._scope_id)
     , _port(faddr._port) {}
 
   /**
@@ -42,6 +43,7 @@ public:
    */
   full_address(full_address &&faddr)
     : _address(faddr._address)
+    , _scope_id(faddr._scope_id)
     , _port(faddr._port) {}
 
 #ifdef __linux__
@@ -61,6 +63,7 @@ public:
    */
   full_address &operator=(full_address const &faddr) {
     _address = faddr._address;
+    _scope_id = faddr._scope_id;
     _port = faddr._port;
     return *this;
   }
@@ -70,6 +73,7 @@ public:
    */
   full_address &operator=(full_address &&faddr) {
     _address = faddr._address;
+    _scope_id = faddr._scope_id;
     _port = faddr._port;
     return *this;
   }
@@ -98,9 +102,7 @@ public:
   /**
    * generate string representation
    */
-  std::string to_string() const {
-    return address_to_string(_address) + ":" + std::to_string(_port);
-  }
+  std::string to_string() const;
 
   /**
    * get address
@@ -130,6 +132,20 @@ public:
     _port = port;
   }
 
+  /**
+   * get scope id (not set if it wasn't given or resolved yet)
+   */
+  std::optional<uint32_t> get_scope_id() const noexcept {
+    return _scope_id;
+  }
+
+  /**
+   * set scope id (interface index for link local ipv6 addresses)
+   */
+  void set_scope_id(uint32_t scope_id) noexcept {
+    _scope_id = scope_id;
+  }
+
 #ifdef __linux__
 
   /**
@@ -145,7 +161,7 @@ public:
 
 private:
   address _address; ///< address
-  mutable std::optional<uint32_t> _scope_id;
+  mutable std::optional<uint32_t> _scope_id; ///< scope id (resolved on first use)
   uint16_t _port = 0; ///< port
 };
 
@@ -0,0 +1,302 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include "numeric.h"
+#include "prefix.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+namespace detail {
+
+/**
+ * number type of address
+ */
+template <typename T> struct address_number;
+
+template <> struct address_number<v4::address> {
+  using type = uint32_t;
+  static v4::address to_address(type value) noexcept {
+    return to_v4_address(value);
+  }
+};
+
+template <> struct address_number<v6::address> {
+  using type = uint128_t;
+  static v6::address to_address(type value) noexcept {
+    return to_v6_address(value);
+  }
+};
+
+} // namespace detail
+
+/**
+ * \brief iterator over addresses in numeric order
+ */
+template <typename T> class address_iterator {
+public:
+  using number = typename detail::address_number<T>::type;
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T const *;
+  using reference = T const &;
+
+  /**
+   * end iterator
+   */
+  address_iterator() = default;
+
+  /**
+   * iterator from first to last (inclusive)
+   */
+  address_iterator(number first, number last) noexcept
+    : _current(first)
+    , _last(last)
+    , _address(detail::address_number<T>::to_address(first))
+    , _done(first > last) {}
+
+  reference operator*() const noexcept {
+    return _address;
+  }
+
+  pointer operator->() const noexcept {
+    return &_address;
+  }
+
+  address_iterator &operator++() noexcept {
+    if (_current == _last) {
+      _done = true;
+    } else {
+      _address = detail::address_number<T>::to_address(++_current);
+    }
+    return *this;
+  }
+
+  address_iterator operator++(int) noexcept {
+    auto it = *this;
+    ++*this;
+    return it;
+  }
+
+  bool operator==(address_iterator const &it) const noexcept {
+    return _done == it._done && (_done || _current == it._current);
+  }
+
+  bool operator!=(address_iterator const &it) const noexcept {
+    return !(*this == it);
+  }
+
+private:
+  number _current = 0; ///< current address number
+  number _last = 0;    ///< last address number
+  T _address;          ///< current address
+  bool _done = true;   ///< iterator reached end
+};
+
+/**
+ * \brief range of addresses in numeric order (last is included)
+ *
+ * ex. for (auto const &addr : address_view<v4::address>(prefix("10.0.0.0/30"))) ...
+ */
+template <typename T> class address_view {
+public:
+  using number = typename detail::address_number<T>::type;
+
+  /**
+   * ctor from first and last address (empty if first > last)
+   */
+  address_view(T const &first, T const &last) noexcept
+    : _first(to_number(first))
+    , _last(to_number(last)) {}
+
+  /**
+   * ctor from prefix (empty if prefix version doesn't match T)
+   */
+  explicit address_view(prefix const &pref) noexcept {
+    constexpr auto version = T::address_family == family::e_v4 ? address::version::e_v4 : address::version::e_v6;
+    if (pref.get_version() != version)
+      return;
+    uint128_t const first = to_number(pref.get_address());
+    uint8_t const host_bits = max_prefix_length(pref.get_version()) - pref.get_length();
+    uint128_t const hosts = host_bits < 128 ? (uint128_t(1) << host_bits) - 1 : ~uint128_t(0);
+    _first = static_cast<number>(first);
+    _last = static_cast<number>(first | hosts);
+  }
+
+  address_iterator<T> begin() const noexcept {
+    return address_iterator<T>(_first, _last);
+  }
+
+  address_iterator<T> end() const noexcept {
+    return address_iterator<T>();
+  }
+
+private:
+  number _first = 1; ///< first address number
+  number _last = 0;  ///< last address number
+};
+
+/**
+ * \brief seeded random address generator constrained to prefix
+ *
+ * counter based (address i is a hash of seed and i), so batches are
+ * generated without dependency between elements and vectorize well
+ */
+class random_generator {
+public:
+  /**
+   * ctor
+   *
+   * @param pref network prefix, only host bits are random
+   * @param seed seed
+   */
+  explicit random_generator(prefix const &pref, uint64_t seed = 0) noexcept;
+
+  /**
+   * get next address
+   */
+  address operator()() noexcept;
+
+  /**
+   * generate batch of addresses
+   */
+  void generate(address *out, size_t size) noexcept;
+
+  /**
+   * generate batch of ipv4 addresses
+   *
+   * @return false if prefix is not ipv4
+   */
+  bool generate(v4::address *out, size_t size) noexcept;
+
+  /**
+   * generate batch of ipv6 addresses
+   *
+   * @return false if prefix is not ipv6
+   */
+  bool generate(v6::address *out, size_t size) noexcept;
+
+private:
+  prefix _prefix;         ///< prefix
+  uint64_t _base[2] = {}; ///< prefix address qwords (network order)
+  uint64_t _mask[2] = {}; ///< host bits mask qwords (network order)
+  uint64_t _seed = 0;     ///< seed
+  uint64_t _counter = 0;  ///< number of generated random values
+};
+
+/**
+ * \brief pseudo random permutation of prefix addresses
+ *
+ * every address of prefix is visited exactly once. address at index is
+ * computed by keyed bijective mix of index host bits, so nothing is stored
+ * and any position can be accessed directly (ex. to split scan between
+ * workers).
+ */
+class permutation {
+public:
+  /**
+   * \brief iterator over permutation
+   */
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = address;
+    using difference_type = std::ptrdiff_t;
+    using pointer = address const *;
+    using reference = address const &;
+
+    /**
+     * end iterator
+     */
+    iterator() = default;
+
+    /**
+     * iterator from index
+     */
+    iterator(permutation const *perm, uint128_t index) noexcept
+      : _perm(perm)
+      , _index(index)
+      , _address((*perm)[index]) {}
+
+    reference operator*() const noexcept {
+      return _address;
+    }
+
+    pointer operator->() const noexcept {
+      return &_address;
+    }
+
+    iterator &operator++() noexcept {
+      if (!(++_index & _perm->_mask))
+        _perm = nullptr;
+      else
+        _address = (*_perm)[_index];
+      return *this;
+    }
+
+    iterator operator++(int) noexcept {
+      auto it = *this;
+      ++*this;
+      return it;
+    }
+
+    bool operator==(iterator const &it) const noexcept {
+      return _perm == it._perm && (!_perm || _index == it._index);
+    }
+
+    bool operator!=(iterator const &it) const noexcept {
+      return !(*this == it);
+    }
+
+  private:
+    permutation const *_perm = nullptr; ///< permutation (nullptr for end)
+    uint128_t _index = 0;               ///< index
+    address _address;                   ///< current address
+  };
+
+  /**
+   * ctor
+   *
+   * @param pref network prefix
+   * @param seed permutation key
+   */
+  explicit permutation(prefix const &pref, uint64_t seed = 0) noexcept;
+
+  /**
+   * get number of host bits (permutation has 2^host_bits addresses)
+   */
+  uint8_t get_host_bits() const noexcept {
+    return _host_bits;
+  }
+
+  /**
+   * get address at index (index is taken modulo 2^host_bits)
+   */
+  address operator[](uint128_t index) const noexcept;
+
+  iterator begin() const noexcept {
+    return iterator(this, 0);
+  }
+
+  iterator end() const noexcept {
+    return iterator();
+  }
+
+private:
+  prefix _prefix;          ///< prefix
+  uint128_t _base = 0;     ///< prefix address number
+  uint128_t _mask = 0;     ///< host bits mask
+  uint128_t _keys[4] = {}; ///< round keys (odd multipliers and offsets)
+  uint8_t _host_bits = 0;  ///< number of host bits
+  uint8_t _shift = 0;      ///< xorshift distance
+};
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,136 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+#include "address.h"
+#include "full_address.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+namespace detail {
+
+/**
+ * hash constants
+ */
+enum : uint64_t {
+  e_hash_k0 = 0xa0761d6478bd642full, ///< first secret
+  e_hash_k1 = 0xe7037ed1a0b428dbull, ///< second secret
+  e_hash_k2 = 0x8ebc6af09c88c6e3ull  ///< third secret
+};
+
+/**
+ * multiply two values and fold 128 bit result
+ */
+inline uint64_t hash_mix(uint64_t a, uint64_t b) noexcept {
+  __uint128_t r = static_cast<__uint128_t>(a) * b;
+  return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+}
+
+} // namespace detail
+
+/**
+ * hash ipv4 address
+ *
+ * @param addr address
+ * @param seed hash seed
+ * @return 64 bit hash
+ */
+inline uint64_t hash(v4::address const &addr, uint64_t seed = 0) noexcept {
+  return detail::hash_mix(detail::hash_mix(addr.get_data() ^ seed ^ detail::e_hash_k0, detail::e_hash_k1),
+                          uint64_t(detail::e_hash_k2) ^ v4::address::e_bytes_size);
+}
+
+/**
+ * hash ipv6 address
+ *
+ * @param addr address
+ * @param seed hash seed
+ * @return 64 bit hash
+ */
+inline uint64_t hash(v6::address const &addr, uint64_t seed = 0) noexcept {
+  uint64_t qword[v6::address::e_qword_size];
+  memcpy(qword, addr.get_data(), v6::address::e_bytes_size);
+  return detail::hash_mix(detail::hash_mix(qword[0] ^ seed ^ detail::e_hash_k0, qword[1] ^ detail::e_hash_k1),
+                          uint64_t(detail::e_hash_k2) ^ v6::address::e_bytes_size);
+}
+
+/**
+ * hash ip address
+ *
+ * \note hash is the same as for underlying v4/v6 address
+ *
+ * @param addr address
+ * @param seed hash seed
+ * @return 64 bit hash
+ */
+inline uint64_t hash(address const &addr, uint64_t seed = 0) noexcept {
+  switch (addr.get_version()) {
+  case address::version::e_v4:
+    return hash(addr.to_v4(), seed);
+  case address::version::e_v6:
+    return hash(addr.to_v6(), seed);
+  default:
+    break;
+  }
+  return detail::hash_mix(seed ^ detail::e_hash_k0, detail::e_hash_k2);
+}
+
+/**
+ * hash full address (address + port)
+ *
+ * @param addr address
+ * @param seed hash seed
+ * @return 64 bit hash
+ */
+inline uint64_t hash(full_address const &addr, uint64_t seed = 0) noexcept {
+  return detail::hash_mix(hash(addr.get_address(), seed) ^ detail::e_hash_k1, addr.get_port() ^ detail::e_hash_k2);
+}
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
+
+namespace std {
+
+/**
+ * std::hash specialization for ipv4 address
+ */
+template <> struct hash<bro::net::proto::ip::v4::address> {
+  size_t operator()(bro::net::proto::ip::v4::address const &addr) const noexcept {
+    return bro::net::proto::ip::hash(addr);
+  }
+};
+
+/**
+ * std::hash specialization for ipv6 address
+ */
+template <> struct hash<bro::net::proto::ip::v6::address> {
+  size_t operator()(bro::net::proto::ip::v6::address const &addr) const noexcept {
+    return bro::net::proto::ip::hash(addr);
+  }
+};
+
+/**
+ * std::hash specialization for ip address
+ */
+template <> struct hash<bro::net::proto::ip::address> {
+  size_t operator()(bro::net::proto::ip::address const &addr) const noexcept {
+    return bro::net::proto::ip::hash(addr);
+  }
+};
+
+/**
+ * std::hash specialization for full address
+ */
+template <> struct hash<bro::net::proto::ip::full_address> {
+  size_t operator()(bro::net::proto::ip::full_address const &addr) const noexcept {
+    return bro::net::proto::ip::hash(addr);
+  }
+};
+
+} // namespace std
@@ -0,0 +1,159 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * \brief fixed capacity zero terminated string stored in place
+ *
+ * returned by value instead of std::string when max length is known, so
+ * formatting never allocates
+ *
+ * @tparam N buffer size including terminating zero
+ */
+template <size_t N> class inline_string {
+  static_assert(N > 0 && N <= 256, "inline string size must fit uint8_t length");
+
+public:
+  /**
+   * ctor (empty string)
+   */
+  inline_string() noexcept {
+    _data[0] = 0;
+  }
+
+  /**
+   * ctor
+   *
+   * @param str characters (truncated to capacity())
+   * @param size number of characters
+   */
+  inline_string(char const *str, size_t size) noexcept {
+    assign(str, size);
+  }
+
+  /**
+   * replace content
+   *
+   * @param str characters (truncated to capacity())
+   * @param size number of characters
+   */
+  void assign(char const *str, size_t size) noexcept {
+    _size = static_cast<uint8_t>(size < N ? size : N - 1);
+    memcpy(_data, str, _size);
+    _data[_size] = 0;
+  }
+
+  /**
+   * get max number of characters
+   */
+  static constexpr size_t capacity() noexcept {
+    return N - 1;
+  }
+
+  /**
+   * get number of characters
+   */
+  size_t size() const noexcept {
+    return _size;
+  }
+
+  /**
+   * get number of characters
+   */
+  size_t length() const noexcept {
+    return _size;
+  }
+
+  /**
+   * check if string is empty
+   */
+  bool empty() const noexcept {
+    return !_size;
+  }
+
+  /**
+   * get characters
+   */
+  char const *data() const noexcept {
+    return _data;
+  }
+
+  /**
+   * get zero terminated characters
+   */
+  char const *c_str() const noexcept {
+    return _data;
+  }
+
+  /**
+   * get iterator to first character
+   */
+  char const *begin() const noexcept {
+    return _data;
+  }
+
+  /**
+   * get iterator past last character
+   */
+  char const *end() const noexcept {
+    return _data + _size;
+  }
+
+  /**
+   * get view of characters
+   */
+  operator std::string_view() const noexcept {
+    return {_data, _size};
+  }
+
+  /**
+   * copy to std::string
+   */
+  std::string to_string() const {
+    return {_data, _size};
+  }
+
+  bool operator==(std::string_view str) const noexcept {
+    return std::string_view(*this) == str;
+  }
+
+  bool operator!=(std::string_view str) const noexcept {
+    return !(*this == str);
+  }
+
+  /**
+   * compare with string on the left side
+   */
+  friend bool operator==(std::string_view str, inline_string const &rhs) noexcept {
+    return rhs == str;
+  }
+
+  friend bool operator!=(std::string_view str, inline_string const &rhs) noexcept {
+    return rhs != str;
+  }
+
+private:
+  char _data[N];     ///< characters and terminating zero
+  uint8_t _size = 0; ///< number of characters
+};
+
+/**
+ * print string to stream
+ */
+template <size_t N> std::ostream &operator<<(std::ostream &strm, inline_string<N> const &str) {
+  return strm.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,162 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "address.h"
+#include "hash.h"
+#include "rcu.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * \brief address assigned to local interface
+ */
+struct interface_address {
+  address _address;           ///< address
+  uint8_t _prefix_length = 0; ///< prefix length
+  uint32_t _scope_id = 0;     ///< ipv6 scope id (0 for global addresses)
+  uint32_t _index = 0;        ///< interface index
+};
+
+/**
+ * \brief local interface
+ */
+struct interface {
+  uint32_t _index = 0;                       ///< interface index
+  uint32_t _flags = 0;                       ///< interface flags (IFF_*)
+  std::string _name;                         ///< interface name
+  std::vector<interface_address> _addresses; ///< assigned addresses
+};
+
+/**
+ * \brief immutable snapshot of local interfaces
+ */
+class interface_table {
+public:
+  /**
+   * default constructor (empty table)
+   */
+  interface_table() = default;
+
+  /**
+   * ctor from interfaces
+   */
+  explicit interface_table(std::vector<interface> interfaces);
+
+  interface_table(interface_table const &) = delete;
+  interface_table &operator=(interface_table const &) = delete;
+
+  /**
+   * build snapshot of current local interfaces
+   */
+  static std::unique_ptr<interface_table const> load();
+
+  /**
+   * find interface by index
+   *
+   * @return interface or nullptr if not found
+   */
+  interface const *find(uint32_t index) const noexcept;
+
+  /**
+   * find interface address
+   *
+   * @return address description or nullptr if address isn't local
+   */
+  interface_address const *find(address const &addr) const noexcept;
+
+  /**
+   * get all interfaces
+   */
+  std::vector<interface> const &get_interfaces() const noexcept {
+    return _interfaces;
+  }
+
+private:
+  std::vector<interface> _interfaces;                                  ///< interfaces
+  std::unordered_map<uint32_t, size_t> _by_index;                     ///< index -> interface
+  std::unordered_map<address, interface_address const *> _by_address; ///< address -> description
+};
+
+/**
+ * \brief keeps current snapshot of local interfaces
+ *
+ * readers get current snapshot wait-free. snapshot is replaced on refresh()
+ * or, if listener is started, on every netlink link/address notification.
+ * while listener is started it also keeps process wide snapshot of
+ * lookup_scope_id() current.
+ */
+class interface_monitor {
+public:
+  /**
+   * ctor (loads current snapshot)
+   */
+  interface_monitor();
+
+  /**
+   * dtor (stops listener)
+   */
+  ~interface_monitor();
+
+  interface_monitor(interface_monitor const &) = delete;
+  interface_monitor &operator=(interface_monitor const &) = delete;
+
+  /**
+   * get current snapshot
+   *
+   * \note snapshot stays valid while returned guard exists
+   */
+  rcu_ptr<interface_table>::guard get() const noexcept {
+    return _table.read();
+  }
+
+  /**
+   * reload snapshot
+   */
+  void refresh();
+
+  /**
+   * start background netlink listener
+   *
+   * @return true if operation succeed
+   */
+  bool start();
+
+  /**
+   * stop background netlink listener
+   */
+  void stop();
+
+private:
+  void listen();
+
+  rcu_ptr<interface_table> _table; ///< current snapshot
+  std::thread _listener;           ///< netlink listener
+  std::atomic_bool _stop{false};   ///< stop listener
+  int _socket = -1;                ///< netlink socket
+};
+
+/**
+ * find scope id of local address
+ *
+ * reads process wide snapshot, which is kept current by started
+ * interface_monitor or reloaded on miss if no monitor is started
+ *
+ * @param addr address
+ * @param scope_id scope id (0 for global addresses)
+ * @return false if address isn't local
+ */
+bool lookup_scope_id(address const &addr, uint32_t &scope_id);
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * \brief read only memory mapped file
+ *
+ * mapping is shared, so page cache is shared between all processes which
+ * map the same file
+ */
+class mapped_file {
+public:
+  /**
+   * default constructor
+   */
+  mapped_file() = default;
+
+  /**
+   * dtor
+   */
+  ~mapped_file();
+
+  mapped_file(mapped_file const &) = delete;
+  mapped_file &operator=(mapped_file const &) = delete;
+
+  /**
+   * move ctor
+   */
+  mapped_file(mapped_file &&file) noexcept;
+
+  /**
+   * move assign operator
+   */
+  mapped_file &operator=(mapped_file &&file) noexcept;
+
+  /**
+   * map file
+   *
+   * @param path path to file
+   * @return true if operation succeed
+   */
+  bool open(std::string const &path) noexcept;
+
+  /**
+   * unmap file
+   */
+  void close() noexcept;
+
+  /**
+   * check if file is mapped
+   */
+  bool is_open() const noexcept {
+    return _data != nullptr;
+  }
+
+  /**
+   * get mapped data
+   */
+  uint8_t const *get_data() const noexcept {
+    return _data;
+  }
+
+  /**
+   * get mapped data size
+   */
+  size_t get_size() const noexcept {
+    return _size;
+  }
+
+private:
+  uint8_t const *_data = nullptr; ///< mapped data
+  size_t _size = 0;               ///< mapped data size
+};
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,130 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "address.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * 128 bit unsigned integer
+ */
+using uint128_t = unsigned __int128;
+
+/**
+ * convert ipv4 address to number (host byte order)
+ */
+inline uint32_t to_number(v4::address const &addr) noexcept {
+  return __builtin_bswap32(addr.get_data());
+}
+
+/**
+ * convert ipv6 address to number (host byte order)
+ */
+inline uint128_t to_number(v6::address const &addr) noexcept {
+  uint64_t qword[v6::address::e_qword_size];
+  memcpy(qword, addr.get_data(), v6::address::e_bytes_size);
+  return (uint128_t(__builtin_bswap64(qword[0])) << 64) | __builtin_bswap64(qword[1]);
+}
+
+/**
+ * convert address to number (host byte order)
+ *
+ * @return number (ipv4 address occupies low 32 bits)
+ */
+inline uint128_t to_number(address const &addr) noexcept {
+  return addr.is_ipv4() ? uint128_t(to_number(addr.to_v4())) : to_number(addr.to_v6());
+}
+
+/**
+ * convert number (host byte order) to ipv4 address
+ */
+inline v4::address to_v4_address(uint32_t value) noexcept {
+  return v4::address(__builtin_bswap32(value));
+}
+
+/**
+ * convert number (host byte order) to ipv6 address
+ */
+inline v6::address to_v6_address(uint128_t value) noexcept {
+  return v6::address(__builtin_bswap64(static_cast<uint64_t>(value >> 64)), __builtin_bswap64(static_cast<uint64_t>(value)));
+}
+
+/**
+ * convert number (host byte order) to address
+ *
+ * @param value number
+ * @param ver address version
+ */
+inline address to_address(uint128_t value, address::version ver) noexcept {
+  switch (ver) {
+  case address::version::e_v4:
+    return address(to_v4_address(static_cast<uint32_t>(value)));
+  case address::version::e_v6:
+    return address(to_v6_address(value));
+  default:
+    break;
+  }
+  return {};
+}
+
+/**
+ * get address following addr in numeric order (wraps around)
+ *
+ * @param addr address
+ * @param step distance
+ */
+inline v4::address increment(v4::address const &addr, uint32_t step = 1) noexcept {
+  return to_v4_address(to_number(addr) + step);
+}
+
+/**
+ * get address following addr in numeric order (wraps around)
+ *
+ * @param addr address
+ * @param step distance
+ */
+inline v6::address increment(v6::address const &addr, uint128_t step = 1) noexcept {
+  return to_v6_address(to_number(addr) + step);
+}
+
+/**
+ * get address preceding addr in numeric order (wraps around)
+ *
+ * @param addr address
+ * @param step distance
+ */
+inline v4::address decrement(v4::address const &addr, uint32_t step = 1) noexcept {
+  return to_v4_address(to_number(addr) - step);
+}
+
+/**
+ * get address preceding addr in numeric order (wraps around)
+ *
+ * @param addr address
+ * @param step distance
+ */
+inline v6::address decrement(v6::address const &addr, uint128_t step = 1) noexcept {
+  return to_v6_address(to_number(addr) - step);
+}
+
+/**
+ * round value up to power of two
+ *
+ * @return smallest power of two not less than value (1 for 0)
+ */
+inline size_t round_up_pow2(size_t value) noexcept {
+  size_t res = 1;
+  while (res < value)
+    res <<= 1;
+  return res;
+}
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,134 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "classify.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * \brief AF_PACKET TPACKET_V3 receive ring
+ *
+ * kernel fills blocks of mmap'ed ring, reader classifies frames in place
+ * and returns block to kernel when all its frames were read. frame views
+ * are valid until the next read.
+ *
+ * \note needs CAP_NET_RAW
+ */
+class packet_ring {
+public:
+  /**
+   * \brief ring parameters
+   */
+  struct config {
+    uint32_t _block_size = 1 << 20;   ///< block size (multiple of page size)
+    uint32_t _block_count = 64;       ///< number of blocks
+    uint32_t _frame_size = 2048;      ///< max frame slot size (multiple of 16)
+    uint32_t _block_timeout_ms = 10;  ///< partly filled block is returned after timeout
+  };
+
+  /**
+   * \brief ring statistics (reset on every call)
+   */
+  struct statistics {
+    uint32_t _packets = 0;       ///< received packets (including dropped)
+    uint32_t _drops = 0;         ///< packets dropped because ring was full
+    uint32_t _freeze_count = 0;  ///< times ring was frozen
+  };
+
+  /**
+   * default constructor
+   */
+  packet_ring() = default;
+
+  /**
+   * dtor
+   */
+  ~packet_ring();
+
+  packet_ring(packet_ring const &) = delete;
+  packet_ring &operator=(packet_ring const &) = delete;
+
+  /**
+   * create ring bound to interface
+   *
+   * @param interface interface name (empty for all interfaces)
+   * @param conf ring parameters
+   * @return true if operation succeed (errno is set on failure)
+   */
+  bool open(std::string const &interface, config const &conf) noexcept;
+
+  /**
+   * create ring with default parameters
+   */
+  bool open(std::string const &interface) noexcept {
+    return open(interface, config{});
+  }
+
+  /**
+   * destroy ring
+   */
+  void close() noexcept;
+
+  /**
+   * check if ring is created
+   */
+  bool is_open() const noexcept {
+    return _fd >= 0;
+  }
+
+  /**
+   * get socket descriptor (for external polling)
+   */
+  int get_fd() const noexcept {
+    return _fd;
+  }
+
+  /**
+   * read and classify frames of current block
+   *
+   * previous block is returned to kernel, if it has no unread frames
+   *
+   * @param frames frame views to fill (keys.capacity() elements)
+   * @param keys flow keys to fill
+   * @param timeout_ms max time to wait for filled block (0 - don't wait, -1 - infinite)
+   * @return number of read frames (0 on timeout or error)
+   */
+  size_t read(packet *frames, flow_keys &keys, int timeout_ms) noexcept;
+
+  /**
+   * get and reset kernel counters
+   *
+   * @return true if operation succeed
+   */
+  bool get_statistics(statistics &stats) const noexcept;
+
+private:
+  /**
+   * wait for current block to be filled
+   */
+  bool wait_block(int timeout_ms) noexcept;
+
+  /**
+   * return current block to kernel and move to the next one
+   */
+  void release_block() noexcept;
+
+  int _fd = -1;                        ///< packet socket
+  uint8_t *_map = nullptr;             ///< mapped ring
+  size_t _map_size = 0;                ///< mapped ring size
+  uint32_t _block_size = 0;            ///< block size
+  uint32_t _block_count = 0;           ///< number of blocks
+  uint32_t _block_index = 0;           ///< current block
+  uint8_t const *_frame = nullptr;     ///< next frame of current block (nullptr if block isn't taken)
+  uint32_t _frames_left = 0;           ///< unread frames of current block
+};
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,154 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "address.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * get max prefix length for address version
+ *
+ * @param ver address version
+ * @return 32 for ipv4, 128 for ipv6 and 0 otherwise
+ */
+inline uint8_t max_prefix_length(address::version ver) noexcept {
+  switch (ver) {
+  case address::version::e_v4:
+    return 32;
+  case address::version::e_v6:
+    return 128;
+  default:
+    break;
+  }
+  return 0;
+}
+
+/**
+ * build network mask
+ *
+ * @param ver address version
+ * @param length prefix length (will be truncated to max prefix length)
+ * @return mask (ex. "255.255.0.0" for e_v4 and 16)
+ */
+address make_mask(address::version ver, uint8_t length) noexcept;
+
+/**
+ * \brief network prefix (address + prefix length)
+ *
+ * host bits of address are always cleared
+ */
+class prefix {
+public:
+  /**
+   * default constructor
+   */
+  prefix() = default;
+
+  /**
+   * ctor from address and prefix length
+   *
+   * host bits will be cleared, length will be truncated to max prefix length
+   */
+  prefix(address const &addr, uint8_t length) noexcept;
+
+  /**
+   * ctor from string representation
+   *
+   * ctor from string for example "192.168.0.0/16" or "fe80::/10"
+   */
+  explicit prefix(std::string const &str) noexcept;
+
+  /**
+   * get network address
+   */
+  address const &get_address() const noexcept {
+    return _address;
+  }
+
+  /**
+   * get prefix length
+   */
+  uint8_t get_length() const noexcept {
+    return _length;
+  }
+
+  /**
+   * get address version
+   */
+  address::version get_version() const noexcept {
+    return _address.get_version();
+  }
+
+  /**
+   * check if address belongs to prefix
+   */
+  bool contains(address const &addr) const noexcept {
+    return addr.get_version() == _address.get_version() &&
+           (addr & make_mask(_address.get_version(), _length)) == _address;
+  }
+
+  /**
+   * check if prefix is equal to or more specific than current one
+   */
+  bool contains(prefix const &pref) const noexcept {
+    return pref._length >= _length && contains(pref._address);
+  }
+
+  /**
+   * operator less
+   */
+  bool operator<(prefix const &pref) const noexcept {
+    return _address < pref._address || (!(pref._address < _address) && _length < pref._length);
+  }
+
+  /**
+   * operator equal
+   */
+  bool operator==(prefix const &pref) const noexcept {
+    return _address == pref._address && _length == pref._length;
+  }
+
+  /**
+   * operator not equal
+   */
+  bool operator!=(prefix const &pref) const noexcept {
+    return !(*this == pref);
+  }
+
+  /**
+   * convert prefix to string representation
+   *
+   * @return string (ex. "192.168.0.0/16" or "fe80::/10")
+   */
+  std::string to_string() const;
+
+private:
+  address _address;    ///< network address
+  uint8_t _length = 0; ///< prefix length
+};
+
+/**
+ * build prefix from string representation
+ *
+ * @param str_prefix string filled with prefix (ex. "192.168.0.0/16")
+ * @param pref prefix to fill
+ * @return true if operation succeed
+ */
+bool string_to_prefix(std::string const &str_prefix, prefix &pref) noexcept;
+
+/**
+ * put in ostream string prefix
+ *
+ * @param strm ostream value
+ * @param pref prefix
+ */
+std::ostream &operator<<(std::ostream &strm, prefix const &pref);
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,142 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "full_address.h"
+
+namespace bro::net::proto::ip::proxy {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+enum {
+  e_v1_max_size = 107,  ///< max v1 header size (including "\r\n")
+  e_v2_header_size = 16 ///< v2 fixed header size (signature, version/command, family, length)
+};
+
+/**
+ * header command
+ */
+enum class command : uint8_t {
+  e_local, ///< connection established by proxy itself (health checks), addresses must be ignored
+  e_proxy  ///< proxied connection, addresses are set
+};
+
+/**
+ * transport protocol
+ */
+enum class transport : uint8_t {
+  e_unspec, ///< unknown or unix socket
+  e_stream, ///< tcp
+  e_dgram   ///< udp
+};
+
+/**
+ * parse status
+ */
+enum class status : uint8_t {
+  e_ok,         ///< header parsed
+  e_incomplete, ///< more data needed
+  e_invalid     ///< not a proxy protocol header or malformed header
+};
+
+/**
+ * v2 tlv types (PP2_TYPE_*)
+ */
+enum tlv_type : uint8_t {
+  e_alpn = 0x01,
+  e_authority = 0x02,
+  e_crc32c = 0x03,
+  e_noop = 0x04,
+  e_unique_id = 0x05,
+  e_ssl = 0x20,
+  e_netns = 0x30
+};
+
+/**
+ * \brief v2 type-length-value
+ */
+struct tlv {
+  uint8_t _type = 0;                ///< type
+  uint16_t _length = 0;             ///< value length
+  uint8_t const *_value = nullptr;  ///< value (points to parsed buffer)
+};
+
+/**
+ * \brief parsed or to be serialized header
+ *
+ * tlvs point to the parsed buffer, nothing is copied
+ */
+struct header {
+  uint8_t _version = 2;                  ///< protocol version (1 or 2)
+  command _command = command::e_proxy;   ///< command
+  transport _transport = transport::e_stream; ///< transport
+  full_address _source;                  ///< source address (not set for unknown family)
+  full_address _destination;             ///< destination address (not set for unknown family)
+  uint8_t const *_tlvs = nullptr;        ///< v2 tlvs area
+  size_t _tlvs_size = 0;                 ///< v2 tlvs area size
+  size_t _size = 0;                      ///< header size in parsed buffer
+};
+
+/**
+ * parse v1 or v2 header from the beginning of buffer
+ *
+ * doesn't allocate, on success hdr._size bytes belong to header
+ *
+ * @param data buffer
+ * @param size buffer size
+ * @param hdr header to fill
+ * @return parse status (e_incomplete if buffer is a prefix of valid header)
+ */
+status parse(uint8_t const *data, size_t size, header &hdr) noexcept;
+
+/**
+ * get next tlv of parsed v2 header
+ *
+ * tlvs are validated by parse, so iteration stops only at the end of area
+ *
+ * @param hdr parsed header
+ * @param offset offset in tlvs area (start with 0)
+ * @param value tlv to fill
+ * @return true if tlv was found
+ */
+bool next_tlv(header const &hdr, size_t &offset, tlv &value) noexcept;
+
+/**
+ * find first tlv with type
+ *
+ * @return true if tlv was found
+ */
+bool find_tlv(header const &hdr, uint8_t type, tlv &value) noexcept;
+
+/**
+ * write v1 header ("PROXY TCP4 ...\r\n")
+ *
+ * addresses with different versions or unset addresses are written as "PROXY UNKNOWN\r\n"
+ *
+ * @param hdr header
+ * @param out buffer
+ * @param size buffer size (e_v1_max_size is always enough)
+ * @return written size or 0 if buffer is too small
+ */
+size_t serialize_v1(header const &hdr, uint8_t *out, size_t size) noexcept;
+
+/**
+ * write v2 header
+ *
+ * local command and addresses with different versions are written with
+ * unspecified family
+ *
+ * @param hdr header (_tlvs are ignored)
+ * @param tlvs tlvs to append
+ * @param tlvs_count number of tlvs
+ * @param out buffer
+ * @param size buffer size
+ * @return written size or 0 if buffer is too small
+ */
+size_t serialize_v2(header const &hdr, tlv const *tlvs, size_t tlvs_count, uint8_t *out, size_t size) noexcept;
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip::proxy
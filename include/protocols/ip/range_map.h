@@ -0,0 +1,313 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+#include "aggregate.h"
+#include "numeric.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * choice of value for addresses covered by several ranges
+ */
+enum class range_policy : uint8_t {
+  e_first,    ///< range added first
+  e_last,     ///< range added last
+  e_narrowest ///< the smallest range (the last one of equal size)
+};
+
+/**
+ * \brief address range with value
+ */
+template <typename T> struct range_entry {
+  address _first; ///< first address
+  address _last;  ///< last address
+  T _value;       ///< value
+};
+
+/**
+ * \brief immutable map from address ranges to values
+ *
+ * overlapping ranges are split and resolved by policy, adjacent parts with
+ * equal values are merged, so every address has at most one value. ipv4 and
+ * ipv6 ranges are kept in separate sections of numeric keys. range starts
+ * are stored in eytzinger (breadth first) order: lookup is branch free
+ * binary search whose next levels share cache lines, so it is
+ * O(log n) with few cache misses even for maps larger than cache.
+ *
+ * @tparam T value type (copyable and equality comparable)
+ */
+template <typename T> class range_map {
+public:
+  /**
+   * default constructor (empty map)
+   */
+  range_map() = default;
+
+  /**
+   * build map
+   *
+   * \note ranges with bounds of different versions, unset bounds or first > last are ignored
+   *
+   * @param entries ranges in any order (order matters for policy only)
+   * @param policy overlap policy
+   */
+  explicit range_map(std::vector<range_entry<T>> const &entries, range_policy policy = range_policy::e_last) {
+    std::vector<input<uint32_t>> v4_ranges;
+    std::vector<input<uint128_t>> v6_ranges;
+    for (size_t i = 0; i < entries.size(); ++i) {
+      auto const &entry = entries[i];
+      if (entry._first.get_version() != entry._last.get_version())
+        continue;
+      if (entry._first.is_ipv4()) {
+        uint32_t const first = to_number(entry._first.to_v4()), last = to_number(entry._last.to_v4());
+        if (first <= last)
+          v4_ranges.push_back({first, last, i});
+      } else if (entry._first.is_ipv6()) {
+        uint128_t const first = to_number(entry._first.to_v6()), last = to_number(entry._last.to_v6());
+        if (first <= last)
+          v6_ranges.push_back({first, last, i});
+      }
+    }
+    _v4.build(v4_ranges, entries, policy);
+    _v6.build(v6_ranges, entries, policy);
+  }
+
+  /**
+   * find value of address
+   *
+   * @return value or nullptr if address isn't covered
+   */
+  T const *find(address const &addr) const noexcept {
+    if (addr.is_ipv4())
+      return _v4.find(to_number(addr.to_v4()));
+    if (addr.is_ipv6())
+      return _v6.find(to_number(addr.to_v6()));
+    return nullptr;
+  }
+
+  /**
+   * find value and range of address
+   *
+   * @param addr address
+   * @param range resolved range containing address
+   * @return value or nullptr if address isn't covered
+   */
+  T const *find(address const &addr, address_range &range) const noexcept {
+    if (addr.is_ipv4()) {
+      uint32_t first = 0, last = 0;
+      T const *value = _v4.find(to_number(addr.to_v4()), first, last);
+      if (value)
+        range = {address(to_v4_address(first)), address(to_v4_address(last))};
+      return value;
+    }
+    if (addr.is_ipv6()) {
+      uint128_t first = 0, last = 0;
+      T const *value = _v6.find(to_number(addr.to_v6()), first, last);
+      if (value)
+        range = {address(to_v6_address(first)), address(to_v6_address(last))};
+      return value;
+    }
+    return nullptr;
+  }
+
+  /**
+   * get number of resolved ranges
+   */
+  size_t size() const noexcept {
+    return _v4.size() + _v6.size();
+  }
+
+  /**
+   * check if map is empty
+   */
+  bool empty() const noexcept {
+    return !size();
+  }
+
+  /**
+   * get resolved ranges
+   *
+   * @return disjoint ranges, ipv4 ranges followed by ipv6 ranges in ascending order
+   */
+  std::vector<range_entry<T>> get_entries() const {
+    std::vector<range_entry<T>> res;
+    res.reserve(size());
+    _v4.get_entries(res, [](uint32_t value) { return address(to_v4_address(value)); });
+    _v6.get_entries(res, [](uint128_t value) { return address(to_v6_address(value)); });
+    return res;
+  }
+
+private:
+  /**
+   * \brief valid input range
+   */
+  template <typename K> struct input {
+    K _first;      ///< first key
+    K _last;       ///< last key
+    size_t _index; ///< entry index
+  };
+
+  /**
+   * \brief ranges of one address family
+   *
+   * @tparam K numeric key
+   */
+  template <typename K> class section {
+  public:
+    /**
+     * split, resolve and merge ranges
+     */
+    void build(std::vector<input<K>> &ranges, std::vector<range_entry<T>> const &entries, range_policy policy) {
+      std::sort(ranges.begin(), ranges.end(), [](auto const &lhs, auto const &rhs) { return lhs._first < rhs._first; });
+      // every segment between boundaries is covered by the same ranges
+      std::vector<K> bounds;
+      bounds.reserve(ranges.size() * 2);
+      for (auto const &range : ranges) {
+        bounds.push_back(range._first);
+        if (range._last != K(~K(0)))
+          bounds.push_back(range._last + 1);
+      }
+      std::sort(bounds.begin(), bounds.end());
+      bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+      // the best covering range on top, ended ranges are removed when they reach top
+      auto const worse = [&ranges, policy](size_t lhs, size_t rhs) {
+        auto const &l = ranges[lhs], &r = ranges[rhs];
+        switch (policy) {
+        case range_policy::e_first:
+          return l._index > r._index;
+        case range_policy::e_narrowest:
+          if (l._last - l._first != r._last - r._first)
+            return l._last - l._first > r._last - r._first;
+          break;
+        default:
+          break;
+        }
+        return l._index < r._index;
+      };
+      std::priority_queue<size_t, std::vector<size_t>, decltype(worse)> active(worse);
+
+      std::vector<K> firsts, lasts;
+      std::vector<size_t> indexes;
+      size_t next = 0;
+      for (size_t i = 0; i < bounds.size(); ++i) {
+        K const first = bounds[i];
+        K const last = i + 1 < bounds.size() ? bounds[i + 1] - 1 : K(~K(0));
+        for (; next < ranges.size() && ranges[next]._first == first; ++next)
+          active.push(next);
+        while (!active.empty() && ranges[active.top()]._last < first)
+          active.pop();
+        if (active.empty())
+          continue;
+        size_t const index = ranges[active.top()]._index;
+        if (!firsts.empty() && lasts.back() + 1 == first &&
+            (indexes.back() == index || entries[indexes.back()]._value == entries[index]._value)) {
+          lasts.back() = last;
+          continue;
+        }
+        firsts.push_back(first);
+        lasts.push_back(last);
+        indexes.push_back(index);
+      }
+
+      // slot 0 is unused, children of slot k are 2k and 2k + 1
+      _size = firsts.size();
+      _firsts.assign(_size + 1, K(0));
+      _lasts.assign(_size + 1, K(0));
+      _values.clear();
+      if (_size)
+        _values.assign(_size + 1, entries[indexes[0]]._value);
+      size_t sorted = 0;
+      fill(1, sorted, firsts, lasts, indexes, entries);
+    }
+
+    /**
+     * find value of key
+     */
+    T const *find(K key) const noexcept {
+      K first, last;
+      return find(key, first, last);
+    }
+
+    /**
+     * find value and range of key
+     */
+    T const *find(K key, K &first, K &last) const noexcept {
+      // descendants few levels below share one cache line, it is loaded ahead
+      size_t k = 1;
+      while (k <= _size) {
+        __builtin_prefetch(_firsts.data() + std::min(k * e_prefetch_step, _size));
+        k = 2 * k + (_firsts[k] <= key);
+      }
+      // the last node where search went right holds predecessor of key
+      k >>= __builtin_ffsll(static_cast<long long>(k));
+      if (!k || key > _lasts[k])
+        return nullptr;
+      first = _firsts[k];
+      last = _lasts[k];
+      return &_values[k];
+    }
+
+    /**
+     * get number of ranges
+     */
+    size_t size() const noexcept {
+      return _size;
+    }
+
+    /**
+     * append ranges in ascending order
+     */
+    template <typename C> void get_entries(std::vector<range_entry<T>> &res, C const &convert) const {
+      get_entries(1, res, convert);
+    }
+
+  private:
+    enum : size_t {
+      e_prefetch_step = 64 / sizeof(K) ///< descendants in one cache line
+    };
+
+    /**
+     * fill subtree of slot k by in-order traversal
+     */
+    void fill(size_t k, size_t &sorted, std::vector<K> const &firsts, std::vector<K> const &lasts,
+              std::vector<size_t> const &indexes, std::vector<range_entry<T>> const &entries) {
+      if (k > _size)
+        return;
+      fill(2 * k, sorted, firsts, lasts, indexes, entries);
+      _firsts[k] = firsts[sorted];
+      _lasts[k] = lasts[sorted];
+      _values[k] = entries[indexes[sorted]]._value;
+      ++sorted;
+      fill(2 * k + 1, sorted, firsts, lasts, indexes, entries);
+    }
+
+    template <typename C> void get_entries(size_t k, std::vector<range_entry<T>> &res, C const &convert) const {
+      if (k > _size)
+        return;
+      get_entries(2 * k, res, convert);
+      res.push_back({convert(_firsts[k]), convert(_lasts[k]), _values[k]});
+      get_entries(2 * k + 1, res, convert);
+    }
+
+    std::vector<K> _firsts; ///< range starts (eytzinger order)
+    std::vector<K> _lasts;  ///< range ends (eytzinger order)
+    std::vector<T> _values; ///< values (eytzinger order)
+    size_t _size = 0;       ///< number of ranges
+  };
+
+  section<uint32_t> _v4;  ///< ipv4 ranges
+  section<uint128_t> _v6; ///< ipv6 ranges
+};
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
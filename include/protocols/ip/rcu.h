@@ -0,0 +1,148 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * \brief read-copy-update pointer to immutable value
+ *
+ * readers are wait-free (one counter increment and one load), writers
+ * publish new value and wait until all readers of previous one are gone.
+ * classic two phase grace period: every reader registers in counter of
+ * current phase, writer flips phase twice and drains both counters.
+ */
+template <typename T> class rcu_ptr {
+public:
+  /**
+   * \brief read side critical section
+   *
+   * value stays alive while guard exists
+   */
+  class guard {
+  public:
+    guard(guard const &) = delete;
+    guard &operator=(guard const &) = delete;
+
+    /**
+     * move ctor
+     */
+    guard(guard &&g) noexcept
+      : _owner(g._owner)
+      , _phase(g._phase)
+      , _value(g._value) {
+      g._owner = nullptr;
+    }
+
+    /**
+     * dtor
+     */
+    ~guard() {
+      if (_owner)
+        _owner->_readers[_phase]._count.fetch_sub(1, std::memory_order_release);
+    }
+
+    /**
+     * get value (can be nullptr)
+     */
+    T const *get() const noexcept {
+      return _value;
+    }
+
+    T const *operator->() const noexcept {
+      return _value;
+    }
+
+    T const &operator*() const noexcept {
+      return *_value;
+    }
+
+    explicit operator bool() const noexcept {
+      return _value != nullptr;
+    }
+
+  private:
+    friend class rcu_ptr;
+    guard(rcu_ptr const *owner, unsigned phase, T const *value) noexcept
+      : _owner(owner)
+      , _phase(phase)
+      , _value(value) {}
+
+    rcu_ptr const *_owner; ///< pointer owner
+    unsigned _phase;       ///< reader phase
+    T const *_value;       ///< protected value
+  };
+
+  /**
+   * ctor
+   *
+   * @param value initial value
+   */
+  explicit rcu_ptr(std::unique_ptr<T const> value = {}) noexcept
+    : _value(value.release()) {}
+
+  rcu_ptr(rcu_ptr const &) = delete;
+  rcu_ptr &operator=(rcu_ptr const &) = delete;
+
+  /**
+   * dtor
+   *
+   * \note there must be no alive guards
+   */
+  ~rcu_ptr() {
+    delete _value.load(std::memory_order_acquire);
+  }
+
+  /**
+   * get current value
+   */
+  guard read() const noexcept {
+    unsigned const phase = _phase.load(std::memory_order_acquire) & 1;
+    _readers[phase]._count.fetch_add(1, std::memory_order_seq_cst);
+    return guard(this, phase, _value.load(std::memory_order_seq_cst));
+  }
+
+  /**
+   * publish new value and destroy previous one when it's no longer used
+   *
+   * \note must not be called while current thread holds guard
+   */
+  void update(std::unique_ptr<T const> value) {
+    std::lock_guard<std::mutex> lock(_update_mutex);
+    T const *prev = _value.exchange(value.release(), std::memory_order_seq_cst);
+    synchronize();
+    delete prev;
+  }
+
+private:
+  void synchronize() const noexcept {
+    for (int i = 0; i < 2; ++i) {
+      unsigned const prev = _phase.fetch_add(1, std::memory_order_seq_cst) & 1;
+      // store-load pairing with reader's increment and value load, acquire isn't enough
+      while (_readers[prev]._count.load(std::memory_order_seq_cst))
+        std::this_thread::yield();
+    }
+  }
+
+  /**
+   * \brief readers counter on own cache line
+   */
+  struct alignas(64) counter {
+    mutable std::atomic<size_t> _count{0}; ///< number of readers
+  };
+
+  counter _readers[2];                     ///< readers per phase
+  mutable std::atomic<unsigned> _phase{0}; ///< current phase
+  std::atomic<T const *> _value;           ///< current value
+  std::mutex _update_mutex;                ///< serializes writers
+};
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,324 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#ifdef __cpp_impl_coroutine
+#include <coroutine>
+#endif
+
+#include "full_address.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * name resolution error
+ */
+enum class resolve_error : uint8_t {
+  e_ok,             ///< addresses are found
+  e_not_found,      ///< name doesn't exist or has no addresses
+  e_timeout,        ///< no server answered
+  e_server_failure, ///< servers refused or failed to answer
+  e_invalid_name    ///< name is not a valid domain name
+};
+
+/**
+ * \brief name resolution result
+ */
+struct resolve_result {
+  resolve_error _error = resolve_error::e_ok; ///< error
+  std::vector<address> _addresses;            ///< ipv4 and ipv6 addresses
+
+  /**
+   * check if resolution succeed
+   */
+  explicit operator bool() const noexcept {
+    return _error == resolve_error::e_ok;
+  }
+};
+
+/**
+ * make endpoints from resolved addresses
+ */
+std::vector<full_address> make_endpoints(std::vector<address> const &addrs, uint16_t port);
+
+/**
+ * \brief static name table (/etc/hosts)
+ *
+ * names are case insensitive, addresses keep file order
+ */
+class hosts_table {
+public:
+  /**
+   * load file
+   *
+   * @return false if file can't be read
+   */
+  bool load(std::string const &path);
+
+  /**
+   * add entries of hosts file content (invalid lines are skipped)
+   */
+  void parse(std::string_view content);
+
+  /**
+   * find addresses of name
+   *
+   * @return addresses or nullptr if name isn't in table
+   */
+  std::vector<address> const *find(std::string_view name) const;
+
+  /**
+   * get number of names
+   */
+  size_t size() const noexcept {
+    return _names.size();
+  }
+
+private:
+  std::unordered_map<std::string, std::vector<address>> _names; ///< lower case name to addresses
+};
+
+/**
+ * get name servers from resolv.conf content
+ *
+ * @param content resolv.conf content
+ * @param servers servers to append (port 53)
+ */
+void parse_resolv_conf(std::string_view content, std::vector<full_address> &servers);
+
+/**
+ * \brief asynchronous stub resolver
+ *
+ * literal addresses and names from hosts table are resolved at once,
+ * other names are looked up in cache and then queried (A and AAAA) over
+ * udp. resolver doesn't create threads: owner polls get_fd() and calls
+ * process(), or calls run_once(). callbacks are called from resolve() (no
+ * query needed) or from process().
+ *
+ * with C++20 coroutines names can be awaited: co_await res.async_resolve(name)
+ */
+class resolver {
+public:
+  using clock = std::chrono::steady_clock;
+  using callback = std::function<void(resolve_result const &)>;
+
+  /**
+   * \brief resolver parameters
+   */
+  struct config {
+    std::vector<full_address> _servers;              ///< servers (from /etc/resolv.conf if empty)
+    std::string _hosts_path = "/etc/hosts";          ///< hosts file (empty - don't use)
+    std::chrono::milliseconds _timeout{2000};        ///< timeout of one attempt
+    uint32_t _attempts = 2;                          ///< attempts per server
+    uint32_t _max_ttl = 3600;                        ///< max cache time (seconds)
+    size_t _max_cache = 4096;                        ///< max number of cached names
+  };
+
+  /**
+   * default constructor
+   */
+  resolver() = default;
+
+  /**
+   * dtor (pending callbacks aren't called)
+   */
+  ~resolver();
+
+  resolver(resolver const &) = delete;
+  resolver &operator=(resolver const &) = delete;
+
+  /**
+   * create socket and load hosts table
+   *
+   * @return false if socket can't be created or there are no servers
+   */
+  bool open(config const &conf);
+
+  /**
+   * close socket and drop pending queries
+   */
+  void close() noexcept;
+
+  /**
+   * get socket descriptor (for external polling)
+   */
+  int get_fd() const noexcept {
+    return _fd;
+  }
+
+  /**
+   * get hosts table
+   */
+  hosts_table &get_hosts() noexcept {
+    return _hosts;
+  }
+
+  /**
+   * resolve name
+   *
+   * lookups of the same name are merged into one query
+   *
+   * @param name domain name or literal address
+   * @param cb result callback
+   */
+  void resolve(std::string_view name, callback cb);
+
+  /**
+   * read answers and handle timeouts
+   *
+   * @return number of finished lookups
+   */
+  size_t process();
+
+  /**
+   * get time until next timeout
+   *
+   * @return timeout in milliseconds or -1 if there are no queries
+   */
+  int get_timeout_ms() const noexcept;
+
+  /**
+   * wait for answers or next timeout (at most timeout_ms) and process them
+   *
+   * @return number of finished lookups
+   */
+  size_t run_once(int timeout_ms);
+
+  /**
+   * get number of cached names
+   */
+  size_t get_cache_size() const noexcept {
+    return _cache.size();
+  }
+
+  /**
+   * get number of unfinished lookups
+   */
+  size_t get_pending() const noexcept {
+    return _queries.size();
+  }
+
+#ifdef __cpp_impl_coroutine
+  /**
+   * \brief awaitable lookup
+   */
+  class awaiter {
+  public:
+    awaiter(resolver &res, std::string_view name)
+      : _resolver(res)
+      , _name(name) {}
+
+    bool await_ready() const noexcept {
+      return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+      _handle = handle;
+      _resolver.resolve(_name, [this](resolve_result const &result) {
+        _result = result;
+        if (_suspended)
+          _handle.resume();
+        else
+          _done = true;
+      });
+      _suspended = !_done;
+      return _suspended;
+    }
+
+    resolve_result await_resume() {
+      return std::move(_result);
+    }
+
+  private:
+    resolver &_resolver;             ///< resolver
+    std::string _name;               ///< name
+    resolve_result _result;          ///< result
+    std::coroutine_handle<> _handle; ///< awaiting coroutine
+    bool _done = false;              ///< result is ready before suspension
+    bool _suspended = false;         ///< coroutine is suspended
+  };
+
+  /**
+   * resolve name in coroutine (resumed from resolve or process)
+   */
+  awaiter async_resolve(std::string_view name) {
+    return awaiter(*this, name);
+  }
+#endif // __cpp_impl_coroutine
+
+private:
+  /**
+   * \brief lookup in progress
+   */
+  struct query {
+    std::string _name;                   ///< lower case name
+    uint16_t _ids[2] = {0, 0};           ///< A and AAAA query ids
+    bool _answered[2] = {false, false};  ///< A and AAAA answers are received
+    bool _failed = false;                ///< some server failed
+    bool _truncated = false;             ///< some answer was truncated (not cached)
+    std::vector<address> _addresses;     ///< received addresses
+    uint32_t _ttl = UINT32_MAX;          ///< min ttl of answers
+    size_t _attempt = 0;                 ///< attempt number (server is attempt % servers)
+    clock::time_point _deadline;         ///< attempt deadline
+    std::vector<callback> _callbacks;    ///< waiting callbacks
+  };
+
+  /**
+   * \brief cached answer
+   */
+  struct cache_entry {
+    std::vector<address> _addresses; ///< addresses
+    clock::time_point _expiration;   ///< expiration time
+  };
+
+  /**
+   * send queries without answers to current server
+   */
+  void send(query &q) noexcept;
+
+  /**
+   * handle received datagram
+   */
+  void receive(uint8_t const *data, size_t size, full_address const &from);
+
+  /**
+   * move finished query to done list
+   */
+  void finish(std::list<query>::iterator it, resolve_error error);
+
+  /**
+   * drop expired cache entries
+   */
+  void evict(clock::time_point now);
+
+  /**
+   * call callbacks of finished lookups
+   */
+  size_t complete();
+
+  int _fd = -1;                                                ///< udp socket (dual stack)
+  config _config;                                              ///< parameters
+  hosts_table _hosts;                                          ///< hosts table
+  std::list<query> _queries;                                   ///< lookups in progress
+  std::unordered_map<uint16_t, std::list<query>::iterator> _ids; ///< query id to lookup
+  std::unordered_map<std::string, cache_entry> _cache;         ///< cached answers
+  std::vector<std::pair<std::vector<callback>, resolve_result>> _done; ///< finished lookups
+  clock::time_point _next_eviction;                            ///< next sweep of expired cache entries
+  std::mt19937 _random;                                        ///< query id generator
+  bool _dual_stack = true;                                     ///< socket is ipv6 with mapped ipv4
+};
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
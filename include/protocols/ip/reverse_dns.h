@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "address.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+enum {
+  e_max_v4_ptr_name = 28, ///< max in-addr.arpa name length ("255.255.255.255.in-addr.arpa")
+  e_v6_ptr_name = 72,     ///< ip6.arpa name length (32 nibbles with dots + "ip6.arpa")
+  e_max_ptr_name = e_v6_ptr_name
+};
+
+/**
+ * write reverse dns name for address
+ *
+ * @param out buffer with at least e_max_v4_ptr_name bytes
+ * @param addr address
+ * @return pointer past the last written character (ex. "1.0.168.192.in-addr.arpa")
+ */
+char *to_ptr_name(char *out, v4::address const &addr) noexcept;
+
+/**
+ * write reverse dns name for address
+ *
+ * @param out buffer with at least e_v6_ptr_name bytes
+ * @param addr address
+ * @return pointer past the last written character (ex. "1.0.0.0 ... 8.e.f.ip6.arpa")
+ */
+char *to_ptr_name(char *out, v6::address const &addr) noexcept;
+
+/**
+ * write reverse dns name for address
+ *
+ * @param out buffer with at least e_max_ptr_name bytes
+ * @param addr address
+ * @return pointer past the last written character (nothing is written for unset address)
+ */
+char *to_ptr_name(char *out, address const &addr) noexcept;
+
+/**
+ * write reverse dns names for batch of addresses
+ *
+ * @param addrs addresses
+ * @param size number of addresses
+ * @param out buffer with size * e_max_ptr_name bytes, name i starts at i * e_max_ptr_name
+ * @param lengths name lengths (size elements)
+ */
+void to_ptr_names(address const *addrs, size_t size, char *out, size_t *lengths) noexcept;
+
+/**
+ * get reverse dns name for address
+ *
+ * @return name (ex. "1.0.168.192.in-addr.arpa")
+ */
+std::string to_ptr_name(address const &addr);
+
+/**
+ * parse reverse dns name
+ *
+ * name is case insensitive and can end with dot
+ *
+ * @param name in-addr.arpa or ip6.arpa name
+ * @param addr address to fill
+ * @return true if operation succeed
+ */
+bool from_ptr_name(std::string_view name, address &addr) noexcept;
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
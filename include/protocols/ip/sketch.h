@@ -0,0 +1,305 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "address.h"
+#include "hash.h"
+#include "prefix.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * \brief count-min sketch over ip addresses
+ *
+ * estimate never underestimates real count. with width w and depth d
+ * overestimate is at most 2 * total / w with probability 1 - 1 / 2^d.
+ * sketch isn't thread safe - use one sketch per thread and merge them.
+ */
+class count_min_sketch {
+public:
+  /**
+   * ctor
+   *
+   * @param width counters per row (will be rounded up to power of two)
+   * @param depth number of rows
+   * @param seed hash seed (sketches can be merged only with the same seed)
+   */
+  count_min_sketch(size_t width, size_t depth, uint64_t seed = 0);
+
+  /**
+   * add address to sketch
+   *
+   * @param addr address
+   * @param count number of occurrences
+   */
+  void add(address const &addr, uint64_t count = 1) noexcept;
+
+  /**
+   * get estimated count for address
+   */
+  uint64_t estimate(address const &addr) const noexcept;
+
+  /**
+   * merge other sketch into current one
+   *
+   * @return false if sketches have different dimensions or seed
+   */
+  bool merge(count_min_sketch const &sketch) noexcept;
+
+  /**
+   * reset all counters
+   */
+  void clear() noexcept;
+
+  /**
+   * get sum of all added counts
+   */
+  uint64_t get_total() const noexcept {
+    return _total;
+  }
+
+  /**
+   * get counters per row
+   */
+  size_t get_width() const noexcept {
+    return _mask + 1;
+  }
+
+  /**
+   * get number of rows
+   */
+  size_t get_depth() const noexcept {
+    return _depth;
+  }
+
+private:
+  std::vector<uint64_t> _counters; ///< depth * width counters
+  size_t _mask = 0;                ///< width - 1
+  size_t _depth = 0;               ///< number of rows
+  uint64_t _seed = 0;              ///< hash seed
+  uint64_t _total = 0;             ///< sum of all counts
+};
+
+/**
+ * \brief space-saving heavy hitters
+ *
+ * keeps at most capacity counters. for every tracked address
+ * count - error <= real count <= count. every address with real count
+ * greater than total / capacity is guaranteed to be tracked.
+ */
+class space_saving {
+public:
+  /**
+   * \brief tracked address
+   */
+  struct entry {
+    address _address;    ///< address
+    uint64_t _count = 0; ///< estimated count (upper bound)
+    uint64_t _error = 0; ///< max overestimation
+  };
+
+  /**
+   * ctor
+   *
+   * @param capacity max number of tracked addresses
+   */
+  explicit space_saving(size_t capacity);
+
+  /**
+   * add address
+   *
+   * @param addr address
+   * @param count number of occurrences
+   */
+  void add(address const &addr, uint64_t count = 1);
+
+  /**
+   * get estimated count for address (0 if address isn't tracked)
+   */
+  uint64_t estimate(address const &addr) const noexcept;
+
+  /**
+   * merge other summary into current one
+   */
+  void merge(space_saving const &summary);
+
+  /**
+   * get tracked addresses sorted by count in descending order
+   *
+   * @param limit max number of returned entries
+   */
+  std::vector<entry> top(size_t limit) const;
+
+  /**
+   * get tracked addresses which count is at least threshold
+   */
+  std::vector<entry> above(uint64_t threshold) const;
+
+  /**
+   * reset summary
+   */
+  void clear() noexcept;
+
+  /**
+   * get sum of all added counts
+   */
+  uint64_t get_total() const noexcept {
+    return _total;
+  }
+
+  /**
+   * get max number of tracked addresses
+   */
+  size_t get_capacity() const noexcept {
+    return _capacity;
+  }
+
+  /**
+   * get number of tracked addresses
+   */
+  size_t size() const noexcept {
+    return _entries.size();
+  }
+
+private:
+  uint64_t min_count() const noexcept;
+  void sift_down(size_t pos) noexcept;
+  void sift_up(size_t pos) noexcept;
+  void swap_entries(size_t l, size_t r) noexcept;
+  void rebuild();
+
+  std::vector<entry> _entries;                 ///< min-heap ordered by count
+  std::unordered_map<address, size_t> _index; ///< address -> position in heap
+  size_t _capacity = 0;                        ///< max number of tracked addresses
+  uint64_t _total = 0;                         ///< sum of all counts
+};
+
+/**
+ * \brief hyperloglog distinct counter
+ *
+ * relative error is about 1.04 / sqrt(2^precision)
+ */
+class hyperloglog {
+public:
+  /**
+   * ctor
+   *
+   * @param precision number of index bits (4 - 18)
+   * @param seed hash seed (counters can be merged only with the same seed)
+   */
+  explicit hyperloglog(uint8_t precision = 14, uint64_t seed = 0);
+
+  /**
+   * add address
+   */
+  void add(address const &addr) noexcept;
+
+  /**
+   * get estimated number of distinct addresses
+   */
+  uint64_t estimate() const noexcept;
+
+  /**
+   * merge other counter into current one
+   *
+   * @return false if counters have different precision or seed
+   */
+  bool merge(hyperloglog const &counter) noexcept;
+
+  /**
+   * reset counter
+   */
+  void clear() noexcept;
+
+  /**
+   * get precision
+   */
+  uint8_t get_precision() const noexcept {
+    return _precision;
+  }
+
+private:
+  std::vector<uint8_t> _registers; ///< 2^precision registers
+  uint8_t _precision = 0;          ///< number of index bits
+  uint64_t _seed = 0;              ///< hash seed
+};
+
+/**
+ * \brief hierarchical heavy hitters along prefix lengths
+ *
+ * every prefix level has own space-saving summary. reported counts are
+ * discounted - traffic already reported by more specific prefix isn't
+ * counted again for less specific one.
+ */
+class hierarchical_heavy_hitters {
+public:
+  /**
+   * \brief reported prefix
+   */
+  struct entry {
+    prefix _prefix;      ///< prefix
+    uint64_t _count = 0; ///< discounted count
+  };
+
+  /**
+   * ctor
+   *
+   * @param capacity max number of tracked prefixes per level
+   * @param v4_lengths ipv4 prefix lengths to track
+   * @param v6_lengths ipv6 prefix lengths to track
+   */
+  hierarchical_heavy_hitters(size_t capacity,
+                             std::vector<uint8_t> v4_lengths = {32, 24, 16, 8},
+                             std::vector<uint8_t> v6_lengths = {128, 64, 48, 32});
+
+  /**
+   * add address
+   *
+   * @param addr address
+   * @param count number of occurrences
+   */
+  void add(address const &addr, uint64_t count = 1);
+
+  /**
+   * merge other summary into current one
+   *
+   * @return false if summaries track different prefix lengths
+   */
+  bool merge(hierarchical_heavy_hitters const &summary);
+
+  /**
+   * get prefixes which discounted count is at least threshold
+   *
+   * @return prefixes from the most specific to the least specific
+   */
+  std::vector<entry> query(uint64_t threshold) const;
+
+  /**
+   * reset summary
+   */
+  void clear() noexcept;
+
+private:
+  /**
+   * \brief one prefix level
+   */
+  struct level {
+    address _mask;           ///< level mask
+    uint8_t _length = 0;     ///< prefix length
+    space_saving _summary;   ///< level summary
+  };
+
+  static std::vector<level> make_levels(size_t capacity, address::version ver, std::vector<uint8_t> lengths);
+
+  std::vector<level> _v4; ///< ipv4 levels from the most specific
+  std::vector<level> _v6; ///< ipv6 levels from the most specific
+};
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,156 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "address.h"
+#include "full_address.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * \brief compare addresses in network byte order
+ *
+ * ip addresses are ordered by version first (ipv4 < ipv6 < none), full
+ * addresses by address and then by port
+ */
+struct network_order_less {
+  bool operator()(v4::address const &l, v4::address const &r) const noexcept {
+    return __builtin_bswap32(l.get_data()) < __builtin_bswap32(r.get_data());
+  }
+
+  bool operator()(v6::address const &l, v6::address const &r) const noexcept {
+    return memcmp(l.get_data(), r.get_data(), v6::address::e_bytes_size) < 0;
+  }
+
+  bool operator()(address const &l, address const &r) const noexcept {
+    if (l.get_version() != r.get_version())
+      return l.get_version() < r.get_version();
+    return memcmp(l.get_data(), r.get_data(), v6::address::e_bytes_size) < 0;
+  }
+
+  bool operator()(full_address const &l, full_address const &r) const noexcept {
+    if (l.get_address() != r.get_address())
+      return (*this)(l.get_address(), r.get_address());
+    return l.get_port() < r.get_port();
+  }
+};
+
+/**
+ * sort addresses in network byte order (radix sort)
+ *
+ * @param addrs addresses
+ * @param size number of addresses
+ * @param threads number of threads (0 - use all cores)
+ */
+void sort(v4::address *addrs, size_t size, size_t threads = 1);
+
+/**
+ * sort addresses in network byte order (radix sort)
+ *
+ * @param addrs addresses
+ * @param size number of addresses
+ * @param threads number of threads (0 - use all cores)
+ */
+void sort(v6::address *addrs, size_t size, size_t threads = 1);
+
+/**
+ * sort addresses by version and then in network byte order (radix sort)
+ *
+ * @param addrs addresses
+ * @param size number of addresses
+ * @param threads number of threads (0 - use all cores)
+ */
+void sort(address *addrs, size_t size, size_t threads = 1);
+
+/**
+ * sort full addresses by address and then by port (radix sort)
+ *
+ * @param addrs addresses
+ * @param size number of addresses
+ * @param threads number of threads (0 - use all cores)
+ */
+void sort(full_address *addrs, size_t size, size_t threads = 1);
+
+/**
+ * sort addresses (radix sort)
+ *
+ * @param addrs addresses
+ * @param threads number of threads (0 - use all cores)
+ */
+template <typename T> void sort(std::vector<T> &addrs, size_t threads = 1) {
+  sort(addrs.data(), addrs.size(), threads);
+}
+
+/**
+ * remove duplicates from sorted addresses
+ *
+ * @param addrs sorted addresses
+ * @param size number of addresses
+ * @return number of unique addresses (they are moved to the beginning)
+ */
+template <typename T> size_t unique(T *addrs, size_t size) noexcept {
+  if (!size)
+    return 0;
+  size_t res = 1;
+  for (size_t i = 1; i < size; ++i) {
+    if (addrs[i] != addrs[res - 1])
+      addrs[res++] = addrs[i];
+  }
+  return res;
+}
+
+/**
+ * remove duplicates from sorted addresses and count them
+ *
+ * @param addrs sorted addresses
+ * @param size number of addresses
+ * @param counts number of occurrences of every unique address (size elements)
+ * @return number of unique addresses (they are moved to the beginning)
+ */
+template <typename T> size_t unique_count(T *addrs, size_t size, size_t *counts) noexcept {
+  if (!size)
+    return 0;
+  size_t res = 1;
+  counts[0] = 1;
+  for (size_t i = 1; i < size; ++i) {
+    if (addrs[i] != addrs[res - 1]) {
+      counts[res] = 1;
+      addrs[res++] = addrs[i];
+    } else {
+      ++counts[res - 1];
+    }
+  }
+  return res;
+}
+
+/**
+ * remove duplicates from sorted addresses
+ *
+ * @param addrs sorted addresses
+ */
+template <typename T> void unique(std::vector<T> &addrs) {
+  addrs.resize(unique(addrs.data(), addrs.size()));
+}
+
+/**
+ * remove duplicates from sorted addresses and count them
+ *
+ * @param addrs sorted addresses
+ * @return number of occurrences of every unique address
+ */
+template <typename T> std::vector<size_t> unique_count(std::vector<T> &addrs) {
+  std::vector<size_t> counts(addrs.size());
+  addrs.resize(unique_count(addrs.data(), addrs.size(), counts.data()));
+  counts.resize(addrs.size());
+  return counts;
+}
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,135 @@
+#pragma once
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+namespace bro::net::proto::ip::stats {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * timed operations
+ */
+enum class operation : uint8_t {
+  e_parse,    ///< string to address
+  e_format,   ///< address to string
+  e_native,   ///< conversion to native (sockaddr) structures
+  e_scope_id, ///< scope id resolution
+  e_size      ///< number of operations
+};
+
+/**
+ * event counters
+ */
+enum class counter : uint8_t {
+  e_parse_failed,   ///< string wasn't an address
+  e_string_alloc,   ///< std::string returned by format functions
+  e_scope_id_miss,  ///< address not found on local interfaces
+  e_size            ///< number of counters
+};
+
+enum {
+  e_histogram_buckets = 32 ///< bucket i counts latencies in [2^(i-1), 2^i) ticks
+};
+
+/**
+ * \brief statistics of one operation
+ */
+struct operation_stats {
+  uint64_t _count = 0;                             ///< number of calls
+  uint64_t _ticks = 0;                             ///< total latency
+  uint64_t _histogram[e_histogram_buckets] = {0}; ///< latency histogram
+};
+
+/**
+ * \brief statistics of all threads
+ */
+struct snapshot {
+  operation_stats _operations[static_cast<size_t>(operation::e_size)]; ///< operations
+  uint64_t _counters[static_cast<size_t>(counter::e_size)] = {0};      ///< counters
+  double _ticks_per_ns = 1;                                            ///< tick rate
+};
+
+/**
+ * check if library was built with statistics
+ */
+constexpr bool enabled() noexcept {
+#ifdef NETWORK_PROTOCOLS_STATS
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * get current time in ticks (tsc if available)
+ */
+inline uint64_t now() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+/**
+ * record operation latency for current thread
+ */
+void record(operation op, uint64_t ticks) noexcept;
+
+/**
+ * increment counter for current thread
+ */
+void increment(counter cnt) noexcept;
+
+/**
+ * aggregate statistics of all threads (including finished ones)
+ */
+snapshot collect();
+
+/**
+ * reset statistics of all threads
+ */
+void reset();
+
+/**
+ * \brief record latency of scope
+ */
+class scoped_timer {
+public:
+  explicit scoped_timer(operation op) noexcept
+    : _op(op)
+    , _start(now()) {}
+
+  ~scoped_timer() {
+    record(_op, now() - _start);
+  }
+
+  scoped_timer(scoped_timer const &) = delete;
+  scoped_timer &operator=(scoped_timer const &) = delete;
+
+private:
+  operation _op;   ///< operation
+  uint64_t _start; ///< start time
+};
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip::stats
+
+#ifdef NETWORK_PROTOCOLS_STATS
+#define PROTOCOLS_STATS_CONCAT_IMPL(a, b) a##b
+#define PROTOCOLS_STATS_CONCAT(a, b) PROTOCOLS_STATS_CONCAT_IMPL(a, b)
+#define PROTOCOLS_STATS_TIMER(op)                                                                          \
+  ::bro::net::proto::ip::stats::scoped_timer PROTOCOLS_STATS_CONCAT(stats_timer_, __LINE__)(               \
+    ::bro::net::proto::ip::stats::operation::op)
+#define PROTOCOLS_STATS_INCREMENT(cnt) ::bro::net::proto::ip::stats::increment(::bro::net::proto::ip::stats::counter::cnt)
+#else
+#define PROTOCOLS_STATS_TIMER(op)
+#define PROTOCOLS_STATS_INCREMENT(cnt) ((void) 0)
+#endif // NETWORK_PROTOCOLS_STATS
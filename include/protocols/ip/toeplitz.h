@@ -0,0 +1,158 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "classify.h"
+#include "full_address.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * \brief receive side scaling parameters
+ */
+struct rss {
+  enum : size_t {
+    e_key_size = 40,         ///< key size of most NICs (enough for ipv6 4-tuple)
+    e_v4_tuple_size = 12,    ///< ipv4 addresses and ports
+    e_v6_tuple_size = 36     ///< ipv6 addresses and ports
+  };
+
+  /**
+   * default key of Microsoft RSS specification (used by many drivers)
+   */
+  static constexpr uint8_t default_key[e_key_size] = {
+    0x6d, 0x5a, 0x56, 0xda, 0x25, 0x5b, 0x0e, 0xc2, 0x41, 0x67, 0x25, 0x3d, 0x43, 0xa3,
+    0x8f, 0xb0, 0xd0, 0xca, 0x2b, 0xcb, 0xae, 0x7b, 0x30, 0xb4, 0x77, 0xcb, 0x2d, 0xa3,
+    0x80, 0x30, 0xf2, 0x0c, 0x6a, 0x42, 0xb7, 0x3b, 0xbe, 0xac, 0x01, 0xfa};
+};
+
+/**
+ * \brief table driven toeplitz hash
+ *
+ * contribution of every input byte value at every input position is
+ * precomputed from key, so hash is one table lookup and xor per input byte
+ * (36 KB of tables, ipv4 4-tuple touches 12 KB). result is bit exact with
+ * toeplitz_hash() and with NIC RSS for the same key and input.
+ */
+class toeplitz {
+public:
+  enum : size_t {
+    e_max_input = rss::e_v6_tuple_size ///< max input size
+  };
+
+  /**
+   * ctor
+   *
+   * @param key secret key (missing bits are zeros)
+   * @param key_size key size
+   */
+  explicit toeplitz(uint8_t const *key = rss::default_key, size_t key_size = rss::e_key_size);
+
+  /**
+   * hash input in network byte order
+   *
+   * @param data input
+   * @param size input size (at most e_max_input, the rest is ignored)
+   */
+  uint32_t hash(uint8_t const *data, size_t size) const noexcept {
+    size = size < e_max_input ? size : e_max_input;
+    uint32_t res = 0;
+    for (size_t i = 0; i < size; ++i)
+      res ^= _table[i * 256 + data[i]];
+    return res;
+  }
+
+  /**
+   * hash ipv4 2-tuple (source and destination addresses)
+   */
+  uint32_t hash(v4::address const &source, v4::address const &destination) const noexcept;
+
+  /**
+   * hash ipv4 4-tuple (addresses and ports in host order)
+   */
+  uint32_t hash(v4::address const &source, v4::address const &destination, uint16_t source_port,
+                uint16_t destination_port) const noexcept;
+
+  /**
+   * hash ipv6 2-tuple (source and destination addresses)
+   */
+  uint32_t hash(v6::address const &source, v6::address const &destination) const noexcept;
+
+  /**
+   * hash ipv6 4-tuple (addresses and ports in host order)
+   */
+  uint32_t hash(v6::address const &source, v6::address const &destination, uint16_t source_port,
+                uint16_t destination_port) const noexcept;
+
+  /**
+   * hash 2-tuple
+   *
+   * @return hash (0 if addresses have different or unset versions)
+   */
+  uint32_t hash(address const &source, address const &destination) const noexcept;
+
+  /**
+   * hash 4-tuple
+   *
+   * @return hash (0 if addresses have different or unset versions)
+   */
+  uint32_t hash(full_address const &source, full_address const &destination) const noexcept;
+
+  /**
+   * hash burst of endpoint pairs (4-tuples)
+   *
+   * @param sources packet sources
+   * @param destinations packet destinations
+   * @param size number of pairs
+   * @param res hashes
+   */
+  void hash(full_address const *sources, full_address const *destinations, size_t size, uint32_t *res) const noexcept;
+
+  /**
+   * hash classified burst as NIC does
+   *
+   * tcp and udp packets are hashed by 4-tuple, other ip packets (including
+   * fragments and truncated ones with addresses) by 2-tuple, the rest get 0
+   *
+   * @param keys classified packets
+   * @param res keys._size hashes
+   */
+  void hash(flow_keys const &keys, uint32_t *res) const noexcept;
+
+private:
+  std::vector<uint32_t> _table; ///< e_max_input tables of 256 byte contributions
+};
+
+/**
+ * compute toeplitz hash bit by bit
+ *
+ * @param key secret key (at least size + 4 bytes, missing bits are zeros)
+ * @param key_size key size
+ * @param data input in network byte order
+ * @param size input size
+ * @return 32 bit hash
+ */
+uint32_t toeplitz_hash(uint8_t const *key, size_t key_size, uint8_t const *data, size_t size) noexcept;
+
+/**
+ * compute RSS hash of connection as NIC does for tcp/udp packet
+ *
+ * input is source address, destination address, source port, destination port
+ *
+ * @param source packet source
+ * @param destination packet destination
+ * @param key secret key
+ * @param key_size key size
+ * @return 32 bit hash (0 if addresses have different or unset versions)
+ */
+uint32_t rss_hash(full_address const &source, full_address const &destination,
+                  uint8_t const *key = rss::default_key, size_t key_size = rss::e_key_size) noexcept;
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
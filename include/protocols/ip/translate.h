@@ -0,0 +1,147 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "prefix.h"
+
+namespace bro::net::proto::ip {
+
+/** @addtogroup proto
+ *  @{
+ */
+
+/**
+ * \brief ipv4 embedded ipv6 address translation (RFC 6052)
+ *
+ * supported prefix lengths are 32, 40, 48, 56, 64 and 96. byte positions
+ * of ipv4 address are precomputed, so translation is a single shuffle
+ * (pshufb if SSSE3 is enabled) without branches on prefix length.
+ */
+class nat64 {
+public:
+  /**
+   * ctor with well known prefix 64:ff9b::/96
+   */
+  nat64() noexcept;
+
+  /**
+   * set network specific prefix
+   *
+   * @param pref ipv6 prefix with RFC 6052 length
+   * @return false if prefix is not ipv6, length is not supported or bits 64-71 are set
+   */
+  bool set_prefix(prefix const &pref) noexcept;
+
+  /**
+   * get prefix
+   */
+  prefix const &get_prefix() const noexcept {
+    return _prefix;
+  }
+
+  /**
+   * embed ipv4 address into ipv6 address
+   */
+  v6::address embed(v4::address const &addr) const noexcept;
+
+  /**
+   * extract ipv4 address from ipv6 address
+   *
+   * suffix bits are ignored as RFC 6052 requires
+   *
+   * @return false if address is not under prefix or bits 64-71 are set
+   */
+  bool extract(v6::address const &addr, v4::address &res) const noexcept;
+
+  /**
+   * embed batch of ipv4 addresses
+   */
+  void embed(v4::address const *addrs, size_t size, v6::address *res) const noexcept;
+
+  /**
+   * extract batch of ipv4 addresses
+   *
+   * @param addrs ipv6 addresses
+   * @param size number of addresses
+   * @param res extracted addresses (0.0.0.0 for addresses not under prefix)
+   * @return number of extracted addresses
+   */
+  size_t extract(v6::address const *addrs, size_t size, v4::address *res) const noexcept;
+
+private:
+  alignas(16) uint8_t _prefix_bytes[v6::address::e_bytes_size]; ///< prefix with zero host bits
+  alignas(16) uint8_t _mask[v6::address::e_bytes_size];         ///< prefix and "u" octet mask
+  alignas(16) uint8_t _embed[v6::address::e_bytes_size];        ///< v6 byte to v4 byte shuffle (0x80 - zero)
+  alignas(16) uint8_t _extract[v6::address::e_bytes_size];      ///< v4 byte to v6 byte shuffle (0x80 - zero)
+  prefix _prefix;                                                ///< prefix
+};
+
+/**
+ * \brief teredo address parts (RFC 4380)
+ */
+struct teredo_info {
+  v4::address _server; ///< teredo server
+  v4::address _client; ///< client external address
+  uint16_t _port = 0;  ///< client external port
+  uint16_t _flags = 0; ///< flags
+};
+
+/**
+ * build ipv4 mapped address (::ffff:a.b.c.d)
+ */
+v6::address to_v4_mapped(v4::address const &addr) noexcept;
+
+/**
+ * build batch of ipv4 mapped addresses
+ */
+void to_v4_mapped(v4::address const *addrs, size_t size, v6::address *res) noexcept;
+
+/**
+ * check if address is ipv4 mapped (::ffff:0:0/96)
+ */
+bool is_v4_mapped(v6::address const &addr) noexcept;
+
+/**
+ * extract ipv4 address from ipv4 mapped address
+ *
+ * @return false if address is not ipv4 mapped
+ */
+bool extract_v4_mapped(v6::address const &addr, v4::address &res) noexcept;
+
+/**
+ * extract batch of ipv4 addresses from ipv4 mapped addresses
+ *
+ * @param res extracted addresses (0.0.0.0 for not mapped addresses)
+ * @return number of extracted addresses
+ */
+size_t extract_v4_mapped(v6::address const *addrs, size_t size, v4::address *res) noexcept;
+
+/**
+ * extract ipv4 address from deprecated ipv4 compatible address (::a.b.c.d)
+ *
+ * @return false if address is not ipv4 compatible (:: and ::1 are not)
+ */
+bool extract_v4_compatible(v6::address const &addr, v4::address &res) noexcept;
+
+/**
+ * build 6to4 prefix address (2002:a.b.c.d::/48 with zero subnet and interface id)
+ */
+v6::address to_6to4(v4::address const &addr) noexcept;
+
+/**
+ * extract ipv4 address from 6to4 address (2002::/16)
+ *
+ * @return false if address is not 6to4
+ */
+bool extract_6to4(v6::address const &addr, v4::address &res) noexcept;
+
+/**
+ * extract teredo server, client address and port (2001::/32)
+ *
+ * @return false if address is not teredo
+ */
+bool extract_teredo(v6::address const &addr, teredo_info &info) noexcept;
+
+/** @} */ // end of proto
+
+} // namespace bro::net::proto::ip
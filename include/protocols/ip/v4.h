@@ -1,5 +1,7 @@
 #pragma once
 #include <string>
+
+#include "basic_address.h"
 #ifdef __linux__
 #include <netinet/in.h>
 #endif
@@ -13,7 +15,7 @@ namespace bro::net::proto::ip::v4 {
 /**
  * \brief ip v4 address wrapper
  */
-class address {
+class address : public basic_address<family::e_v4> {
 public:
   enum {
     e_bytes_size = 4 ///< address size in bytes
@@ -29,6 +31,12 @@ public:
    */
   address(address const &addr) = default;
 
+  /**
+   * ctor from family core
+   */
+  address(basic_address const &addr) noexcept
+    : basic_address(addr) {}
+
   /**
    * ctor from string representation
    *
@@ -39,21 +47,19 @@ public:
   /**
    * ctor from uint32_t
    */
-  explicit address(uint32_t addr) noexcept
-    : _dword(addr) {}
+  explicit address(uint32_t addr) noexcept {
+    _words[0] = addr;
+  }
 
   /**
    * ctor from byte array
    */
   explicit address(uint8_t const (&bytes)[e_bytes_size]) noexcept
-    : _byte1(bytes[0])
-    , _byte2(bytes[1])
-    , _byte3(bytes[2])
-    , _byte4(bytes[3]) {}
+    : basic_address(bytes) {}
 
 #ifdef __linux__
   address(in_addr const &addr) noexcept
-    : _dword(addr.s_addr) {}
+    : address(uint32_t(addr.s_addr)) {}
 #endif
 
   /**
@@ -61,23 +67,19 @@ public:
    *
    * to build like 192,168,0,1
    */
-  address(uint8_t byte1, uint8_t byte2, uint8_t byte3, uint8_t byte4) noexcept
-    : _byte1(byte1)
-    , _byte2(byte2)
-    , _byte3(byte3)
-    , _byte4(byte4) {}
-
-  /**
-   * get current address in reverse order
-   */
-  address reverse_order() const noexcept;
+  address(uint8_t byte1, uint8_t byte2, uint8_t byte3, uint8_t byte4) noexcept {
+    _bytes[0] = byte1;
+    _bytes[1] = byte2;
+    _bytes[2] = byte3;
+    _bytes[3] = byte4;
+  }
 
 #ifdef __linux__
   /**
    * assign operator from ipv4 native linux
    */
   address &operator=(in_addr const &addr) noexcept {
-    _dword = addr.s_addr;
+    _words[0] = addr.s_addr;
     return *this;
   }
 #endif
@@ -85,45 +87,14 @@ public:
   /**
    * assign operator
    */
-  address &operator=(address const &r) noexcept {
-    _dword = r._dword;
-    return *this;
-  }
-
-  /**
-   * operator less
-   */
-  bool operator<(address const &r) const noexcept {
-    return _dword < r._dword;
-  }
-
-  /**
-   * operator equal
-   */
-  bool operator==(address const &r) const noexcept {
-    return _dword == r._dword;
-  }
-
-  /**
-   * operator not equal
-   */
-  bool operator!=(address const &r) const noexcept {
-    return !(_dword == r._dword);
-  }
-
-  /**
-   * operator&
-   */
-  address operator&(address const &r) const noexcept {
-    return address(_dword & r._dword);
-  }
+  address &operator=(address const &r) noexcept = default;
 
 #ifdef __linux__
   /**
    * get native discriptor
    */
   in_addr to_native() const noexcept {
-    return {_dword};
+    return {_words[0]};
   }
 #endif
 
@@ -131,7 +102,7 @@ public:
    * get address as uint32_t
    */
   uint32_t get_data() const noexcept {
-    return _dword;
+    return _words[0];
   }
 
   /**
@@ -142,17 +113,6 @@ public:
   std::string to_string() const;
 
 private:
-  union {
-    struct {
-      uint8_t _byte1; ///< 1 byte
-      uint8_t _byte2; ///< 2 byte
-      uint8_t _byte3; ///< 3 byte
-      uint8_t _byte4; ///< 4 byte
-    };
-    uint8_t _bytes[e_bytes_size]; ///< bytes array
-    uint32_t _dword = 0;          ///< address as 32 bit
-  };
-
   friend bool string_to_address(std::string const &str_address, address &address) noexcept;
 };
 
@@ -191,7 +151,7 @@ bool string_to_address(std::string const &str_address, uint32_t &address) noexce
  * @return true if operation succeed
  */
 inline bool string_to_address(std::string const &str_address, address &address) noexcept {
-  return string_to_address(str_address, address._dword);
+  return string_to_address(str_address, address._words[0]);
 }
 
 /**
@@ -1,5 +1,7 @@
 #pragma once
 #include <string>
+
+#include "basic_address.h"
 #ifdef __linux__
 #include <netinet/in.h>
 #endif
@@ -12,7 +14,7 @@ namespace bro::net::proto::ip::v6 {
 /**
  * \brief ip v6 address wrapper
  */
-class address {
+class address : public basic_address<family::e_v6> {
 public:
   enum {
     e_bytes_size = 16, ///< address size in bytes
@@ -30,6 +32,12 @@ public:
    */
   address(address const &addr) = default;
 
+  /**
+   * ctor from family core
+   */
+  address(basic_address const &addr) noexcept
+    : basic_address(addr) {}
+
   /**
    * ctor from string representation
    *
@@ -46,13 +54,15 @@ public:
   /**
    * ctor from uint32_t array
    */
-  explicit address(uint32_t const (&addr)[e_dword_size]) noexcept
-    : address(addr[0], addr[1], addr[2], addr[3]) {}
+  explicit address(uint32_t const (&addr)[e_dword_size]) noexcept {
+    memcpy(_bytes, addr, e_bytes_size);
+  }
 
   /**
    * ctor from byte array
    */
-  explicit address(uint8_t const (&addr)[e_bytes_size]) noexcept;
+  explicit address(uint8_t const (&addr)[e_bytes_size]) noexcept
+    : basic_address(addr) {}
 
 #ifdef __linux__
 
@@ -65,14 +75,18 @@ public:
   /**
    * ctor from uint64_t's
    */
-  address(uint64_t qword1, uint64_t qword2) noexcept
-    : _qword{qword1, qword2} {}
+  address(uint64_t qword1, uint64_t qword2) noexcept {
+    _words[0] = qword1;
+    _words[1] = qword2;
+  }
 
   /**
    * ctor from uint32_t's
    */
-  address(uint32_t dword1, uint32_t dword2, uint32_t dword3, uint32_t dword4) noexcept
-    : _dword{dword1, dword2, dword3, dword4} {}
+  address(uint32_t dword1, uint32_t dword2, uint32_t dword3, uint32_t dword4) noexcept {
+    uint32_t const dwords[e_dword_size] = {dword1, dword2, dword3, dword4};
+    memcpy(_bytes, dwords, e_bytes_size);
+  }
 
   /**
    * ctor from bytes
@@ -93,22 +107,8 @@ public:
           uint8_t byte14,
           uint8_t byte15,
           uint8_t byte16) noexcept
-    : _byte1(byte1)
-    , _byte2(byte2)
-    , _byte3(byte3)
-    , _byte4(byte4)
-    , _byte5(byte5)
-    , _byte6(byte6)
-    , _byte7(byte7)
-    , _byte8(byte8)
-    , _byte9(byte9)
-    , _byte10(byte10)
-    , _byte11(byte11)
-    , _byte12(byte12)
-    , _byte13(byte13)
-    , _byte14(byte14)
-    , _byte15(byte15)
-    , _byte16(byte16) {}
+    : basic_address({byte1, byte2, byte3, byte4, byte5, byte6, byte7, byte8, byte9, byte10, byte11, byte12, byte13,
+                     byte14, byte15, byte16}) {}
 
 #ifdef __linux__
   /**
@@ -119,44 +119,7 @@ public:
   /**
    * assign operator
    */
-  address &operator=(address const &r) noexcept {
-    _qword[0] = r._qword[0];
-    _qword[1] = r._qword[1];
-    return *this;
-  }
-
-  /**
-   * operator less
-   */
-  bool operator<(address const &r) const noexcept {
-    return _qword[0] < r._qword[0] || (!(r._qword[0] < _qword[0]) && _qword[1] < r._qword[1]);
-  }
-
-  /**
-   * operator equal
-   */
-  bool operator==(address const &r) const noexcept {
-    return _qword[0] == r._qword[0] && _qword[1] == r._qword[1];
-  }
-
-  /**
-   * operator not equal
-   */
-  bool operator!=(address const &r) const noexcept {
-    return !(*this == r);
-  }
-
-  /**
-   * operator&
-   */
-  address operator&(address const &r) const noexcept {
-    return address(_qword[0] & r._qword[0], _qword[1] & r._qword[1]);
-  }
-
-  /**
-   * get current address in reverse order
-   */
-  address reverse_order() const noexcept;
+  address &operator=(address const &r) noexcept = default;
 
   /**
    * get address as uint8_t *
@@ -180,30 +143,6 @@ public:
 #endif
 
 private:
-  union {
-    struct {
-      uint8_t _byte1;  ///< byte 1
-      uint8_t _byte2;  ///< byte 2
-      uint8_t _byte3;  ///< byte 3
-      uint8_t _byte4;  ///< byte 4
-      uint8_t _byte5;  ///< byte 5
-      uint8_t _byte6;  ///< byte 6
-      uint8_t _byte7;  ///< byte 7
-      uint8_t _byte8;  ///< byte 8
-      uint8_t _byte9;  ///< byte 9
-      uint8_t _byte10; ///< byte 10
-      uint8_t _byte11; ///< byte 11
-      uint8_t _byte12; ///< byte 12
-      uint8_t _byte13; ///< byte 13
-      uint8_t _byte14; ///< byte 14
-      uint8_t _byte15; ///< byte 15
-      uint8_t _byte16; ///< byte 16
-    };
-    uint64_t _qword[e_qword_size]; ///< uint64_t array
-    uint32_t _dword[e_dword_size]; ///< uint32_t array
-    uint8_t _bytes[e_bytes_size];  ///< bytes array
-  };
-
   friend std::string address_to_string(address const &address) noexcept;
   friend bool string_to_address(std::string const &str_address, address &address) noexcept;
 };
@@ -0,0 +1,147 @@
+#include <protocols/ip/acl.h>
+
+#include <cstring>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif // __AVX2__
+
+namespace bro::net::proto::ip {
+
+static_assert(sizeof(v4::address) == v4::address::e_bytes_size, "address must be plain 4 bytes");
+
+acl::acl(std::vector<prefix> const &prefixes)
+  : _size(prefixes.size()) {
+  for (size_t i = 0; i < prefixes.size(); ++i) {
+    auto const &pref = prefixes[i];
+    address const mask = make_mask(pref.get_version(), pref.get_length());
+    switch (pref.get_version()) {
+    case address::version::e_v4:
+      _v4_masks.push_back(mask.to_v4().get_data());
+      _v4_values.push_back(pref.get_address().to_v4().get_data());
+      _v4_indices.push_back(static_cast<uint32_t>(i));
+      break;
+    case address::version::e_v6: {
+      uint64_t qwords[v6::address::e_qword_size];
+      memcpy(qwords, mask.to_v6().get_data(), sizeof(qwords));
+      _v6_masks[0].push_back(qwords[0]);
+      _v6_masks[1].push_back(qwords[1]);
+      memcpy(qwords, pref.get_address().to_v6().get_data(), sizeof(qwords));
+      _v6_values[0].push_back(qwords[0]);
+      _v6_values[1].push_back(qwords[1]);
+      _v6_indices.push_back(static_cast<uint32_t>(i));
+      break;
+    }
+    default:
+      break;
+    }
+  }
+
+  // padding never matches: (addr & 0) != all ones
+  while (_v4_masks.size() % e_v4_lanes) {
+    _v4_masks.push_back(0);
+    _v4_values.push_back(UINT32_MAX);
+    _v4_indices.push_back(e_no_match);
+  }
+  while (_v6_masks[0].size() % e_v6_lanes) {
+    for (size_t i = 0; i < 2; ++i) {
+      _v6_masks[i].push_back(0);
+      _v6_values[i].push_back(UINT64_MAX);
+    }
+    _v6_indices.push_back(e_no_match);
+  }
+}
+
+uint32_t acl::match(address const &addr) const noexcept {
+  switch (addr.get_version()) {
+  case address::version::e_v4:
+    return match(addr.to_v4());
+  case address::version::e_v6:
+    return match(addr.to_v6());
+  default:
+    break;
+  }
+  return e_no_match;
+}
+
+uint32_t acl::match(v4::address const &addr) const noexcept {
+  uint32_t const data = addr.get_data();
+  size_t const size = _v4_masks.size();
+#ifdef __AVX2__
+  __m256i const value = _mm256_set1_epi32(static_cast<int>(data));
+  for (size_t i = 0; i < size; i += e_v4_lanes) {
+    __m256i const masks = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(_v4_masks.data() + i));
+    __m256i const values = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(_v4_values.data() + i));
+    int const bits =
+      _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(value, masks), values)));
+    if (bits)
+      return _v4_indices[i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(bits)))];
+  }
+#else
+  for (size_t i = 0; i < size; ++i) {
+    if ((data & _v4_masks[i]) == _v4_values[i])
+      return _v4_indices[i];
+  }
+#endif // __AVX2__
+  return e_no_match;
+}
+
+uint32_t acl::match(v6::address const &addr) const noexcept {
+  uint64_t qwords[v6::address::e_qword_size];
+  memcpy(qwords, addr.get_data(), sizeof(qwords));
+  size_t const size = _v6_indices.size();
+#ifdef __AVX2__
+  __m256i const high = _mm256_set1_epi64x(static_cast<long long>(qwords[0]));
+  __m256i const low = _mm256_set1_epi64x(static_cast<long long>(qwords[1]));
+  for (size_t i = 0; i < size; i += e_v6_lanes) {
+    __m256i const high_masks = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(_v6_masks[0].data() + i));
+    __m256i const low_masks = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(_v6_masks[1].data() + i));
+    __m256i const high_values = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(_v6_values[0].data() + i));
+    __m256i const low_values = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(_v6_values[1].data() + i));
+    __m256i const equal = _mm256_and_si256(_mm256_cmpeq_epi64(_mm256_and_si256(high, high_masks), high_values),
+                                           _mm256_cmpeq_epi64(_mm256_and_si256(low, low_masks), low_values));
+    int const bits = _mm256_movemask_pd(_mm256_castsi256_pd(equal));
+    if (bits)
+      return _v6_indices[i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(bits)))];
+  }
+#else
+  for (size_t i = 0; i < size; ++i) {
+    if ((qwords[0] & _v6_masks[0][i]) == _v6_values[0][i] && (qwords[1] & _v6_masks[1][i]) == _v6_values[1][i])
+      return _v6_indices[i];
+  }
+#endif // __AVX2__
+  return e_no_match;
+}
+
+void acl::match(address const *addrs, size_t size, uint32_t *indices) const noexcept {
+  for (size_t i = 0; i < size; ++i)
+    indices[i] = match(addrs[i]);
+}
+
+void acl::match(v4::address const *addrs, size_t size, uint32_t *indices) const noexcept {
+  size_t i = 0;
+#ifdef __AVX2__
+  // 8 addresses are tested against one prefix at once, the first match of every lane is kept
+  for (; i + e_v4_lanes <= size; i += e_v4_lanes) {
+    __m256i const values = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(addrs + i));
+    __m256i result = _mm256_set1_epi32(static_cast<int>(e_no_match));
+    __m256i pending = _mm256_set1_epi32(-1);
+    for (size_t j = 0; j < _v4_masks.size() && !_mm256_testz_si256(pending, pending); ++j) {
+      __m256i const masked = _mm256_and_si256(values, _mm256_set1_epi32(static_cast<int>(_v4_masks[j])));
+      __m256i const hit =
+        _mm256_and_si256(_mm256_cmpeq_epi32(masked, _mm256_set1_epi32(static_cast<int>(_v4_values[j]))), pending);
+      result = _mm256_blendv_epi8(result, _mm256_set1_epi32(static_cast<int>(_v4_indices[j])), hit);
+      pending = _mm256_andnot_si256(hit, pending);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(indices + i), result);
+  }
+#endif // __AVX2__
+  for (; i < size; ++i)
+    indices[i] = match(addrs[i]);
+}
+
+void acl::match(v6::address const *addrs, size_t size, uint32_t *indices) const noexcept {
+  for (size_t i = 0; i < size; ++i)
+    indices[i] = match(addrs[i]);
+}
+
+} // namespace bro::net::proto::ip
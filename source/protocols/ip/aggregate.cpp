@@ -0,0 +1,197 @@
+#include <protocols/ip/aggregate.h>
+#include <protocols/ip/numeric.h>
+#include <protocols/ip/sort.h>
+
+#include <algorithm>
+
+namespace bro::net::proto::ip {
+
+namespace {
+
+/**
+ * \brief numeric address interval [first, last]
+ */
+struct interval {
+  uint128_t _first; ///< first address
+  uint128_t _last;  ///< last address
+};
+
+/**
+ * \brief intervals split by address version
+ */
+struct intervals {
+  std::vector<interval> _v4; ///< ipv4 intervals
+  std::vector<interval> _v6; ///< ipv6 intervals
+
+  void add(uint128_t first, uint128_t last, address::version ver) {
+    if (ver == address::version::e_v4)
+      _v4.push_back({first, last});
+    else if (ver == address::version::e_v6)
+      _v6.push_back({first, last});
+  }
+};
+
+/**
+ * get mask for host part of prefix with host_bits bits
+ */
+uint128_t host_mask(unsigned host_bits) noexcept {
+  return host_bits >= 128 ? ~uint128_t(0) : (uint128_t(1) << host_bits) - 1;
+}
+
+unsigned count_trailing_zeros(uint128_t value) noexcept {
+  auto const low = static_cast<uint64_t>(value);
+  return low ? __builtin_ctzll(low) : 64 + __builtin_ctzll(static_cast<uint64_t>(value >> 64));
+}
+
+unsigned floor_log2(uint128_t value) noexcept {
+  auto const high = static_cast<uint64_t>(value >> 64);
+  return high ? 127 - __builtin_clzll(high) : 63 - __builtin_clzll(static_cast<uint64_t>(value));
+}
+
+/**
+ * append minimal list of prefixes covering [first, last]
+ */
+void emit_prefixes(uint128_t first, uint128_t last, address::version ver, std::vector<prefix> &res) {
+  unsigned const bits = max_prefix_length(ver);
+  for (;;) {
+    uint128_t const span = last - first;
+    // the biggest aligned block starting at first which fits into range
+    unsigned size = span == ~uint128_t(0) ? 128 : floor_log2(span + 1);
+    if (first)
+      size = std::min(size, count_trailing_zeros(first));
+    size = std::min(size, bits);
+
+    res.emplace_back(to_address(first, ver), static_cast<uint8_t>(bits - size));
+    uint128_t const end = first + host_mask(size);
+    if (end == last)
+      break;
+    first = end + 1;
+  }
+}
+
+/**
+ * sort intervals and merge overlapping and adjacent ones
+ */
+void merge(std::vector<interval> &list) {
+  std::sort(list.begin(), list.end(), [](interval const &l, interval const &r) { return l._first < r._first; });
+  size_t size = 0;
+  for (auto const &cur : list) {
+    if (size && (list[size - 1]._last == ~uint128_t(0) || cur._first <= list[size - 1]._last + 1)) {
+      list[size - 1]._last = std::max(list[size - 1]._last, cur._last);
+      continue;
+    }
+    list[size++] = cur;
+  }
+  list.resize(size);
+}
+
+/**
+ * convert sorted disjoint intervals to prefixes
+ */
+std::vector<prefix> to_prefixes(intervals const &list) {
+  std::vector<prefix> res;
+  for (auto const &cur : list._v4)
+    emit_prefixes(cur._first, cur._last, address::version::e_v4, res);
+  for (auto const &cur : list._v6)
+    emit_prefixes(cur._first, cur._last, address::version::e_v6, res);
+  return res;
+}
+
+intervals to_intervals(std::vector<prefix> const &prefixes) {
+  intervals res;
+  for (auto const &pref : prefixes) {
+    uint128_t const first = to_number(pref.get_address());
+    uint128_t const last = first | host_mask(max_prefix_length(pref.get_version()) - pref.get_length());
+    res.add(first, last, pref.get_version());
+  }
+  merge(res._v4);
+  merge(res._v6);
+  return res;
+}
+
+/**
+ * subtract sorted disjoint intervals from sorted disjoint intervals
+ */
+std::vector<interval> subtract(std::vector<interval> const &from, std::vector<interval> const &remove) {
+  std::vector<interval> res;
+  size_t first_removed = 0;
+  for (auto const &cur : from) {
+    while (first_removed < remove.size() && remove[first_removed]._last < cur._first)
+      ++first_removed;
+
+    uint128_t first = cur._first;
+    bool covered = false;
+    for (size_t i = first_removed; i < remove.size() && remove[i]._first <= cur._last; ++i) {
+      if (remove[i]._first > first)
+        res.push_back({first, remove[i]._first - 1});
+      if (remove[i]._last >= cur._last) {
+        covered = true;
+        break;
+      }
+      first = remove[i]._last + 1;
+    }
+    if (!covered)
+      res.push_back({first, cur._last});
+  }
+  return res;
+}
+
+} // namespace
+
+bool range_to_prefixes(address const &first, address const &last, std::vector<prefix> &res) {
+  if (first.get_version() != last.get_version() || first.get_version() == address::version::e_none)
+    return false;
+  uint128_t const first_num = to_number(first);
+  uint128_t const last_num = to_number(last);
+  if (first_num > last_num)
+    return false;
+  emit_prefixes(first_num, last_num, first.get_version(), res);
+  return true;
+}
+
+std::vector<prefix> aggregate(std::vector<address> addrs, size_t threads) {
+  sort(addrs, threads);
+  unique(addrs);
+
+  // sorted addresses are converted to runs of consecutive numbers
+  intervals list;
+  for (size_t i = 0; i < addrs.size();) {
+    auto const ver = addrs[i].get_version();
+    uint128_t const first = to_number(addrs[i]);
+    uint128_t last = first;
+    for (++i; i < addrs.size() && addrs[i].get_version() == ver && to_number(addrs[i]) == last + 1; ++i)
+      ++last;
+    list.add(first, last, ver);
+  }
+  return to_prefixes(list);
+}
+
+std::vector<prefix> aggregate(std::vector<prefix> const &prefixes) {
+  return to_prefixes(to_intervals(prefixes));
+}
+
+std::vector<prefix> aggregate(std::vector<address_range> const &ranges) {
+  intervals list;
+  for (auto const &[first, last] : ranges) {
+    if (first.get_version() != last.get_version())
+      continue;
+    uint128_t const first_num = to_number(first);
+    uint128_t const last_num = to_number(last);
+    if (first_num <= last_num)
+      list.add(first_num, last_num, first.get_version());
+  }
+  merge(list._v4);
+  merge(list._v6);
+  return to_prefixes(list);
+}
+
+std::vector<prefix> exclude(std::vector<prefix> const &from, std::vector<prefix> const &remove) {
+  auto const from_list = to_intervals(from);
+  auto const remove_list = to_intervals(remove);
+  intervals res;
+  res._v4 = subtract(from_list._v4, remove_list._v4);
+  res._v6 = subtract(from_list._v6, remove_list._v6);
+  return to_prefixes(res);
+}
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,133 @@
+#include <protocols/ip/balancer.h>
+
+#include <algorithm>
+
+namespace bro::net::proto::ip {
+
+namespace {
+
+bool is_prime(uint32_t value) noexcept {
+  if (value < 4)
+    return value > 1;
+  if (value % 2 == 0)
+    return false;
+  for (uint64_t divisor = 3; divisor * divisor <= value; divisor += 2) {
+    if (value % divisor == 0)
+      return false;
+  }
+  return true;
+}
+
+/**
+ * permutation visits every slot only when skip is coprime with size
+ */
+uint32_t next_prime(uint32_t value) noexcept {
+  enum : uint32_t { e_max_prime = 4294967291U };
+  if (value >= e_max_prime)
+    return e_max_prime;
+  while (!is_prime(value))
+    ++value;
+  return value;
+}
+
+} // namespace
+
+rendezvous::rendezvous(std::vector<full_address> const &backends, uint64_t seed)
+  : _seed(seed) {
+  _hashes.reserve(backends.size());
+  for (auto const &backend : backends)
+    _hashes.push_back(hash(backend, seed));
+}
+
+size_t rendezvous::lookup(full_address const &client) const noexcept {
+  uint64_t const key = hash(client, _seed);
+  size_t res = _hashes.size();
+  uint64_t best = 0;
+  for (size_t i = 0; i < _hashes.size(); ++i) {
+    uint64_t const score = detail::hash_mix(key ^ _hashes[i], detail::e_hash_k2);
+    if (res == _hashes.size() || score > best) {
+      best = score;
+      res = i;
+    }
+  }
+  return res;
+}
+
+maglev_table::maglev_table(std::vector<full_address> backends, std::vector<uint32_t> const &weights, uint32_t size,
+                           uint64_t seed)
+  : _seed(seed)
+  , _backends(std::move(backends)) {
+  size = size > 1 ? next_prime(size) : uint32_t(e_default_size);
+
+  /**
+   * \brief backend permutation state
+   */
+  struct preference {
+    uint32_t _index;  ///< backend index
+    uint32_t _weight; ///< backend weight
+    uint32_t _next;   ///< next preferred slot
+    uint32_t _skip;   ///< permutation step
+    uint64_t _credit; ///< accumulated weight
+  };
+
+  std::vector<preference> prefs;
+  uint32_t max_weight = 0;
+  for (size_t i = 0; i < _backends.size(); ++i) {
+    uint32_t const weight = weights.size() == _backends.size() ? weights[i] : 1;
+    if (!weight)
+      continue;
+    // permutation depends on endpoint only, not on its position in the list
+    uint64_t const offset_hash = hash(_backends[i], seed);
+    uint64_t const skip_hash = hash(_backends[i], seed ^ detail::e_hash_k1);
+    prefs.push_back({static_cast<uint32_t>(i), weight, static_cast<uint32_t>(offset_hash % size),
+                     static_cast<uint32_t>(skip_hash % (size - 1) + 1), 0});
+    max_weight = std::max(max_weight, weight);
+  }
+  if (prefs.empty())
+    return;
+
+  _slots.assign(size, e_no_backend);
+  for (uint32_t filled = 0;;) {
+    for (auto &pref : prefs) {
+      // backend takes a turn every time its credit reaches max weight
+      pref._credit += pref._weight;
+      for (; pref._credit >= max_weight; pref._credit -= max_weight) {
+        uint32_t slot = pref._next;
+        while (_slots[slot] != e_no_backend) {
+          slot += pref._skip;
+          slot = slot >= size ? slot - size : slot;
+        }
+        _slots[slot] = pref._index;
+        slot += pref._skip;
+        pref._next = slot >= size ? slot - size : slot;
+        if (++filled == size)
+          return;
+      }
+    }
+  }
+}
+
+void maglev_table::lookup(full_address const *clients, size_t size, uint32_t *res) const noexcept {
+  for (size_t i = 0; i < size; ++i)
+    res[i] = lookup(clients[i]);
+}
+
+maglev_balancer::maglev_balancer(uint32_t size, uint64_t seed)
+  : _size(size)
+  , _seed(seed)
+  , _table(std::make_unique<maglev_table const>(std::vector<full_address>(), std::vector<uint32_t>(), size, seed)) {}
+
+void maglev_balancer::update(std::vector<full_address> backends, std::vector<uint32_t> const &weights) {
+  _table.update(std::make_unique<maglev_table const>(std::move(backends), weights, _size, _seed));
+}
+
+bool maglev_balancer::select(full_address const &client, full_address &backend) const {
+  auto const table = _table.read();
+  auto const *selected = table->select(client);
+  if (!selected)
+    return false;
+  backend = *selected;
+  return true;
+}
+
+} // namespace bro::net::proto::ip
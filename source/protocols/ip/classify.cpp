@@ -0,0 +1,222 @@
+#include <protocols/ip/classify.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace bro::net::proto::ip {
+
+namespace {
+
+enum : uint16_t {
+  e_ethertype_ipv4 = 0x0800,
+  e_ethertype_ipv6 = 0x86dd,
+  e_ethertype_vlan = 0x8100,
+  e_ethertype_qinq = 0x88a8
+};
+
+enum : uint8_t {
+  e_next_hop_by_hop = 0,
+  e_next_tcp = 6,
+  e_next_udp = 17,
+  e_next_routing = 43,
+  e_next_fragment = 44,
+  e_next_ah = 51,
+  e_next_destination = 60,
+  e_next_sctp = 132,
+  e_next_udplite = 136
+};
+
+enum {
+  e_ethernet_size = 14,         ///< destination, source, ethertype
+  e_vlan_size = 4,              ///< tci, ethertype
+  e_max_vlans = 2,              ///< max number of vlan tags
+  e_ipv4_min_size = 20,         ///< ipv4 header without options
+  e_ipv6_size = 40,             ///< ipv6 fixed header
+  e_extension_min_size = 8,     ///< ipv6 extension header min size
+  e_max_extension_headers = 8,  ///< max number of skipped ipv6 extension headers
+  e_ports_size = 4,             ///< source and destination ports
+  e_prefetch_distance = 4       ///< packets prefetched ahead
+};
+
+inline uint16_t load_be16(uint8_t const *data) noexcept {
+  return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+inline v6::address load_v6(uint8_t const *data) noexcept {
+  uint8_t bytes[v6::address::e_bytes_size];
+  memcpy(bytes, data, sizeof(bytes));
+  return v6::address(bytes);
+}
+
+/**
+ * parse transport ports
+ *
+ * end is the end of ip packet by its header, limit is min(end, frame size)
+ */
+inline packet_status parse_l4(uint8_t const *data, size_t offset, size_t end, size_t limit, uint8_t protocol,
+                              flow_keys &keys, size_t index) noexcept {
+  keys._protocols[index] = protocol;
+  if (offset >= limit)
+    return offset == end ? packet_status::e_ok : packet_status::e_truncated;
+  keys._l4_offsets[index] = static_cast<uint16_t>(offset);
+  switch (protocol) {
+  case e_next_tcp:
+  case e_next_udp:
+  case e_next_sctp:
+  case e_next_udplite:
+    if (limit - offset < e_ports_size)
+      return packet_status::e_truncated;
+    keys._source_ports[index] = load_be16(data + offset);
+    keys._destination_ports[index] = load_be16(data + offset + 2);
+    break;
+  default:
+    break;
+  }
+  return packet_status::e_ok;
+}
+
+inline packet_status parse_ipv4(uint8_t const *data, size_t offset, size_t size, flow_keys &keys,
+                                size_t index) noexcept {
+  if (size - offset < e_ipv4_min_size)
+    return packet_status::e_truncated;
+  uint8_t const *header = data + offset;
+  size_t const header_size = size_t(header[0] & 0x0f) * 4;
+  size_t const total_size = load_be16(header + 2);
+  if ((header[0] >> 4) != 4 || header_size < e_ipv4_min_size || total_size < header_size)
+    return packet_status::e_invalid;
+
+  uint32_t source, destination;
+  memcpy(&source, header + 12, sizeof(source));
+  memcpy(&destination, header + 16, sizeof(destination));
+  keys._sources[index] = address(v4::address(source));
+  keys._destinations[index] = address(v4::address(destination));
+  keys._l3_offsets[index] = static_cast<uint16_t>(offset);
+  keys._protocols[index] = header[9];
+
+  // ethernet padding after ip packet is ignored
+  size_t const end = offset + total_size;
+  if (load_be16(header + 6) & 0x1fff)
+    return packet_status::e_fragment;
+  return parse_l4(data, offset + header_size, end, std::min(end, size), header[9], keys, index);
+}
+
+inline packet_status parse_ipv6(uint8_t const *data, size_t offset, size_t size, flow_keys &keys,
+                                size_t index) noexcept {
+  if (size - offset < e_ipv6_size)
+    return packet_status::e_truncated;
+  uint8_t const *header = data + offset;
+  if ((header[0] >> 4) != 6)
+    return packet_status::e_invalid;
+
+  keys._sources[index] = address(load_v6(header + 8));
+  keys._destinations[index] = address(load_v6(header + 24));
+  keys._l3_offsets[index] = static_cast<uint16_t>(offset);
+
+  // zero payload length is used by jumbograms
+  size_t const payload_size = load_be16(header + 4);
+  size_t const end = payload_size ? offset + e_ipv6_size + payload_size : size;
+  size_t const limit = std::min(end, size);
+  uint8_t next = header[6];
+  keys._protocols[index] = next;
+  offset += e_ipv6_size;
+  for (size_t i = 0; i < e_max_extension_headers; ++i) {
+    size_t length = 0;
+    switch (next) {
+    case e_next_hop_by_hop:
+    case e_next_routing:
+    case e_next_destination:
+      if (limit - offset < e_extension_min_size)
+        return packet_status::e_truncated;
+      length = (size_t(data[offset + 1]) + 1) * 8;
+      break;
+    case e_next_ah:
+      if (limit - offset < e_extension_min_size)
+        return packet_status::e_truncated;
+      length = (size_t(data[offset + 1]) + 2) * 4;
+      break;
+    case e_next_fragment:
+      if (limit - offset < e_extension_min_size)
+        return packet_status::e_truncated;
+      if (load_be16(data + offset + 2) & 0xfff8) {
+        keys._protocols[index] = data[offset];
+        return packet_status::e_fragment;
+      }
+      length = e_extension_min_size;
+      break;
+    default:
+      return parse_l4(data, offset, end, limit, next, keys, index);
+    }
+    next = data[offset];
+    keys._protocols[index] = next;
+    offset += length;
+    if (offset > limit)
+      return packet_status::e_truncated;
+  }
+  return parse_l4(data, offset, end, limit, next, keys, index);
+}
+
+inline packet_status parse_ethernet(uint8_t const *data, size_t size, flow_keys &keys, size_t index) noexcept {
+  if (size < e_ethernet_size)
+    return packet_status::e_truncated;
+  size_t offset = e_ethernet_size;
+  uint16_t ethertype = load_be16(data + 12);
+  for (size_t i = 0; i < e_max_vlans && (ethertype == e_ethertype_vlan || ethertype == e_ethertype_qinq); ++i) {
+    if (size - offset < e_vlan_size)
+      return packet_status::e_truncated;
+    if (!i)
+      keys._vlans[index] = load_be16(data + offset) & 0x0fff;
+    ethertype = load_be16(data + offset + 2);
+    offset += e_vlan_size;
+  }
+
+  switch (ethertype) {
+  case e_ethertype_ipv4:
+    return parse_ipv4(data, offset, size, keys, index);
+  case e_ethertype_ipv6:
+    return parse_ipv6(data, offset, size, keys, index);
+  default:
+    break;
+  }
+  return packet_status::e_not_ip;
+}
+
+} // namespace
+
+flow_keys::flow_keys(size_t capacity)
+  : _sources(capacity)
+  , _destinations(capacity)
+  , _source_ports(capacity)
+  , _destination_ports(capacity)
+  , _protocols(capacity)
+  , _vlans(capacity)
+  , _l3_offsets(capacity)
+  , _l4_offsets(capacity)
+  , _statuses(capacity) {}
+
+size_t classify(packet const *packets, size_t size, flow_keys &keys) noexcept {
+  size = std::min(size, keys.capacity());
+  for (size_t i = 0; i < size && i < e_prefetch_distance; ++i)
+    __builtin_prefetch(packets[i]._data);
+
+  size_t classified = 0;
+  for (size_t i = 0; i < size; ++i) {
+    if (i + e_prefetch_distance < size)
+      __builtin_prefetch(packets[i + e_prefetch_distance]._data);
+
+    keys._sources[i] = address();
+    keys._destinations[i] = address();
+    keys._source_ports[i] = 0;
+    keys._destination_ports[i] = 0;
+    keys._protocols[i] = 0;
+    keys._vlans[i] = 0;
+    keys._l3_offsets[i] = 0;
+    keys._l4_offsets[i] = 0;
+    packet_status const status = parse_ethernet(packets[i]._data, packets[i]._size, keys, i);
+    keys._statuses[i] = status;
+    classified += status == packet_status::e_ok;
+  }
+  keys._size = size;
+  return classified;
+}
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,374 @@
+#include <protocols/ip/codec.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace bro::net::proto::ip {
+
+namespace {
+
+enum : size_t {
+  e_header_size = 12,      ///< magic, address count, prefix count
+  e_block_header_size = 20 ///< bases, widths, version mode
+};
+
+/**
+ * address versions of block
+ */
+enum : uint8_t {
+  e_all_v6, ///< no bitmap
+  e_all_v4, ///< no bitmap
+  e_mixed   ///< bitmap, bit is set for ipv4
+};
+
+inline uint64_t load64(uint8_t const *data) noexcept {
+  uint64_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+inline uint32_t load32(uint8_t const *data) noexcept {
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+template <typename T> void append(std::vector<uint8_t> &out, T value) {
+  uint8_t bytes[sizeof(T)];
+  memcpy(bytes, &value, sizeof(T));
+  out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+inline uint8_t bit_width(uint64_t value) noexcept {
+  return value ? static_cast<uint8_t>(64 - __builtin_clzll(value)) : 0;
+}
+
+inline size_t packed_size(size_t count, uint8_t width) noexcept {
+  return (count * width + 7) / 8;
+}
+
+/**
+ * append values minus base packed to width bits
+ */
+void pack(uint64_t const *values, size_t count, uint64_t base, uint8_t width, std::vector<uint8_t> &out) {
+  if (!width)
+    return;
+  uint64_t acc = 0;
+  unsigned bits = 0;
+  for (size_t i = 0; i < count; ++i) {
+    uint64_t const delta = values[i] - base;
+    acc |= delta << bits;
+    if (bits + width >= 64) {
+      append(out, acc);
+      acc = bits ? delta >> (64 - bits) : 0;
+      bits = bits + width - 64;
+    } else {
+      bits += width;
+    }
+  }
+  for (unsigned i = 0; i < bits; i += 8)
+    out.push_back(static_cast<uint8_t>(acc >> i));
+}
+
+/**
+ * get packed value (reads up to 8 bytes after value, see codec::e_padding)
+ */
+inline uint64_t unpack_one(uint8_t const *data, uint8_t width, size_t index) noexcept {
+  size_t const bit = index * width;
+  unsigned const shift = bit & 7;
+  uint64_t value = load64(data + bit / 8) >> shift;
+  if (shift + width > 64)
+    value |= uint64_t(data[bit / 8 + 8]) << (64 - shift);
+  return width == 64 ? value : value & ((uint64_t(1) << width) - 1);
+}
+
+/**
+ * unpack count values and add base
+ */
+void unpack(uint8_t const *data, uint8_t width, uint64_t base, size_t count, uint64_t *out) noexcept {
+  if (!width) {
+    std::fill(out, out + count, base);
+  } else if (width == 64) {
+    for (size_t i = 0; i < count; ++i)
+      out[i] = base + load64(data + i * 8);
+  } else if (width <= 57) {
+    // value with its bit shift fits one unaligned word
+    uint64_t const mask = (uint64_t(1) << width) - 1;
+    for (size_t i = 0; i < count; ++i) {
+      size_t const bit = i * width;
+      out[i] = base + ((load64(data + bit / 8) >> (bit & 7)) & mask);
+    }
+  } else {
+    for (size_t i = 0; i < count; ++i)
+      out[i] = base + unpack_one(data, width, i);
+  }
+}
+
+/**
+ * \brief parsed block header
+ */
+struct block_header {
+  uint64_t _iid_base;      ///< ipv6 identifier frame of reference
+  uint32_t _index_base;    ///< prefix index frame of reference
+  uint32_t _v4_base;       ///< ipv4 address frame of reference
+  uint8_t _index_width;    ///< prefix index width
+  uint8_t _iid_width;      ///< ipv6 identifier width
+  uint8_t _v4_width;       ///< ipv4 address width
+  uint8_t _mode;           ///< address versions
+  size_t _v4_count;        ///< number of ipv4 addresses
+  uint8_t const *_bitmap;  ///< version bitmap (mixed block)
+  uint8_t const *_indexes; ///< packed prefix indexes of ipv6 addresses
+  uint8_t const *_iids;    ///< packed identifiers of ipv6 addresses
+  uint8_t const *_v4;      ///< packed ipv4 addresses
+};
+
+/**
+ * count ipv4 addresses before index in version bitmap
+ */
+inline size_t count_v4(uint8_t const *bitmap, size_t index) noexcept {
+  size_t res = 0;
+  for (size_t i = 0; i < index / 8; ++i)
+    res += static_cast<size_t>(__builtin_popcount(bitmap[i]));
+  if (index % 8)
+    res += static_cast<size_t>(__builtin_popcount(bitmap[index / 8] & ((1U << (index % 8)) - 1)));
+  return res;
+}
+
+/**
+ * parse block header
+ *
+ * @param data block
+ * @param count addresses in block
+ * @return block size
+ */
+size_t parse_block(uint8_t const *data, size_t count, block_header &header) noexcept {
+  header._iid_base = load64(data);
+  header._index_base = load32(data + 8);
+  header._v4_base = load32(data + 12);
+  header._index_width = data[16];
+  header._iid_width = data[17];
+  header._v4_width = data[18];
+  header._mode = data[19];
+  header._bitmap = data + e_block_header_size;
+  header._indexes = header._bitmap;
+  header._v4_count = header._mode == e_all_v4 ? count : 0;
+  if (header._mode == e_mixed) {
+    header._indexes += (count + 7) / 8;
+    header._v4_count = count_v4(header._bitmap, count);
+  }
+  size_t const v6_count = count - header._v4_count;
+  header._iids = header._indexes + packed_size(v6_count, header._index_width);
+  header._v4 = header._iids + packed_size(v6_count, header._iid_width);
+  return static_cast<size_t>(header._v4 - data) + packed_size(header._v4_count, header._v4_width);
+}
+
+inline v6::address make_v6(uint8_t const *prefixes, uint64_t index, uint64_t iid) noexcept {
+  return v6::address(__builtin_bswap64(load64(prefixes + index * sizeof(uint64_t))), __builtin_bswap64(iid));
+}
+
+inline v4::address make_v4(uint64_t value) noexcept {
+  return v4::address(__builtin_bswap32(static_cast<uint32_t>(value)));
+}
+
+} // namespace
+
+bool encode_addresses(address const *addrs, size_t size, std::vector<uint8_t> &res) {
+  res.clear();
+  if (size > UINT32_MAX)
+    return false;
+  // ipv6 prefixes and identifiers, ipv4 addresses (host order)
+  std::vector<uint64_t> prefixes, iids, v4_addrs;
+  prefixes.reserve(size);
+  iids.reserve(size);
+  for (size_t i = 0; i < size; ++i) {
+    if (addrs[i].is_ipv4()) {
+      v4_addrs.push_back(__builtin_bswap32(addrs[i].to_v4().get_data()));
+    } else if (addrs[i].is_ipv6()) {
+      uint64_t qword[v6::address::e_qword_size];
+      memcpy(qword, addrs[i].get_data(), sizeof(qword));
+      prefixes.push_back(__builtin_bswap64(qword[0]));
+      iids.push_back(__builtin_bswap64(qword[1]));
+    } else {
+      return false;
+    }
+  }
+
+  std::vector<uint64_t> dictionary(prefixes);
+  std::sort(dictionary.begin(), dictionary.end());
+  dictionary.erase(std::unique(dictionary.begin(), dictionary.end()), dictionary.end());
+  // prefixes are replaced by dictionary indexes
+  for (auto &prefix : prefixes)
+    prefix = static_cast<uint64_t>(std::lower_bound(dictionary.begin(), dictionary.end(), prefix) - dictionary.begin());
+
+  size_t const block_count = (size + codec::e_block_size - 1) / codec::e_block_size;
+  append(res, uint32_t(codec::e_magic));
+  append(res, static_cast<uint32_t>(size));
+  append(res, static_cast<uint32_t>(dictionary.size()));
+  for (auto prefix : dictionary)
+    append(res, prefix);
+  size_t const offsets = res.size();
+  res.resize(offsets + (block_count + 1) * sizeof(uint32_t));
+  size_t const blocks = res.size();
+
+  size_t v6_first = 0, v4_first = 0;
+  for (size_t block = 0; block < block_count; ++block) {
+    size_t const first = block * codec::e_block_size;
+    size_t const count = std::min(size - first, size_t(codec::e_block_size));
+    uint32_t const offset = static_cast<uint32_t>(res.size() - blocks);
+    memcpy(res.data() + offsets + block * sizeof(uint32_t), &offset, sizeof(offset));
+
+    size_t const v4_count = static_cast<size_t>(
+      std::count_if(addrs + first, addrs + first + count, [](address const &addr) { return addr.is_ipv4(); }));
+    size_t const v6_count = count - v4_count;
+    auto const frame = [](std::vector<uint64_t> const &values, size_t from, size_t number) {
+      if (!number)
+        return std::pair<uint64_t, uint8_t>(0, 0);
+      auto const [min, max] = std::minmax_element(values.begin() + static_cast<ptrdiff_t>(from),
+                                                  values.begin() + static_cast<ptrdiff_t>(from + number));
+      return std::pair<uint64_t, uint8_t>(*min, bit_width(*max - *min));
+    };
+    auto const [index_base, index_width] = frame(prefixes, v6_first, v6_count);
+    auto const [iid_base, iid_width] = frame(iids, v6_first, v6_count);
+    auto const [v4_base, v4_width] = frame(v4_addrs, v4_first, v4_count);
+    uint8_t const mode = !v4_count ? e_all_v6 : !v6_count ? e_all_v4 : e_mixed;
+
+    append(res, iid_base);
+    append(res, static_cast<uint32_t>(index_base));
+    append(res, static_cast<uint32_t>(v4_base));
+    res.insert(res.end(), {index_width, iid_width, v4_width, mode});
+    if (mode == e_mixed) {
+      size_t const bitmap = res.size();
+      res.resize(bitmap + (count + 7) / 8);
+      for (size_t i = 0; i < count; ++i)
+        res[bitmap + i / 8] |= static_cast<uint8_t>(addrs[first + i].is_ipv4() << (i % 8));
+    }
+    pack(prefixes.data() + v6_first, v6_count, index_base, index_width, res);
+    pack(iids.data() + v6_first, v6_count, iid_base, iid_width, res);
+    pack(v4_addrs.data() + v4_first, v4_count, v4_base, v4_width, res);
+    v6_first += v6_count;
+    v4_first += v4_count;
+  }
+
+  uint32_t const end = static_cast<uint32_t>(res.size() - blocks);
+  memcpy(res.data() + offsets + block_count * sizeof(uint32_t), &end, sizeof(end));
+  res.resize(res.size() + codec::e_padding);
+  return true;
+}
+
+bool address_column::open(uint8_t const *data, size_t size) noexcept {
+  *this = address_column();
+  if (size < e_header_size + sizeof(uint32_t) + codec::e_padding || load32(data) != codec::e_magic)
+    return false;
+  size_t const count = load32(data + 4);
+  size_t const prefix_count = load32(data + 8);
+  size_t const block_count = (count + codec::e_block_size - 1) / codec::e_block_size;
+  size_t const blocks = e_header_size + prefix_count * sizeof(uint64_t) + (block_count + 1) * sizeof(uint32_t);
+  if (blocks + codec::e_padding > size)
+    return false;
+  uint8_t const *offsets = data + e_header_size + prefix_count * sizeof(uint64_t);
+  size_t const blocks_size = load32(offsets + block_count * sizeof(uint32_t));
+  if (blocks + blocks_size + codec::e_padding != size)
+    return false;
+
+  // every prefix index is checked once, so decoding needs no checks
+  uint64_t indexes[codec::e_block_size];
+  for (size_t block = 0; block < block_count; ++block) {
+    size_t const block_size = std::min(count - block * codec::e_block_size, size_t(codec::e_block_size));
+    size_t const offset = load32(offsets + block * sizeof(uint32_t));
+    size_t const next = load32(offsets + (block + 1) * sizeof(uint32_t));
+    if (offset > next || next > blocks_size || next - offset < e_block_header_size)
+      return false;
+    uint8_t const *block_data = data + blocks + offset;
+    uint8_t const mode = block_data[19];
+    // bitmap must fit block before it is counted
+    if (block_data[16] > 32 || block_data[17] > 64 || block_data[18] > 32 || mode > e_mixed ||
+        (mode == e_mixed && next - offset < e_block_header_size + (block_size + 7) / 8))
+      return false;
+    block_header header;
+    if (parse_block(block_data, block_size, header) != next - offset)
+      return false;
+    size_t const v6_count = block_size - header._v4_count;
+    if (mode == e_mixed && (!v6_count || !header._v4_count))
+      return false;
+    unpack(header._indexes, header._index_width, header._index_base, v6_count, indexes);
+    if (std::any_of(indexes, indexes + v6_count, [prefix_count](uint64_t index) { return index >= prefix_count; }))
+      return false;
+  }
+
+  _prefixes = data + e_header_size;
+  _offsets = offsets;
+  _blocks = data + blocks;
+  _size = count;
+  _prefix_count = prefix_count;
+  return true;
+}
+
+size_t address_column::decode_block(size_t block, address *res) const noexcept {
+  if (block >= get_block_count())
+    return 0;
+  size_t const count = std::min(_size - block * codec::e_block_size, size_t(codec::e_block_size));
+  block_header header;
+  parse_block(_blocks + load32(_offsets + block * sizeof(uint32_t)), count, header);
+
+  uint64_t indexes[codec::e_block_size];
+  uint64_t iids[codec::e_block_size];
+  uint64_t v4_addrs[codec::e_block_size];
+  size_t const v6_count = count - header._v4_count;
+  unpack(header._indexes, header._index_width, header._index_base, v6_count, indexes);
+  unpack(header._iids, header._iid_width, header._iid_base, v6_count, iids);
+  unpack(header._v4, header._v4_width, header._v4_base, header._v4_count, v4_addrs);
+
+  // assignment from v4/v6 address avoids temporary ip::address
+  switch (header._mode) {
+  case e_all_v4:
+    for (size_t i = 0; i < count; ++i)
+      res[i] = make_v4(v4_addrs[i]);
+    break;
+  case e_all_v6:
+    for (size_t i = 0; i < count; ++i)
+      res[i] = make_v6(_prefixes, indexes[i], iids[i]);
+    break;
+  default:
+    for (size_t i = 0, v4_pos = 0, v6_pos = 0; i < count; ++i) {
+      if (header._bitmap[i / 8] >> (i % 8) & 1) {
+        res[i] = make_v4(v4_addrs[v4_pos++]);
+      } else {
+        res[i] = make_v6(_prefixes, indexes[v6_pos], iids[v6_pos]);
+        ++v6_pos;
+      }
+    }
+    break;
+  }
+  return count;
+}
+
+void address_column::decode(address *res) const noexcept {
+  for (size_t block = 0, count = get_block_count(); block < count; ++block)
+    decode_block(block, res + block * codec::e_block_size);
+}
+
+address address_column::get(size_t index) const noexcept {
+  if (index >= _size)
+    return {};
+  size_t const block = index / codec::e_block_size;
+  size_t pos = index % codec::e_block_size;
+  block_header header;
+  parse_block(_blocks + load32(_offsets + block * sizeof(uint32_t)),
+              std::min(_size - block * codec::e_block_size, size_t(codec::e_block_size)), header);
+  auto const get_value = [](uint8_t const *data, uint8_t width, uint64_t base, size_t value_index) {
+    return base + (width ? unpack_one(data, width, value_index) : 0);
+  };
+
+  bool v4 = header._mode == e_all_v4;
+  if (header._mode == e_mixed) {
+    v4 = header._bitmap[pos / 8] >> (pos % 8) & 1;
+    size_t const v4_before = count_v4(header._bitmap, pos);
+    pos = v4 ? v4_before : pos - v4_before;
+  }
+  if (v4)
+    return address(make_v4(get_value(header._v4, header._v4_width, header._v4_base, pos)));
+  return address(make_v6(_prefixes, get_value(header._indexes, header._index_width, header._index_base, pos),
+                         get_value(header._iids, header._iid_width, header._iid_base, pos)));
+}
+
+} // namespace bro::net::proto::ip
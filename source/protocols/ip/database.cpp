@@ -0,0 +1,251 @@
+#include <protocols/ip/database.h>
+
+#include <cstdio>
+#include <cstring>
+
+namespace bro::net::proto::ip {
+
+namespace {
+
+/**
+ * \brief header of database file
+ */
+struct database_header {
+  char _magic[8];         ///< file type
+  uint32_t _version;      ///< format version
+  uint32_t _header_size;  ///< offset of trie
+  uint32_t _node_count;   ///< number of trie nodes
+  uint32_t _ipv4_start;   ///< record of ::/96
+  uint64_t _data_size;    ///< data section size
+  uint64_t _reserved[4];  ///< reserved
+};
+
+static_assert(sizeof(database_header) == 64, "data must be cache line aligned");
+
+constexpr char database_magic[8] = {'B', 'R', 'O', 'I', 'P', 'D', 'B', '1'};
+
+enum {
+  e_ipv4_depth = 96, ///< depth of ipv4 subtree
+  e_record_size = sizeof(uint32_t),
+  e_node_size = 2 * e_record_size
+};
+
+inline uint8_t get_bit(uint8_t const *bytes, size_t index) noexcept {
+  return (bytes[index / 8] >> (7 - index % 8)) & 1;
+}
+
+} // namespace
+
+bool database::open(std::string const &path) noexcept {
+  close();
+  if (!_file.open(path) || _file.get_size() < sizeof(database_header)) {
+    _file.close();
+    return false;
+  }
+  auto const *header = reinterpret_cast<database_header const *>(_file.get_data());
+  uint64_t const tree_size = uint64_t(header->_node_count) * e_node_size;
+  uint64_t const body_size = _file.get_size() - sizeof(database_header);
+  // sizes come from file, compare by subtraction so they can't wrap
+  if (memcmp(header->_magic, database_magic, sizeof(database_magic)) || header->_version != 1 ||
+      header->_header_size != sizeof(database_header) || !header->_node_count || tree_size > body_size ||
+      header->_data_size != body_size - tree_size ||
+      uint64_t(header->_node_count) + 1 + header->_data_size > UINT32_MAX) {
+    _file.close();
+    return false;
+  }
+  _nodes = reinterpret_cast<uint32_t const *>(_file.get_data() + header->_header_size);
+  _data = _file.get_data() + header->_header_size + tree_size;
+  _data_size = header->_data_size;
+  _node_count = header->_node_count;
+  _ipv4_start = header->_ipv4_start;
+  return true;
+}
+
+void database::close() noexcept {
+  _file.close();
+  _nodes = nullptr;
+  _data = nullptr;
+  _data_size = 0;
+  _node_count = 0;
+  _ipv4_start = 0;
+}
+
+bool database::lookup(address const &addr, uint32_t &offset, uint8_t &prefix_length) const noexcept {
+  if (!_nodes)
+    return false;
+
+  static constexpr uint8_t v4_mapped_prefix[] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff};
+  v6::address v6_addr;
+  uint32_t v4_data = 0;
+  uint8_t const *bytes = nullptr;
+  size_t bits = 0;
+  uint32_t record = 0;
+  switch (addr.get_version()) {
+  case address::version::e_v4:
+    v4_data = addr.to_v4().get_data();
+    bytes = reinterpret_cast<uint8_t const *>(&v4_data);
+    bits = 32;
+    record = _ipv4_start;
+    break;
+  case address::version::e_v6:
+    v6_addr = addr.to_v6();
+    bytes = v6_addr.get_data();
+    bits = 128;
+    if (!memcmp(bytes, v4_mapped_prefix, sizeof(v4_mapped_prefix))) {
+      bytes += sizeof(v4_mapped_prefix);
+      bits = 32;
+      record = _ipv4_start;
+    }
+    break;
+  default:
+    return false;
+  }
+
+  size_t depth = 0;
+  for (; record < _node_count && depth < bits; ++depth)
+    record = _nodes[2 * size_t(record) + get_bit(bytes, depth)];
+  if (record <= _node_count)
+    return false;
+  offset = record - _node_count - 1;
+  prefix_length = static_cast<uint8_t>(depth);
+  return true;
+}
+
+std::string_view database::get_value(uint32_t offset) const noexcept {
+  uint32_t size = 0;
+  if (uint64_t(offset) + sizeof(size) > _data_size)
+    return {};
+  memcpy(&size, _data + offset, sizeof(size));
+  if (uint64_t(offset) + sizeof(size) + size > _data_size)
+    return {};
+  return std::string_view(reinterpret_cast<char const *>(_data + offset + sizeof(size)), size);
+}
+
+database_builder::database_builder()
+  : _nodes(1) {}
+
+bool database_builder::insert(prefix const &pref, std::string_view value) {
+  uint8_t bytes[v6::address::e_bytes_size] = {0};
+  size_t first = 0;
+  switch (pref.get_version()) {
+  case address::version::e_v4: {
+    uint32_t const data = pref.get_address().to_v4().get_data();
+    memcpy(bytes + e_ipv4_depth / 8, &data, sizeof(data));
+    first = e_ipv4_depth;
+    break;
+  }
+  case address::version::e_v6:
+    memcpy(bytes, pref.get_address().to_v6().get_data(), sizeof(bytes));
+    break;
+  default:
+    return false;
+  }
+
+  auto it = _offsets.find(std::string(value));
+  if (it == _offsets.end()) {
+    if (_data.size() + sizeof(uint32_t) + value.size() >= UINT32_MAX)
+      return false;
+    uint32_t const size = static_cast<uint32_t>(value.size());
+    it = _offsets.emplace(std::string(value), static_cast<uint32_t>(_data.size())).first;
+    _data.append(reinterpret_cast<char const *>(&size), sizeof(size));
+    _data.append(value);
+  }
+
+  uint32_t index = 0;
+  for (size_t depth = 0; depth < first + pref.get_length(); ++depth) {
+    uint8_t const bit = get_bit(bytes, depth);
+    if (!_nodes[index]._children[bit]) {
+      _nodes[index]._children[bit] = static_cast<uint32_t>(_nodes.size());
+      _nodes.emplace_back();
+    }
+    index = _nodes[index]._children[bit];
+  }
+  _nodes[index]._value = it->second;
+  return true;
+}
+
+bool database_builder::save(std::string const &path) const {
+  auto const is_internal = [this](uint32_t index) {
+    return _nodes[index]._children[0] || _nodes[index]._children[1];
+  };
+
+  // number output nodes in preorder (root and nodes with children)
+  std::vector<uint32_t> numbers(_nodes.size(), e_no_value);
+  uint32_t node_count = 0;
+  std::vector<uint32_t> stack{0};
+  while (!stack.empty()) {
+    uint32_t const index = stack.back();
+    stack.pop_back();
+    numbers[index] = node_count++;
+    for (int bit = 1; bit >= 0; --bit) {
+      uint32_t const child = _nodes[index]._children[bit];
+      if (child && is_internal(child))
+        stack.push_back(child);
+    }
+  }
+  if (uint64_t(node_count) + 1 + _data.size() > UINT32_MAX)
+    return false;
+
+  auto const encode = [node_count](uint32_t value) {
+    return value == e_no_value ? node_count : node_count + 1 + value;
+  };
+
+  // values of prefixes are pushed down to records without more specific prefix
+  std::vector<uint32_t> records(2 * size_t(node_count));
+  std::vector<std::pair<uint32_t, uint32_t>> pending{{0, _nodes[0]._value}};
+  while (!pending.empty()) {
+    auto const [index, inherited] = pending.back();
+    pending.pop_back();
+    for (int bit = 0; bit < 2; ++bit) {
+      uint32_t const child = _nodes[index]._children[bit];
+      uint32_t &record = records[2 * size_t(numbers[index]) + bit];
+      if (!child) {
+        record = encode(inherited);
+        continue;
+      }
+      uint32_t const value = _nodes[child]._value != e_no_value ? _nodes[child]._value : inherited;
+      if (is_internal(child)) {
+        record = numbers[child];
+        pending.emplace_back(child, value);
+      } else {
+        record = encode(value);
+      }
+    }
+  }
+
+  // ipv4 subtree starts after 96 zero bits
+  uint32_t index = 0;
+  uint32_t value = _nodes[0]._value;
+  uint32_t ipv4_start = 0;
+  for (size_t depth = 0;; ++depth) {
+    if (depth == e_ipv4_depth) {
+      ipv4_start = is_internal(index) ? numbers[index] : encode(value);
+      break;
+    }
+    index = _nodes[index]._children[0];
+    if (!index) {
+      ipv4_start = encode(value);
+      break;
+    }
+    if (_nodes[index]._value != e_no_value)
+      value = _nodes[index]._value;
+  }
+
+  database_header header{};
+  memcpy(header._magic, database_magic, sizeof(database_magic));
+  header._version = 1;
+  header._header_size = sizeof(database_header);
+  header._node_count = node_count;
+  header._ipv4_start = ipv4_start;
+  header._data_size = _data.size();
+
+  FILE *file = fopen(path.c_str(), "wb");
+  if (!file)
+    return false;
+  bool const rc = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  fwrite(records.data(), e_record_size, records.size(), file) == records.size() &&
+                  fwrite(_data.data(), 1, _data.size(), file) == _data.size();
+  return fclose(file) == 0 && rc;
+}
+
+} // namespace bro::net::proto::ip
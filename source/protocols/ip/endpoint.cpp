@@ -0,0 +1,330 @@
+#include <protocols/ip/endpoint.h>
+#include <protocols/ip/stats.h>
+
+#include <algorithm>
+#include <cstring>
+#ifdef __linux__
+#include <net/if.h>
+#endif // __linux__
+
+namespace bro::net::proto::ip {
+
+namespace {
+
+inline bool is_digit(char c) noexcept {
+  return c >= '0' && c <= '9';
+}
+
+inline int hex_value(char c) noexcept {
+  if (is_digit(c))
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+inline char *write_decimal(char *out, uint32_t value) noexcept {
+  char buffer[10];
+  char *pos = buffer + sizeof(buffer);
+  do {
+    *--pos = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value);
+  return std::copy(pos, buffer + sizeof(buffer), out);
+}
+
+/**
+ * parse dotted quad (leading zeros are not allowed, as in inet_pton)
+ *
+ * on failure p points to the invalid character, on success to the first
+ * character after address
+ */
+bool parse_v4(char const *&p, char const *last, uint8_t *bytes) noexcept {
+  for (size_t i = 0; i < v4::address::e_bytes_size; ++i) {
+    if (i) {
+      if (p == last || *p != '.')
+        return false;
+      ++p;
+    }
+    if (p == last || !is_digit(*p))
+      return false;
+    unsigned value = static_cast<unsigned>(*p++ - '0');
+    if (!value && p != last && is_digit(*p))
+      return false;
+    for (; p != last && is_digit(*p); ++p) {
+      value = value * 10 + static_cast<unsigned>(*p - '0');
+      if (value > 255)
+        return false;
+    }
+    bytes[i] = static_cast<uint8_t>(value);
+  }
+  return true;
+}
+
+/**
+ * parse ipv6 address up to last (same grammar as inet_pton)
+ *
+ * on failure p points to the invalid character
+ */
+bool parse_v6(char const *&p, char const *last, uint8_t (&bytes)[v6::address::e_bytes_size]) noexcept {
+  memset(bytes, 0, sizeof(bytes));
+  uint8_t *tp = bytes;
+  uint8_t *const endp = bytes + sizeof(bytes);
+  uint8_t *colonp = nullptr;
+
+  // leading ':' is allowed only as part of "::"
+  if (p != last && *p == ':') {
+    ++p;
+    if (p == last || *p != ':')
+      return false;
+  }
+
+  char const *token = p;
+  bool saw_digit = false;
+  unsigned value = 0;
+  size_t digits = 0;
+  while (p != last) {
+    char const ch = *p;
+    if (int const nibble = hex_value(ch); nibble >= 0) {
+      if (digits == 4)
+        return false;
+      value = (value << 4) | static_cast<unsigned>(nibble);
+      ++digits;
+      saw_digit = true;
+      ++p;
+      continue;
+    }
+    if (ch == ':') {
+      if (!saw_digit) {
+        if (colonp)
+          return false;
+        colonp = tp;
+      } else {
+        if (p + 1 == last || tp + 2 > endp)
+          return false;
+        *tp++ = static_cast<uint8_t>(value >> 8);
+        *tp++ = static_cast<uint8_t>(value);
+        saw_digit = false;
+        value = 0;
+        digits = 0;
+      }
+      token = ++p;
+      continue;
+    }
+    if (ch == '.' && tp + v4::address::e_bytes_size <= endp) {
+      // embedded ipv4 takes the rest of string
+      p = token;
+      if (!parse_v4(p, last, tp) || p != last)
+        return false;
+      tp += v4::address::e_bytes_size;
+      saw_digit = false;
+      break;
+    }
+    return false;
+  }
+
+  if (saw_digit) {
+    if (tp + 2 > endp)
+      return false;
+    *tp++ = static_cast<uint8_t>(value >> 8);
+    *tp++ = static_cast<uint8_t>(value);
+  }
+  if (colonp) {
+    if (tp == endp)
+      return false;
+    size_t const tail = static_cast<size_t>(tp - colonp);
+    memmove(endp - tail, colonp, tail);
+    memset(colonp, 0, static_cast<size_t>(endp - tail - colonp));
+    tp = endp;
+  }
+  return tp == endp;
+}
+
+/**
+ * parse port (1-5 digits, not greater than 65535) up to last
+ */
+bool parse_port(char const *&p, char const *last, uint16_t &port) noexcept {
+  if (p == last)
+    return false;
+  uint32_t value = 0;
+  for (; p != last; ++p) {
+    if (!is_digit(*p))
+      return false;
+    value = value * 10 + static_cast<uint32_t>(*p - '0');
+    if (value > UINT16_MAX)
+      return false;
+  }
+  port = static_cast<uint16_t>(value);
+  return true;
+}
+
+/**
+ * parse scope (interface index or name, 0 is not an interface index)
+ */
+bool parse_scope(char const *first, char const *last, uint32_t &scope_id) noexcept {
+  if (first == last)
+    return false;
+  if (std::all_of(first, last, is_digit)) {
+    uint64_t value = 0;
+    for (; first != last; ++first) {
+      value = value * 10 + static_cast<uint64_t>(*first - '0');
+      if (value > UINT32_MAX)
+        return false;
+    }
+    scope_id = static_cast<uint32_t>(value);
+    return scope_id != 0;
+  }
+#ifdef __linux__
+  char name[IF_NAMESIZE];
+  size_t const size = static_cast<size_t>(last - first);
+  if (size >= sizeof(name))
+    return false;
+  memcpy(name, first, size);
+  name[size] = '\0';
+  scope_id = if_nametoindex(name);
+  return scope_id != 0;
+#else
+  return false;
+#endif // __linux__
+}
+
+endpoint_result make_error(endpoint_error error, char const *begin, char const *pos) noexcept {
+  return endpoint_result{error, static_cast<size_t>(pos - begin)};
+}
+
+endpoint_result parse_endpoint_impl(std::string_view str, full_address &addr) noexcept {
+  char const *const begin = str.data();
+  char const *const last = begin + str.size();
+  if (str.empty())
+    return make_error(endpoint_error::e_empty, begin, begin);
+
+  char const *p = begin;
+  address parsed;
+  uint32_t scope_id = 0;
+  bool has_scope = false;
+  uint16_t port = 0;
+
+  // ipv6 with optional scope, address part ends at '%' or addr_last
+  auto const parse_v6_scoped = [&](char const *addr_last) {
+    char const *const scope = std::find(p, addr_last, '%');
+    uint8_t bytes[v6::address::e_bytes_size];
+    if (!parse_v6(p, scope, bytes))
+      return make_error(endpoint_error::e_invalid_address, begin, p);
+    if (scope != addr_last) {
+      if (!parse_scope(scope + 1, addr_last, scope_id))
+        return make_error(endpoint_error::e_invalid_scope, begin, scope + 1);
+      has_scope = true;
+    }
+    parsed = v6::address(bytes);
+    p = addr_last;
+    return endpoint_result{};
+  };
+
+  if (*p == '[') {
+    char const *const close = std::find(++p, last, ']');
+    if (close == last)
+      return make_error(endpoint_error::e_missing_bracket, begin, last);
+    if (auto const result = parse_v6_scoped(close); !result)
+      return result;
+    if (++p != last) {
+      if (*p != ':')
+        return make_error(endpoint_error::e_trailing_data, begin, p);
+      if (!parse_port(++p, last, port))
+        return make_error(endpoint_error::e_invalid_port, begin, p);
+    }
+  } else {
+    char const *const colon = std::find(p, last, ':');
+    if (colon != last && std::find(colon + 1, last, ':') != last) {
+      // bare ipv6 (port can't be set without brackets)
+      if (auto const result = parse_v6_scoped(last); !result)
+        return result;
+    } else {
+      uint8_t bytes[v4::address::e_bytes_size];
+      if (!parse_v4(p, colon, bytes))
+        return make_error(endpoint_error::e_invalid_address, begin, p);
+      if (p != colon)
+        return make_error(*p == '%' ? endpoint_error::e_invalid_scope : endpoint_error::e_invalid_address, begin, p);
+      parsed = v4::address(bytes);
+      if (colon != last) {
+        p = colon + 1;
+        if (!parse_port(p, last, port))
+          return make_error(endpoint_error::e_invalid_port, begin, p);
+      }
+    }
+  }
+
+  addr = full_address(parsed, port);
+  if (has_scope)
+    addr.set_scope_id(scope_id);
+  return endpoint_result{};
+}
+
+} // namespace
+
+endpoint_result parse_address(std::string_view str, address &addr) noexcept {
+  PROTOCOLS_STATS_TIMER(e_parse);
+  char const *const begin = str.data();
+  char const *const last = begin + str.size();
+  char const *p = begin;
+  endpoint_result result;
+  if (str.empty()) {
+    result = make_error(endpoint_error::e_empty, begin, begin);
+  } else if (std::find(begin, last, ':') != last) {
+    uint8_t bytes[v6::address::e_bytes_size];
+    if (parse_v6(p, last, bytes))
+      addr = v6::address(bytes);
+    else
+      result = make_error(endpoint_error::e_invalid_address, begin, p);
+  } else {
+    uint8_t bytes[v4::address::e_bytes_size];
+    if (parse_v4(p, last, bytes) && p == last)
+      addr = v4::address(bytes);
+    else
+      result = make_error(endpoint_error::e_invalid_address, begin, p);
+  }
+  if (!result)
+    PROTOCOLS_STATS_INCREMENT(e_parse_failed);
+  return result;
+}
+
+endpoint_result parse_endpoint(std::string_view str, full_address &addr) noexcept {
+  PROTOCOLS_STATS_TIMER(e_parse);
+  auto const result = parse_endpoint_impl(str, addr);
+  if (!result)
+    PROTOCOLS_STATS_INCREMENT(e_parse_failed);
+  return result;
+}
+
+size_t parse_endpoints(std::string_view const *strs, size_t size, full_address *addrs,
+                       endpoint_result *results) noexcept {
+  size_t parsed = 0;
+  for (size_t i = 0; i < size; ++i) {
+    auto const result = parse_endpoint(strs[i], addrs[i]);
+    if (result)
+      ++parsed;
+    if (results)
+      results[i] = result;
+  }
+  return parsed;
+}
+
+char *endpoint_to_chars(char *out, full_address const &addr) noexcept {
+  auto const &ip = addr.get_address();
+  if (ip.get_version() == address::version::e_v6) {
+    *out++ = '[';
+    out = format_to(out, ip.to_v6());
+    if (auto const scope_id = addr.get_scope_id(); scope_id && *scope_id) {
+      *out++ = '%';
+      out = write_decimal(out, *scope_id);
+    }
+    *out++ = ']';
+  } else {
+    out = format_to(out, ip);
+  }
+  *out++ = ':';
+  return write_decimal(out, addr.get_port());
+}
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,316 @@
+#include <protocols/ip/filter.h>
+#include <protocols/ip/numeric.h>
+
+#include <cstdio>
+#include <cstring>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif // __AVX2__
+
+namespace bro::net::proto::ip {
+
+namespace {
+
+/**
+ * \brief header of saved filter
+ */
+struct file_header {
+  char _magic[8];             ///< filter type
+  uint32_t _version;          ///< format version
+  uint32_t _header_size;      ///< offset of data
+  uint64_t _size;             ///< number of blocks/buckets
+  uint64_t _seed;             ///< hash seed
+  uint64_t _count;            ///< number of entries
+  uint64_t _victim_index;     ///< cuckoo victim bucket
+  uint64_t _victim_fingerprint; ///< cuckoo victim fingerprint
+  uint64_t _reserved;         ///< padding to 64 bytes
+};
+
+static_assert(sizeof(file_header) == 64, "data must be cache line aligned");
+
+constexpr char bloom_magic[8] = {'B', 'R', 'O', 'B', 'L', 'O', 'O', 'M'};
+constexpr char cuckoo_magic[8] = {'B', 'R', 'O', 'C', 'U', 'C', 'K', 'O'};
+
+/**
+ * batch is hashed and prefetched before probing
+ */
+constexpr size_t batch_size = 16;
+
+constexpr uint32_t bloom_salt[bloom_filter::e_block_words] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                                              0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+constexpr uint64_t lanes_lsb = 0x0001000100010001ull;
+constexpr uint64_t lanes_msb = 0x8000800080008000ull;
+
+bool save_file(std::string const &path, file_header const &header, void const *data, size_t size) noexcept {
+  FILE *file = fopen(path.c_str(), "wb");
+  if (!file)
+    return false;
+  bool const rc = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(data, 1, size, file) == size;
+  return fclose(file) == 0 && rc;
+}
+
+file_header const *load_file(mapped_file &file, std::string const &path, char const (&magic)[8],
+                             size_t element_size) noexcept {
+  if (!file.open(path) || file.get_size() < sizeof(file_header))
+    return nullptr;
+  auto const *header = reinterpret_cast<file_header const *>(file.get_data());
+  // size comes from file, check it before multiplication so it can't wrap
+  size_t const data_size = file.get_size() - sizeof(file_header);
+  if (memcmp(header->_magic, magic, sizeof(magic)) || header->_version != 1 ||
+      header->_header_size != sizeof(file_header) || !header->_size || header->_size > data_size / element_size ||
+      data_size != header->_size * element_size) {
+    file.close();
+    return nullptr;
+  }
+  return header;
+}
+
+/**
+ * get mask with top bit set in every 16 bit lane equal to zero
+ */
+inline uint64_t zero_lanes(uint64_t bucket) noexcept {
+  return (bucket - lanes_lsb) & ~bucket & lanes_msb;
+}
+
+inline uint16_t make_fingerprint(uint64_t h) noexcept {
+  auto const fp = static_cast<uint16_t>(h >> 48);
+  return fp ? fp : 1;
+}
+
+} // namespace
+
+bloom_filter::bloom_filter(size_t entries, uint8_t bits_per_entry, uint64_t seed)
+  : _seed(seed) {
+  size_t const block_bits = e_block_words * 32;
+  _block_count = (entries * bits_per_entry + block_bits - 1) / block_bits;
+  if (!_block_count)
+    _block_count = 1;
+  _storage.resize(_block_count * e_block_words);
+  _blocks = _storage.data();
+}
+
+bool bloom_filter::add_hash(uint64_t h) noexcept {
+  if (_file.is_open())
+    return false;
+  auto *block = const_cast<uint32_t *>(get_block(h));
+  auto const key = static_cast<uint32_t>(h);
+  for (size_t i = 0; i < e_block_words; ++i)
+    block[i] |= uint32_t(1) << ((key * bloom_salt[i]) >> 27);
+  return true;
+}
+
+bool bloom_filter::contains_hash(uint64_t h) const noexcept {
+  uint32_t const *block = get_block(h);
+  auto const key = static_cast<uint32_t>(h);
+#ifdef __AVX2__
+  __m256i const salt = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(bloom_salt));
+  __m256i const bits = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(key)), salt), 27);
+  __m256i const mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), bits);
+  return _mm256_testc_si256(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(block)), mask);
+#else
+  uint32_t missed = 0;
+  for (size_t i = 0; i < e_block_words; ++i)
+    missed |= ~block[i] & (uint32_t(1) << ((key * bloom_salt[i]) >> 27));
+  return !missed;
+#endif // __AVX2__
+}
+
+template <typename T> void bloom_filter::contains_batch(T const *addrs, size_t size, bool *res) const noexcept {
+  uint64_t hashes[batch_size];
+  for (size_t first = 0; first < size; first += batch_size) {
+    size_t const count = size - first < batch_size ? size - first : batch_size;
+    for (size_t i = 0; i < count; ++i) {
+      hashes[i] = hash(addrs[first + i], _seed);
+      __builtin_prefetch(get_block(hashes[i]));
+    }
+    for (size_t i = 0; i < count; ++i)
+      res[first + i] = contains_hash(hashes[i]);
+  }
+}
+
+void bloom_filter::contains(v4::address const *addrs, size_t size, bool *res) const noexcept {
+  contains_batch(addrs, size, res);
+}
+
+void bloom_filter::contains(v6::address const *addrs, size_t size, bool *res) const noexcept {
+  contains_batch(addrs, size, res);
+}
+
+void bloom_filter::contains(address const *addrs, size_t size, bool *res) const noexcept {
+  contains_batch(addrs, size, res);
+}
+
+bool bloom_filter::save(std::string const &path) const noexcept {
+  file_header header{};
+  memcpy(header._magic, bloom_magic, sizeof(bloom_magic));
+  header._version = 1;
+  header._header_size = sizeof(file_header);
+  header._size = _block_count;
+  header._seed = _seed;
+  return save_file(path, header, _blocks, get_size_in_bytes());
+}
+
+bool bloom_filter::load(std::string const &path) noexcept {
+  mapped_file file;
+  auto const *header = load_file(file, path, bloom_magic, e_block_words * sizeof(uint32_t));
+  if (!header)
+    return false;
+  _block_count = header->_size;
+  _seed = header->_seed;
+  _blocks = reinterpret_cast<uint32_t const *>(file.get_data() + header->_header_size);
+  _file = std::move(file);
+  _storage = {};
+  return true;
+}
+
+cuckoo_filter::cuckoo_filter(size_t entries, uint64_t seed)
+  : _seed(seed)
+  , _rnd(seed ^ detail::e_hash_k0) {
+  // keep load factor under 95%
+  _bucket_mask = round_up_pow2((entries * 100 / 95 + e_bucket_slots - 1) / e_bucket_slots) - 1;
+  _storage.resize(_bucket_mask + 1);
+  _buckets = _storage.data();
+}
+
+uint64_t cuckoo_filter::alt_index(uint64_t index, uint16_t fingerprint) const noexcept {
+  return (index ^ detail::hash_mix(fingerprint ^ detail::e_hash_k1, detail::e_hash_k2)) & _bucket_mask;
+}
+
+bool cuckoo_filter::insert(uint64_t index, uint16_t fp) noexcept {
+  auto *buckets = const_cast<uint64_t *>(_buckets);
+  auto const try_insert = [buckets](uint64_t idx, uint16_t f) {
+    uint64_t const empty = zero_lanes(buckets[idx]);
+    if (!empty)
+      return false;
+    buckets[idx] |= uint64_t(f) << (__builtin_ctzll(empty) - 15);
+    return true;
+  };
+
+  if (try_insert(index, fp) || try_insert(alt_index(index, fp), fp))
+    return true;
+
+  for (size_t kick = 0; kick < e_max_kicks; ++kick) {
+    _rnd ^= _rnd << 13;
+    _rnd ^= _rnd >> 7;
+    _rnd ^= _rnd << 17;
+    unsigned const shift = (_rnd % e_bucket_slots) * 16;
+    auto const evicted = static_cast<uint16_t>(buckets[index] >> shift);
+    buckets[index] = (buckets[index] & ~(uint64_t(0xffff) << shift)) | (uint64_t(fp) << shift);
+    fp = evicted;
+    index = alt_index(index, fp);
+    if (try_insert(index, fp))
+      return true;
+  }
+
+  // filter is full, keep last evicted fingerprint aside
+  _victim_index = index;
+  _victim_fingerprint = fp;
+  return false;
+}
+
+bool cuckoo_filter::add_hash(uint64_t h) noexcept {
+  if (_file.is_open() || _victim_fingerprint)
+    return false;
+  ++_count;
+  insert(h & _bucket_mask, make_fingerprint(h));
+  return true;
+}
+
+bool cuckoo_filter::remove_hash(uint64_t h) noexcept {
+  if (_file.is_open())
+    return false;
+
+  auto *buckets = const_cast<uint64_t *>(_buckets);
+  uint16_t const fp = make_fingerprint(h);
+  uint64_t const index1 = h & _bucket_mask;
+  uint64_t const index2 = alt_index(index1, fp);
+  if (_victim_fingerprint == fp && (_victim_index == index1 || _victim_index == index2)) {
+    _victim_fingerprint = 0;
+    --_count;
+    return true;
+  }
+
+  for (auto index : {index1, index2}) {
+    uint64_t const found = zero_lanes(buckets[index] ^ (fp * lanes_lsb));
+    if (!found)
+      continue;
+    buckets[index] &= ~(uint64_t(0xffff) << (__builtin_ctzll(found) - 15));
+    --_count;
+    if (_victim_fingerprint) {
+      // there is a free slot now
+      uint16_t const victim = _victim_fingerprint;
+      _victim_fingerprint = 0;
+      insert(_victim_index, victim);
+    }
+    return true;
+  }
+  return false;
+}
+
+bool cuckoo_filter::contains_hash(uint64_t h) const noexcept {
+  uint16_t const fp = make_fingerprint(h);
+  uint64_t const index1 = h & _bucket_mask;
+  uint64_t const index2 = alt_index(index1, fp);
+  uint64_t const pattern = fp * lanes_lsb;
+  return zero_lanes(_buckets[index1] ^ pattern) | zero_lanes(_buckets[index2] ^ pattern) ||
+         (_victim_fingerprint == fp && (_victim_index == index1 || _victim_index == index2));
+}
+
+template <typename T> void cuckoo_filter::contains_batch(T const *addrs, size_t size, bool *res) const noexcept {
+  uint64_t hashes[batch_size];
+  for (size_t first = 0; first < size; first += batch_size) {
+    size_t const count = size - first < batch_size ? size - first : batch_size;
+    for (size_t i = 0; i < count; ++i) {
+      hashes[i] = hash(addrs[first + i], _seed);
+      uint64_t const index = hashes[i] & _bucket_mask;
+      __builtin_prefetch(_buckets + index);
+      __builtin_prefetch(_buckets + alt_index(index, make_fingerprint(hashes[i])));
+    }
+    for (size_t i = 0; i < count; ++i)
+      res[first + i] = contains_hash(hashes[i]);
+  }
+}
+
+void cuckoo_filter::contains(v4::address const *addrs, size_t size, bool *res) const noexcept {
+  contains_batch(addrs, size, res);
+}
+
+void cuckoo_filter::contains(v6::address const *addrs, size_t size, bool *res) const noexcept {
+  contains_batch(addrs, size, res);
+}
+
+void cuckoo_filter::contains(address const *addrs, size_t size, bool *res) const noexcept {
+  contains_batch(addrs, size, res);
+}
+
+bool cuckoo_filter::save(std::string const &path) const noexcept {
+  file_header header{};
+  memcpy(header._magic, cuckoo_magic, sizeof(cuckoo_magic));
+  header._version = 1;
+  header._header_size = sizeof(file_header);
+  header._size = _bucket_mask + 1;
+  header._seed = _seed;
+  header._count = _count;
+  header._victim_index = _victim_index;
+  header._victim_fingerprint = _victim_fingerprint;
+  return save_file(path, header, _buckets, get_size_in_bytes());
+}
+
+bool cuckoo_filter::load(std::string const &path) noexcept {
+  mapped_file file;
+  auto const *header = load_file(file, path, cuckoo_magic, sizeof(uint64_t));
+  if (!header || (header->_size & (header->_size - 1)))
+    return false;
+  _bucket_mask = header->_size - 1;
+  _seed = header->_seed;
+  _count = header->_count;
+  _victim_index = header->_victim_index;
+  _victim_fingerprint = static_cast<uint16_t>(header->_victim_fingerprint);
+  _buckets = reinterpret_cast<uint64_t const *>(file.get_data() + header->_header_size);
+  _file = std::move(file);
+  _storage = {};
+  return true;
+}
+
+} // namespace bro::net::proto::ip
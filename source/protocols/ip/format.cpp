@@ -0,0 +1,195 @@
+#include <protocols/ip/format.h>
+
+#include <cstring>
+
+namespace bro::net::proto::ip {
+
+namespace {
+
+constexpr char hex_digits[] = "0123456789abcdef";
+
+inline char *write_decimal(char *out, unsigned value) noexcept {
+  char buffer[5];
+  char *pos = buffer + sizeof(buffer);
+  do {
+    *--pos = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value);
+  return std::copy(pos, buffer + sizeof(buffer), out);
+}
+
+inline char *write_octet(char *out, uint8_t value, bool zero_padded) noexcept {
+  if (zero_padded || value >= 100)
+    *out++ = static_cast<char>('0' + value / 100);
+  if (zero_padded || value >= 10)
+    *out++ = static_cast<char>('0' + value / 10 % 10);
+  *out++ = static_cast<char>('0' + value % 10);
+  return out;
+}
+
+inline char *write_v4(char *out, uint8_t const *bytes, bool zero_padded) noexcept {
+  for (size_t i = 0; i < v4::address::e_bytes_size; ++i) {
+    if (i)
+      *out++ = '.';
+    out = write_octet(out, bytes[i], zero_padded);
+  }
+  return out;
+}
+
+inline char *write_hex_word(char *out, unsigned word, bool expanded) noexcept {
+  bool started = expanded;
+  for (int shift = 12; shift >= 0; shift -= 4) {
+    unsigned const nibble = (word >> shift) & 0xf;
+    if (started || nibble || !shift) {
+      *out++ = hex_digits[nibble];
+      started = true;
+    }
+  }
+  return out;
+}
+
+char *write_v6(char *out, uint8_t const *bytes, bool expanded) noexcept {
+  enum { words_size = 8 };
+  unsigned words[words_size];
+  for (size_t i = 0; i < words_size; ++i)
+    words[i] = (unsigned(bytes[2 * i]) << 8) | bytes[2 * i + 1];
+
+  if (expanded) {
+    for (size_t i = 0; i < words_size; ++i) {
+      if (i)
+        *out++ = ':';
+      out = write_hex_word(out, words[i], true);
+    }
+    return out;
+  }
+
+  // the first longest run of zero words (at least 2) is replaced by "::"
+  int best_base = -1, best_len = 0;
+  for (int i = 0; i < words_size;) {
+    if (words[i]) {
+      ++i;
+      continue;
+    }
+    int len = 0;
+    while (i + len < words_size && !words[i + len])
+      ++len;
+    if (len > best_len) {
+      best_base = i;
+      best_len = len;
+    }
+    i += len;
+  }
+  if (best_len < 2)
+    best_base = -1;
+
+  for (int i = 0; i < words_size; ++i) {
+    if (i == best_base) {
+      *out++ = ':';
+      i += best_len - 1;
+      if (i == words_size - 1)
+        *out++ = ':';
+      continue;
+    }
+    if (i)
+      *out++ = ':';
+    // ipv4 compatible and mapped addresses end with ipv4 (as inet_ntop does)
+    if (i == 6 && best_base == 0 && (best_len == 6 || (best_len == 5 && words[5] == 0xffff)))
+      return write_v4(out, bytes + 12, false);
+    out = write_hex_word(out, words[i], false);
+  }
+  return out;
+}
+
+} // namespace
+
+char *format_to(char *out, v4::address const &addr, format_spec const &spec) noexcept {
+  uint32_t const data = spec._reversed ? addr.reverse_order().get_data() : addr.get_data();
+  uint8_t bytes[v4::address::e_bytes_size];
+  memcpy(bytes, &data, sizeof(bytes));
+  return write_v4(out, bytes, spec._zero_padded);
+}
+
+char *format_to(char *out, v6::address const &addr, format_spec const &spec) noexcept {
+  v6::address const value = spec._reversed ? addr.reverse_order() : addr;
+  if (spec._bracketed)
+    *out++ = '[';
+  out = write_v6(out, value.get_data(), spec._expanded);
+  if (spec._bracketed)
+    *out++ = ']';
+  return out;
+}
+
+char *format_to(char *out, address const &addr, format_spec const &spec) noexcept {
+  switch (addr.get_version()) {
+  case address::version::e_v4:
+    return format_to(out, addr.to_v4(), spec);
+  case address::version::e_v6:
+    return format_to(out, addr.to_v6(), spec);
+  default:
+    break;
+  }
+  return out;
+}
+
+char *format_to(char *out, full_address const &addr, format_spec const &spec) noexcept {
+  out = format_to(out, addr.get_address(), spec);
+  *out++ = ':';
+  return write_decimal(out, addr.get_port());
+}
+
+namespace {
+
+/**
+ * format in place when buffer is large enough, otherwise through stack buffer
+ */
+template <size_t Size, typename Address>
+std::to_chars_result bounded_format(char *first, char *last, Address const &addr, format_spec const &spec) noexcept {
+  if (last - first >= static_cast<std::ptrdiff_t>(Size))
+    return {format_to(first, addr, spec), std::errc()};
+  char buffer[Size];
+  size_t const size = static_cast<size_t>(format_to(buffer, addr, spec) - buffer);
+  if (size > static_cast<size_t>(last - first))
+    return {last, std::errc::value_too_large};
+  memcpy(first, buffer, size);
+  return {first + size, std::errc()};
+}
+
+} // namespace
+
+std::to_chars_result to_chars(char *first, char *last, v4::address const &addr, format_spec const &spec) noexcept {
+  return bounded_format<e_max_v4_string>(first, last, addr, spec);
+}
+
+std::to_chars_result to_chars(char *first, char *last, v6::address const &addr, format_spec const &spec) noexcept {
+  return bounded_format<e_max_v6_string>(first, last, addr, spec);
+}
+
+std::to_chars_result to_chars(char *first, char *last, address const &addr, format_spec const &spec) noexcept {
+  return bounded_format<e_max_v6_string>(first, last, addr, spec);
+}
+
+std::to_chars_result to_chars(char *first, char *last, full_address const &addr, format_spec const &spec) noexcept {
+  return bounded_format<e_max_full_string>(first, last, addr, spec);
+}
+
+v4_string to_inline_string(v4::address const &addr) noexcept {
+  char buffer[e_max_v4_string];
+  return v4_string(buffer, static_cast<size_t>(format_to(buffer, addr) - buffer));
+}
+
+v6_string to_inline_string(v6::address const &addr) noexcept {
+  char buffer[e_max_v6_string];
+  return v6_string(buffer, static_cast<size_t>(format_to(buffer, addr) - buffer));
+}
+
+v6_string to_inline_string(address const &addr) noexcept {
+  char buffer[e_max_v6_string];
+  return v6_string(buffer, static_cast<size_t>(format_to(buffer, addr) - buffer));
+}
+
+full_string to_inline_string(full_address const &addr, format_spec const &spec) noexcept {
+  char buffer[e_max_full_string];
+  return full_string(buffer, static_cast<size_t>(format_to(buffer, addr, spec) - buffer));
+}
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,125 @@
+#include <protocols/ip/generator.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace bro::net::proto::ip {
+
+namespace {
+
+constexpr uint64_t golden_gamma = 0x9e3779b97f4a7c15ULL;
+
+/**
+ * splitmix64 finalizer
+ */
+inline uint64_t mix(uint64_t z) noexcept {
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+inline uint64_t random_value(uint64_t seed, uint64_t counter) noexcept {
+  return mix(seed + counter * golden_gamma);
+}
+
+} // namespace
+
+random_generator::random_generator(prefix const &pref, uint64_t seed) noexcept
+  : _prefix(pref)
+  , _seed(seed) {
+  address const mask = make_mask(pref.get_version(), pref.get_length());
+  switch (pref.get_version()) {
+  case address::version::e_v4:
+    _base[0] = pref.get_address().to_v4().get_data();
+    _mask[0] = ~mask.to_v4().get_data() & UINT32_MAX;
+    break;
+  case address::version::e_v6:
+    memcpy(_base, pref.get_address().to_v6().get_data(), v6::address::e_bytes_size);
+    memcpy(_mask, mask.to_v6().get_data(), v6::address::e_bytes_size);
+    _mask[0] = ~_mask[0];
+    _mask[1] = ~_mask[1];
+    break;
+  default:
+    break;
+  }
+}
+
+address random_generator::operator()() noexcept {
+  address addr;
+  generate(&addr, 1);
+  return addr;
+}
+
+void random_generator::generate(address *out, size_t size) noexcept {
+  switch (_prefix.get_version()) {
+  case address::version::e_v4:
+    for (size_t i = 0; i < size; ++i)
+      out[i] = v4::address(static_cast<uint32_t>(_base[0] | (random_value(_seed, _counter + i) & _mask[0])));
+    _counter += size;
+    break;
+  case address::version::e_v6:
+    for (size_t i = 0; i < size; ++i) {
+      uint64_t const counter = _counter + 2 * i;
+      out[i] = v6::address(_base[0] | (random_value(_seed, counter) & _mask[0]),
+                           _base[1] | (random_value(_seed, counter + 1) & _mask[1]));
+    }
+    _counter += 2 * size;
+    break;
+  default:
+    std::fill(out, out + size, address());
+    break;
+  }
+}
+
+bool random_generator::generate(v4::address *out, size_t size) noexcept {
+  if (_prefix.get_version() != address::version::e_v4)
+    return false;
+  uint32_t const base = static_cast<uint32_t>(_base[0]);
+  uint32_t const mask = static_cast<uint32_t>(_mask[0]);
+  for (size_t i = 0; i < size; ++i)
+    out[i] = v4::address(base | (static_cast<uint32_t>(random_value(_seed, _counter + i)) & mask));
+  _counter += size;
+  return true;
+}
+
+bool random_generator::generate(v6::address *out, size_t size) noexcept {
+  if (_prefix.get_version() != address::version::e_v6)
+    return false;
+  for (size_t i = 0; i < size; ++i) {
+    uint64_t const counter = _counter + 2 * i;
+    out[i] = v6::address(_base[0] | (random_value(_seed, counter) & _mask[0]),
+                         _base[1] | (random_value(_seed, counter + 1) & _mask[1]));
+  }
+  _counter += 2 * size;
+  return true;
+}
+
+permutation::permutation(prefix const &pref, uint64_t seed) noexcept
+  : _prefix(pref)
+  , _base(to_number(pref.get_address()))
+  , _host_bits(static_cast<uint8_t>(max_prefix_length(pref.get_version()) - pref.get_length())) {
+  _mask = _host_bits < 128 ? (uint128_t(1) << _host_bits) - 1 : ~uint128_t(0);
+  _shift = static_cast<uint8_t>((_host_bits + 1) / 2);
+  for (size_t i = 0; i < std::size(_keys); ++i) {
+    _keys[i] = (uint128_t(random_value(seed, 2 * i + 1)) << 64) | random_value(seed, 2 * i + 2);
+    // multipliers must be odd to be invertible modulo 2^host_bits
+    if (i % 2 == 0)
+      _keys[i] |= 1;
+  }
+}
+
+address permutation::operator[](uint128_t index) const noexcept {
+  uint128_t value = index & _mask;
+  if (_host_bits) {
+    // every step is a bijection on host_bits wide numbers
+    for (size_t i = 0; i < std::size(_keys); i += 2) {
+      value = (value * _keys[i]) & _mask;
+      value ^= value >> _shift;
+      value = (value + _keys[i + 1]) & _mask;
+    }
+    value ^= value >> _shift;
+  }
+  return to_address(_base | value, _prefix.get_version());
+}
+
+} // namespace bro::net::proto::ip
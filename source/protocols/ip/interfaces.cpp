@@ -0,0 +1,215 @@
+#include <protocols/ip/interfaces.h>
+
+#include <cerrno>
+#include <map>
+#ifdef __linux__
+#include <ifaddrs.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif // __linux__
+
+namespace bro::net::proto::ip {
+
+namespace {
+
+/**
+ * listener wakes up at least this often to check stop flag
+ */
+constexpr int poll_timeout_ms = 100;
+
+/**
+ * snapshot of lookup_scope_id()
+ */
+rcu_ptr<interface_table> &get_shared_table() {
+  static rcu_ptr<interface_table> table;
+  return table;
+}
+
+/**
+ * number of started monitors, while there is one shared snapshot is current
+ */
+std::atomic<unsigned> started_monitors{0};
+
+#ifdef __linux__
+uint8_t prefix_length(sockaddr const *netmask) noexcept {
+  if (!netmask)
+    return 0;
+  uint8_t const *bytes = nullptr;
+  size_t size = 0;
+  if (netmask->sa_family == AF_INET) {
+    bytes = reinterpret_cast<uint8_t const *>(&reinterpret_cast<sockaddr_in const *>(netmask)->sin_addr);
+    size = sizeof(in_addr);
+  } else if (netmask->sa_family == AF_INET6) {
+    bytes = reinterpret_cast<uint8_t const *>(&reinterpret_cast<sockaddr_in6 const *>(netmask)->sin6_addr);
+    size = sizeof(in6_addr);
+  }
+  uint8_t res = 0;
+  for (size_t i = 0; i < size; ++i)
+    res += static_cast<uint8_t>(__builtin_popcount(bytes[i]));
+  return res;
+}
+#endif // __linux__
+
+} // namespace
+
+interface_table::interface_table(std::vector<interface> interfaces)
+  : _interfaces(std::move(interfaces)) {
+  for (size_t i = 0; i < _interfaces.size(); ++i) {
+    _by_index.emplace(_interfaces[i]._index, i);
+    for (auto const &addr : _interfaces[i]._addresses)
+      _by_address.emplace(addr._address, &addr);
+  }
+}
+
+std::unique_ptr<interface_table const> interface_table::load() {
+  std::vector<interface> interfaces;
+#ifdef __linux__
+  ifaddrs *ifap = nullptr;
+  if (getifaddrs(&ifap) != 0)
+    return std::make_unique<interface_table const>();
+
+  std::map<std::string, size_t> by_name;
+  for (ifaddrs *ifa = ifap; ifa; ifa = ifa->ifa_next) {
+    if (!ifa->ifa_name)
+      continue;
+    auto it = by_name.find(ifa->ifa_name);
+    if (it == by_name.end()) {
+      interface iface;
+      iface._index = if_nametoindex(ifa->ifa_name);
+      iface._flags = ifa->ifa_flags;
+      iface._name = ifa->ifa_name;
+      interfaces.push_back(std::move(iface));
+      it = by_name.emplace(ifa->ifa_name, interfaces.size() - 1).first;
+    }
+
+    auto &iface = interfaces[it->second];
+    if (!ifa->ifa_addr)
+      continue;
+    interface_address addr;
+    if (ifa->ifa_addr->sa_family == AF_INET) {
+      addr._address = reinterpret_cast<sockaddr_in const *>(ifa->ifa_addr)->sin_addr;
+    } else if (ifa->ifa_addr->sa_family == AF_INET6) {
+      auto const *in6 = reinterpret_cast<sockaddr_in6 const *>(ifa->ifa_addr);
+      addr._address = in6->sin6_addr;
+      addr._scope_id = in6->sin6_scope_id;
+    } else {
+      continue;
+    }
+    addr._prefix_length = prefix_length(ifa->ifa_netmask);
+    addr._index = iface._index;
+    iface._addresses.push_back(addr);
+  }
+  freeifaddrs(ifap);
+#endif // __linux__
+  return std::make_unique<interface_table const>(std::move(interfaces));
+}
+
+interface const *interface_table::find(uint32_t index) const noexcept {
+  auto it = _by_index.find(index);
+  return it == _by_index.end() ? nullptr : &_interfaces[it->second];
+}
+
+interface_address const *interface_table::find(address const &addr) const noexcept {
+  auto it = _by_address.find(addr);
+  return it == _by_address.end() ? nullptr : it->second;
+}
+
+interface_monitor::interface_monitor()
+  : _table(interface_table::load()) {}
+
+interface_monitor::~interface_monitor() {
+  stop();
+}
+
+void interface_monitor::refresh() {
+  auto table = interface_table::load();
+  if (_socket >= 0)
+    get_shared_table().update(std::make_unique<interface_table const>(table->get_interfaces()));
+  _table.update(std::move(table));
+}
+
+bool interface_monitor::start() {
+#ifdef __linux__
+  if (_listener.joinable())
+    return true;
+
+  _socket = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+  if (_socket < 0)
+    return false;
+
+  sockaddr_nl local{};
+  local.nl_family = AF_NETLINK;
+  local.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR;
+  if (bind(_socket, reinterpret_cast<sockaddr *>(&local), sizeof(local)) != 0) {
+    close(_socket);
+    _socket = -1;
+    return false;
+  }
+
+  // changes made before subscription would be lost otherwise
+  refresh();
+  ++started_monitors;
+  _stop = false;
+  _listener = std::thread(&interface_monitor::listen, this);
+  return true;
+#else
+  return false;
+#endif // __linux__
+}
+
+void interface_monitor::stop() {
+  if (!_listener.joinable())
+    return;
+  _stop = true;
+  _listener.join();
+  --started_monitors;
+#ifdef __linux__
+  close(_socket);
+#endif // __linux__
+  _socket = -1;
+}
+
+void interface_monitor::listen() {
+#ifdef __linux__
+  char buffer[8192];
+  while (!_stop) {
+    pollfd pfd{_socket, POLLIN, 0};
+    if (poll(&pfd, 1, poll_timeout_ms) <= 0)
+      continue;
+
+    // one reload for all pending notifications
+    bool changed = false;
+    ssize_t rc;
+    while ((rc = recv(_socket, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0)
+      changed = true;
+    // ENOBUFS: kernel dropped notifications, snapshot may be stale
+    if (changed || (rc < 0 && errno == ENOBUFS))
+      refresh();
+  }
+#endif // __linux__
+}
+
+bool lookup_scope_id(address const &addr, uint32_t &scope_id) {
+  auto &shared = get_shared_table();
+  {
+    auto const table = shared.read();
+    auto const *local = table ? table->find(addr) : nullptr;
+    if (local || (table && started_monitors.load(std::memory_order_acquire))) {
+      scope_id = local ? local->_scope_id : 0;
+      return local;
+    }
+  }
+
+  // nobody follows interface changes, address may have been added since last load
+  auto table = interface_table::load();
+  auto const *local = table->find(addr);
+  scope_id = local ? local->_scope_id : 0;
+  shared.update(std::move(table));
+  return local;
+}
+
+} // namespace bro::net::proto::ip
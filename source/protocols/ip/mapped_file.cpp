@@ -0,0 +1,70 @@
+#include <protocols/ip/mapped_file.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // __linux__
+
+namespace bro::net::proto::ip {
+
+mapped_file::~mapped_file() {
+  close();
+}
+
+mapped_file::mapped_file(mapped_file &&file) noexcept
+  : _data(file._data)
+  , _size(file._size) {
+  file._data = nullptr;
+  file._size = 0;
+}
+
+mapped_file &mapped_file::operator=(mapped_file &&file) noexcept {
+  if (this != &file) {
+    close();
+    _data = file._data;
+    _size = file._size;
+    file._data = nullptr;
+    file._size = 0;
+  }
+  return *this;
+}
+
+bool mapped_file::open(std::string const &path) noexcept {
+  close();
+#ifdef __linux__
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    ::close(fd);
+    return false;
+  }
+
+  void *data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED)
+    return false;
+
+  _data = static_cast<uint8_t const *>(data);
+  _size = static_cast<size_t>(st.st_size);
+  return true;
+#else
+  (void) path;
+  return false;
+#endif // __linux__
+}
+
+void mapped_file::close() noexcept {
+#ifdef __linux__
+  if (_data)
+    munmap(const_cast<uint8_t *>(_data), _size);
+#endif // __linux__
+  _data = nullptr;
+  _size = 0;
+}
+
+} // namespace bro::net::proto::ip
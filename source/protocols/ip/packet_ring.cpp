@@ -0,0 +1,178 @@
+#include <protocols/ip/packet_ring.h>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <linux/if_packet.h>
+#include <net/ethernet.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif // __linux__
+
+namespace bro::net::proto::ip {
+
+packet_ring::~packet_ring() {
+  close();
+}
+
+#ifdef __linux__
+
+namespace {
+
+inline tpacket_block_desc *get_block(uint8_t *map, uint32_t block_size, uint32_t index) noexcept {
+  return reinterpret_cast<tpacket_block_desc *>(map + size_t(index) * block_size);
+}
+
+} // namespace
+
+bool packet_ring::open(std::string const &interface, config const &conf) noexcept {
+  close();
+  unsigned index = 0;
+  if (!interface.empty() && !(index = if_nametoindex(interface.c_str())))
+    return false;
+
+  _fd = socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, htons(ETH_P_ALL));
+  if (_fd < 0)
+    return false;
+
+  int const version = TPACKET_V3;
+  tpacket_req3 req{};
+  req.tp_block_size = conf._block_size;
+  req.tp_block_nr = conf._block_count;
+  req.tp_frame_size = conf._frame_size;
+  req.tp_frame_nr = conf._frame_size ? conf._block_size / conf._frame_size * conf._block_count : 0;
+  req.tp_retire_blk_tov = conf._block_timeout_ms;
+  size_t const map_size = size_t(conf._block_size) * conf._block_count;
+
+  sockaddr_ll addr{};
+  addr.sll_family = AF_PACKET;
+  addr.sll_protocol = htons(ETH_P_ALL);
+  addr.sll_ifindex = static_cast<int>(index);
+
+  void *map = MAP_FAILED;
+  if (setsockopt(_fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) != 0 ||
+      setsockopt(_fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) != 0 ||
+      (map = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0)) == MAP_FAILED ||
+      bind(_fd, reinterpret_cast<sockaddr const *>(&addr), sizeof(addr)) != 0) {
+    int const error = errno;
+    if (map != MAP_FAILED)
+      munmap(map, map_size);
+    ::close(_fd);
+    _fd = -1;
+    errno = error;
+    return false;
+  }
+
+  _map = static_cast<uint8_t *>(map);
+  _map_size = map_size;
+  _block_size = conf._block_size;
+  _block_count = conf._block_count;
+  return true;
+}
+
+void packet_ring::close() noexcept {
+  if (_map)
+    munmap(_map, _map_size);
+  if (_fd >= 0)
+    ::close(_fd);
+  _fd = -1;
+  _map = nullptr;
+  _map_size = 0;
+  _block_size = 0;
+  _block_count = 0;
+  _block_index = 0;
+  _frame = nullptr;
+  _frames_left = 0;
+}
+
+bool packet_ring::wait_block(int timeout_ms) noexcept {
+  auto const *block = get_block(_map, _block_size, _block_index);
+  if (__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER)
+    return true;
+
+  pollfd pfd{};
+  pfd.fd = _fd;
+  pfd.events = POLLIN | POLLERR;
+  if (poll(&pfd, 1, timeout_ms) <= 0)
+    return false;
+  return __atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER;
+}
+
+void packet_ring::release_block() noexcept {
+  auto *block = get_block(_map, _block_size, _block_index);
+  __atomic_store_n(&block->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+  _block_index = (_block_index + 1) % _block_count;
+  _frame = nullptr;
+  _frames_left = 0;
+}
+
+size_t packet_ring::read(packet *frames, flow_keys &keys, int timeout_ms) noexcept {
+  if (!_map)
+    return 0;
+  // frames of exhausted block were handed out by previous read
+  if (_frame && !_frames_left)
+    release_block();
+
+  if (!_frame) {
+    if (!wait_block(timeout_ms))
+      return 0;
+    auto *block = get_block(_map, _block_size, _block_index);
+    _frame = reinterpret_cast<uint8_t const *>(block) + block->hdr.bh1.offset_to_first_pkt;
+    _frames_left = block->hdr.bh1.num_pkts;
+    if (!_frames_left) {
+      release_block();
+      return 0;
+    }
+  }
+
+  size_t size = 0;
+  for (size_t const capacity = keys.capacity(); size < capacity && _frames_left; ++size) {
+    auto const *header = reinterpret_cast<tpacket3_hdr const *>(_frame);
+    frames[size] = packet{_frame + header->tp_mac, header->tp_snaplen};
+    _frame += header->tp_next_offset;
+    --_frames_left;
+  }
+  classify(frames, size, keys);
+  return size;
+}
+
+bool packet_ring::get_statistics(statistics &stats) const noexcept {
+  tpacket_stats_v3 native{};
+  socklen_t size = sizeof(native);
+  if (_fd < 0 || getsockopt(_fd, SOL_PACKET, PACKET_STATISTICS, &native, &size) != 0)
+    return false;
+  stats._packets = native.tp_packets;
+  stats._drops = native.tp_drops;
+  stats._freeze_count = native.tp_freeze_q_cnt;
+  return true;
+}
+
+#else
+
+bool packet_ring::open(std::string const &, config const &) noexcept {
+  return false;
+}
+
+void packet_ring::close() noexcept {}
+
+bool packet_ring::wait_block(int) noexcept {
+  return false;
+}
+
+void packet_ring::release_block() noexcept {}
+
+size_t packet_ring::read(packet *, flow_keys &, int) noexcept {
+  return 0;
+}
+
+bool packet_ring::get_statistics(statistics &) const noexcept {
+  return false;
+}
+
+#endif // __linux__
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,68 @@
+#include <protocols/ip/prefix.h>
+
+#include <ostream>
+
+namespace bro::net::proto::ip {
+
+address make_mask(address::version ver, uint8_t length) noexcept {
+  uint8_t const max_length = max_prefix_length(ver);
+  if (length > max_length)
+    length = max_length;
+  uint8_t bytes[v6::address::e_bytes_size] = {0};
+  for (uint8_t i = 0; i < length / 8; ++i)
+    bytes[i] = 0xff;
+  if (length % 8)
+    bytes[length / 8] = static_cast<uint8_t>(0xff << (8 - length % 8));
+
+  switch (ver) {
+  case address::version::e_v4:
+    return address(v4::address(bytes[0], bytes[1], bytes[2], bytes[3]));
+  case address::version::e_v6:
+    return address(v6::address(bytes));
+  default:
+    break;
+  }
+  return {};
+}
+
+prefix::prefix(address const &addr, uint8_t length) noexcept
+  : _address(addr & make_mask(addr.get_version(), length))
+  , _length(length > max_prefix_length(addr.get_version()) ? max_prefix_length(addr.get_version()) : length) {}
+
+prefix::prefix(std::string const &str) noexcept {
+  string_to_prefix(str, *this);
+}
+
+std::string prefix::to_string() const {
+  return _address.to_string() + "/" + std::to_string(_length);
+}
+
+bool string_to_prefix(std::string const &str_prefix, prefix &pref) noexcept {
+  auto const pos = str_prefix.find('/');
+  if (pos == std::string::npos)
+    return false;
+
+  address addr;
+  if (!string_to_address(str_prefix.substr(0, pos), addr))
+    return false;
+
+  unsigned length = 0;
+  size_t digits = 0;
+  for (size_t i = pos + 1; i < str_prefix.size(); ++i, ++digits) {
+    char const c = str_prefix[i];
+    if (c < '0' || c > '9' || digits == 3)
+      return false;
+    length = length * 10 + static_cast<unsigned>(c - '0');
+  }
+  if (!digits || length > max_prefix_length(addr.get_version()))
+    return false;
+
+  pref = prefix(addr, static_cast<uint8_t>(length));
+  return true;
+}
+
+std::ostream &operator<<(std::ostream &strm, prefix const &pref) {
+  return strm << pref.to_string();
+}
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,294 @@
+#include <protocols/ip/endpoint.h>
+#include <protocols/ip/format.h>
+#include <protocols/ip/proxy_protocol.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+namespace bro::net::proto::ip::proxy {
+
+namespace {
+
+constexpr char v1_signature[] = {'P', 'R', 'O', 'X', 'Y', ' '};
+constexpr uint8_t v2_signature[] = {0x0d, 0x0a, 0x0d, 0x0a, 0x00, 0x0d, 0x0a, 0x51, 0x55, 0x49, 0x54, 0x0a};
+
+/**
+ * v2 address families
+ */
+enum family : uint8_t { e_unspec = 0, e_inet = 1, e_inet6 = 2, e_unix = 3 };
+
+enum {
+  e_v2_version = 0x20,     ///< version in high nibble of version/command byte
+  e_inet_size = 12,        ///< ipv4 addresses and ports
+  e_inet6_size = 36,       ///< ipv6 addresses and ports
+  e_unix_size = 216,       ///< unix socket paths
+  e_tlv_header_size = 3    ///< tlv type and length
+};
+
+inline uint16_t read_be16(uint8_t const *data) noexcept {
+  return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+inline uint8_t *write_be16(uint8_t *out, uint16_t value) noexcept {
+  *out++ = static_cast<uint8_t>(value >> 8);
+  *out++ = static_cast<uint8_t>(value);
+  return out;
+}
+
+inline char *write_decimal(char *out, unsigned value) noexcept {
+  char buffer[5];
+  char *pos = buffer + sizeof(buffer);
+  do {
+    *--pos = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value);
+  return std::copy(pos, buffer + sizeof(buffer), out);
+}
+
+/**
+ * get next space separated token
+ */
+bool next_token(std::string_view &line, std::string_view &token) noexcept {
+  auto const pos = std::min(line.find(' '), line.size());
+  if (!pos)
+    return false;
+  token = line.substr(0, pos);
+  line.remove_prefix(std::min(pos + 1, line.size()));
+  return true;
+}
+
+bool parse_port(std::string_view str, uint16_t &port) noexcept {
+  if (str.empty() || str.size() > 5)
+    return false;
+  uint32_t value = 0;
+  for (char const c : str) {
+    if (c < '0' || c > '9')
+      return false;
+    value = value * 10 + static_cast<uint32_t>(c - '0');
+  }
+  if (value > UINT16_MAX)
+    return false;
+  port = static_cast<uint16_t>(value);
+  return true;
+}
+
+status parse_v1(uint8_t const *data, size_t size, header &hdr) noexcept {
+  if (memcmp(data, v1_signature, std::min(size, sizeof(v1_signature))))
+    return status::e_invalid;
+
+  char const *const begin = reinterpret_cast<char const *>(data);
+  char const *const last = begin + std::min<size_t>(size, e_v1_max_size);
+  char const *const eol = std::find(begin, last, '\n');
+  if (eol == last)
+    return size < e_v1_max_size ? status::e_incomplete : status::e_invalid;
+  if (eol - begin < static_cast<ptrdiff_t>(sizeof(v1_signature)) + 1 || eol[-1] != '\r')
+    return status::e_invalid;
+
+  std::string_view line(begin + sizeof(v1_signature), static_cast<size_t>(eol - 1 - begin) - sizeof(v1_signature));
+  std::string_view proto;
+  if (!next_token(line, proto))
+    return status::e_invalid;
+
+  hdr = header{};
+  hdr._version = 1;
+  hdr._command = command::e_proxy;
+  hdr._size = static_cast<size_t>(eol + 1 - begin);
+  if (proto == "UNKNOWN") {
+    hdr._transport = transport::e_unspec;
+    return status::e_ok;
+  }
+
+  address::version ver;
+  if (proto == "TCP4")
+    ver = address::version::e_v4;
+  else if (proto == "TCP6")
+    ver = address::version::e_v6;
+  else
+    return status::e_invalid;
+
+  std::string_view tokens[4];
+  for (auto &token : tokens) {
+    if (!next_token(line, token))
+      return status::e_invalid;
+  }
+  address source, destination;
+  uint16_t source_port = 0, destination_port = 0;
+  if (!line.empty() || !parse_address(tokens[0], source) || !parse_address(tokens[1], destination) ||
+      source.get_version() != ver || destination.get_version() != ver || !parse_port(tokens[2], source_port) ||
+      !parse_port(tokens[3], destination_port))
+    return status::e_invalid;
+
+  hdr._transport = transport::e_stream;
+  hdr._source = full_address(source, source_port);
+  hdr._destination = full_address(destination, destination_port);
+  return status::e_ok;
+}
+
+status parse_v2(uint8_t const *data, size_t size, header &hdr) noexcept {
+  if (memcmp(data, v2_signature, std::min(size, sizeof(v2_signature))))
+    return status::e_invalid;
+  if (size < e_v2_header_size)
+    return status::e_incomplete;
+
+  uint8_t const version_command = data[sizeof(v2_signature)];
+  uint8_t const family_transport = data[sizeof(v2_signature) + 1];
+  size_t const length = read_be16(data + sizeof(v2_signature) + 2);
+  if ((version_command & 0xf0) != e_v2_version || (version_command & 0x0f) > 1 || (family_transport >> 4) > e_unix ||
+      (family_transport & 0x0f) > 2)
+    return status::e_invalid;
+  if (size < e_v2_header_size + length)
+    return status::e_incomplete;
+
+  static constexpr size_t address_sizes[] = {0, e_inet_size, e_inet6_size, e_unix_size};
+  auto const fam = static_cast<family>(family_transport >> 4);
+  size_t const address_size = address_sizes[fam];
+  if (length < address_size)
+    return status::e_invalid;
+
+  uint8_t const *const body = data + e_v2_header_size;
+  hdr = header{};
+  hdr._version = 2;
+  hdr._command = (version_command & 0x0f) ? command::e_proxy : command::e_local;
+  hdr._transport = static_cast<transport>(family_transport & 0x0f);
+  if (hdr._command == command::e_proxy && fam == e_inet) {
+    uint8_t source[v4::address::e_bytes_size], destination[v4::address::e_bytes_size];
+    memcpy(source, body, sizeof(source));
+    memcpy(destination, body + sizeof(source), sizeof(destination));
+    hdr._source = full_address(v4::address(source), read_be16(body + 8));
+    hdr._destination = full_address(v4::address(destination), read_be16(body + 10));
+  } else if (hdr._command == command::e_proxy && fam == e_inet6) {
+    uint8_t source[v6::address::e_bytes_size], destination[v6::address::e_bytes_size];
+    memcpy(source, body, sizeof(source));
+    memcpy(destination, body + sizeof(source), sizeof(destination));
+    hdr._source = full_address(v6::address(source), read_be16(body + 32));
+    hdr._destination = full_address(v6::address(destination), read_be16(body + 34));
+  }
+  hdr._tlvs = body + address_size;
+  hdr._tlvs_size = length - address_size;
+  hdr._size = e_v2_header_size + length;
+
+  // tlvs must fill the area exactly
+  for (size_t offset = 0; offset < hdr._tlvs_size;) {
+    if (hdr._tlvs_size - offset < e_tlv_header_size)
+      return status::e_invalid;
+    offset += e_tlv_header_size + read_be16(hdr._tlvs + offset + 1);
+    if (offset > hdr._tlvs_size)
+      return status::e_invalid;
+  }
+  return status::e_ok;
+}
+
+} // namespace
+
+status parse(uint8_t const *data, size_t size, header &hdr) noexcept {
+  if (!size)
+    return status::e_incomplete;
+  if (data[0] == static_cast<uint8_t>(v1_signature[0]))
+    return parse_v1(data, size, hdr);
+  if (data[0] == v2_signature[0])
+    return parse_v2(data, size, hdr);
+  return status::e_invalid;
+}
+
+bool next_tlv(header const &hdr, size_t &offset, tlv &value) noexcept {
+  if (offset + e_tlv_header_size > hdr._tlvs_size)
+    return false;
+  value._type = hdr._tlvs[offset];
+  value._length = read_be16(hdr._tlvs + offset + 1);
+  value._value = hdr._tlvs + offset + e_tlv_header_size;
+  offset += e_tlv_header_size + value._length;
+  return true;
+}
+
+bool find_tlv(header const &hdr, uint8_t type, tlv &value) noexcept {
+  for (size_t offset = 0; next_tlv(hdr, offset, value);) {
+    if (value._type == type)
+      return true;
+  }
+  return false;
+}
+
+size_t serialize_v1(header const &hdr, uint8_t *out, size_t size) noexcept {
+  char buffer[e_v1_max_size];
+  char *const begin = size >= e_v1_max_size ? reinterpret_cast<char *>(out) : buffer;
+  char *pos = std::copy(std::begin(v1_signature), std::end(v1_signature), begin);
+
+  auto const &source = hdr._source.get_address();
+  auto const &destination = hdr._destination.get_address();
+  auto const ver = source.get_version();
+  if (hdr._command == command::e_proxy && hdr._transport == transport::e_stream && ver == destination.get_version() &&
+      ver != address::version::e_none) {
+    constexpr std::string_view tcp4 = "TCP4 ", tcp6 = "TCP6 ";
+    pos = ver == address::version::e_v4 ? std::copy(tcp4.begin(), tcp4.end(), pos)
+                                         : std::copy(tcp6.begin(), tcp6.end(), pos);
+    pos = format_to(pos, source);
+    *pos++ = ' ';
+    pos = format_to(pos, destination);
+    *pos++ = ' ';
+    pos = write_decimal(pos, hdr._source.get_port());
+    *pos++ = ' ';
+    pos = write_decimal(pos, hdr._destination.get_port());
+  } else {
+    constexpr std::string_view unknown = "UNKNOWN";
+    pos = std::copy(unknown.begin(), unknown.end(), pos);
+  }
+  *pos++ = '\r';
+  *pos++ = '\n';
+
+  size_t const written = static_cast<size_t>(pos - begin);
+  if (begin == buffer) {
+    if (written > size)
+      return 0;
+    memcpy(out, buffer, written);
+  }
+  return written;
+}
+
+size_t serialize_v2(header const &hdr, tlv const *tlvs, size_t tlvs_count, uint8_t *out, size_t size) noexcept {
+  auto const &source = hdr._source.get_address();
+  auto const &destination = hdr._destination.get_address();
+  auto const ver = source.get_version();
+  family fam = e_unspec;
+  size_t length = 0;
+  if (hdr._command == command::e_proxy && ver == destination.get_version()) {
+    if (ver == address::version::e_v4) {
+      fam = e_inet;
+      length = e_inet_size;
+    } else if (ver == address::version::e_v6) {
+      fam = e_inet6;
+      length = e_inet6_size;
+    }
+  }
+  for (size_t i = 0; i < tlvs_count; ++i)
+    length += e_tlv_header_size + tlvs[i]._length;
+  if (length > UINT16_MAX || e_v2_header_size + length > size)
+    return 0;
+
+  uint8_t *pos = std::copy(std::begin(v2_signature), std::end(v2_signature), out);
+  *pos++ = static_cast<uint8_t>(e_v2_version | (hdr._command == command::e_proxy ? 1 : 0));
+  *pos++ = fam == e_unspec ? 0 : static_cast<uint8_t>((fam << 4) | static_cast<uint8_t>(hdr._transport));
+  pos = write_be16(pos, static_cast<uint16_t>(length));
+  if (fam == e_inet) {
+    uint32_t const addrs[] = {source.to_v4().get_data(), destination.to_v4().get_data()};
+    memcpy(pos, addrs, sizeof(addrs));
+    pos += sizeof(addrs);
+  } else if (fam == e_inet6) {
+    memcpy(pos, source.to_v6().get_data(), v6::address::e_bytes_size);
+    memcpy(pos + v6::address::e_bytes_size, destination.to_v6().get_data(), v6::address::e_bytes_size);
+    pos += 2 * v6::address::e_bytes_size;
+  }
+  if (fam != e_unspec) {
+    pos = write_be16(pos, hdr._source.get_port());
+    pos = write_be16(pos, hdr._destination.get_port());
+  }
+  for (size_t i = 0; i < tlvs_count; ++i) {
+    *pos++ = tlvs[i]._type;
+    pos = write_be16(pos, tlvs[i]._length);
+    if (tlvs[i]._length)
+      pos = std::copy(tlvs[i]._value, tlvs[i]._value + tlvs[i]._length, pos);
+  }
+  return static_cast<size_t>(pos - out);
+}
+
+} // namespace bro::net::proto::ip::proxy
@@ -0,0 +1,585 @@
+#include <protocols/ip/endpoint.h>
+#include <protocols/ip/resolver.h>
+#include <protocols/ip/translate.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#ifdef __linux__
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif // __linux__
+
+namespace bro::net::proto::ip {
+
+namespace {
+
+enum : uint16_t {
+  e_type_a = 1,     ///< ipv4 address record
+  e_type_aaaa = 28, ///< ipv6 address record
+  e_class_in = 1    ///< internet class
+};
+
+enum : uint8_t {
+  e_rcode_ok = 0,      ///< no error
+  e_rcode_nxdomain = 3 ///< name doesn't exist
+};
+
+enum : uint16_t {
+  e_flag_response = 0x8000, ///< message is response
+  e_flag_truncated = 0x0200 ///< message is truncated (TC)
+};
+
+enum {
+  e_header_size = 12,    ///< dns header size
+  e_max_name = 255,      ///< max encoded name size
+  e_max_label = 63,      ///< max label size
+  e_max_message = 4096,  ///< max received message size
+  e_dns_port = 53,       ///< default server port
+  e_eviction_ms = 1000   ///< period of expired cache entries sweep
+};
+
+constexpr uint16_t query_types[2] = {e_type_a, e_type_aaaa};
+
+inline uint16_t load_be16(uint8_t const *data) noexcept {
+  return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+inline uint32_t load_be32(uint8_t const *data) noexcept {
+  return (uint32_t(data[0]) << 24) | (uint32_t(data[1]) << 16) | (uint32_t(data[2]) << 8) | data[3];
+}
+
+inline uint8_t *store_be16(uint8_t *out, uint16_t value) noexcept {
+  out[0] = static_cast<uint8_t>(value >> 8);
+  out[1] = static_cast<uint8_t>(value);
+  return out + 2;
+}
+
+inline char to_lower(char c) noexcept {
+  return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+/**
+ * lower case name without trailing dot
+ */
+std::string normalize_name(std::string_view name) {
+  if (!name.empty() && name.back() == '.')
+    name.remove_suffix(1);
+  std::string res(name);
+  std::transform(res.begin(), res.end(), res.begin(), to_lower);
+  return res;
+}
+
+inline bool is_label_char(char c) noexcept {
+  return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+}
+
+/**
+ * write query message
+ *
+ * @param name normalized name
+ * @return message size or 0 if name is invalid
+ */
+size_t build_query(std::string_view name, uint16_t id, uint16_t type, uint8_t (&out)[e_header_size + e_max_name + 4]) {
+  if (name.empty() || name.size() + 2 > e_max_name)
+    return 0;
+  uint8_t *p = store_be16(out, id);
+  p = store_be16(p, 0x0100); // recursion desired
+  p = store_be16(p, 1);
+  p = store_be16(p, 0);
+  p = store_be16(p, 0);
+  p = store_be16(p, 0);
+  for (size_t first = 0; first <= name.size();) {
+    size_t last = name.find('.', first);
+    if (last == std::string_view::npos)
+      last = name.size();
+    size_t const size = last - first;
+    if (!size || size > e_max_label ||
+        !std::all_of(name.begin() + static_cast<ptrdiff_t>(first), name.begin() + static_cast<ptrdiff_t>(last),
+                     is_label_char))
+      return 0;
+    *p++ = static_cast<uint8_t>(size);
+    memcpy(p, name.data() + first, size);
+    p += size;
+    first = last + 1;
+  }
+  *p++ = 0;
+  p = store_be16(p, type);
+  p = store_be16(p, e_class_in);
+  return static_cast<size_t>(p - out);
+}
+
+/**
+ * skip encoded name (with compression)
+ *
+ * @return offset after name or 0 if name is malformed
+ */
+size_t skip_name(uint8_t const *data, size_t size, size_t offset) noexcept {
+  while (offset < size) {
+    uint8_t const length = data[offset];
+    if (!length)
+      return offset + 1;
+    if ((length & 0xc0) == 0xc0)
+      return offset + 2 <= size ? offset + 2 : 0;
+    if (length & 0xc0)
+      return 0;
+    offset += 1 + size_t(length);
+  }
+  return 0;
+}
+
+/**
+ * check question of answer (it is never compressed)
+ *
+ * @return offset after question or 0 if question doesn't match
+ */
+size_t check_question(uint8_t const *data, size_t size, std::string_view name, uint16_t type) noexcept {
+  size_t offset = e_header_size;
+  for (size_t first = 0; first <= name.size();) {
+    size_t last = name.find('.', first);
+    if (last == std::string_view::npos)
+      last = name.size();
+    size_t const length = last - first;
+    if (offset + 1 + length > size || data[offset] != length)
+      return 0;
+    for (size_t i = 0; i < length; ++i) {
+      if (to_lower(static_cast<char>(data[offset + 1 + i])) != name[first + i])
+        return 0;
+    }
+    offset += 1 + length;
+    first = last + 1;
+  }
+  if (offset + 5 > size || data[offset] || load_be16(data + offset + 1) != type ||
+      load_be16(data + offset + 3) != e_class_in)
+    return 0;
+  return offset + 5;
+}
+
+} // namespace
+
+std::vector<full_address> make_endpoints(std::vector<address> const &addrs, uint16_t port) {
+  std::vector<full_address> res;
+  res.reserve(addrs.size());
+  for (auto const &addr : addrs)
+    res.emplace_back(addr, port);
+  return res;
+}
+
+bool hosts_table::load(std::string const &path) {
+  std::ifstream file(path);
+  if (!file)
+    return false;
+  std::stringstream content;
+  content << file.rdbuf();
+  parse(content.str());
+  return true;
+}
+
+void hosts_table::parse(std::string_view content) {
+  auto const is_space = [](char c) { return c == ' ' || c == '\t' || c == '\r'; };
+  while (!content.empty()) {
+    size_t const end = std::min(content.find('\n'), content.size());
+    std::string_view line = content.substr(0, std::min(content.find('#'), end));
+    content.remove_prefix(std::min(end + 1, content.size()));
+
+    address addr;
+    bool first = true;
+    while (!line.empty()) {
+      auto const word_first = std::find_if_not(line.begin(), line.end(), is_space);
+      auto const word_last = std::find_if(word_first, line.end(), is_space);
+      std::string_view const word(line.data() + (word_first - line.begin()), static_cast<size_t>(word_last - word_first));
+      line.remove_prefix(static_cast<size_t>(word_last - line.begin()));
+      if (word.empty())
+        break;
+      if (first) {
+        if (!parse_address(word, addr))
+          break;
+        first = false;
+        continue;
+      }
+      auto &addrs = _names[normalize_name(word)];
+      if (std::find(addrs.begin(), addrs.end(), addr) == addrs.end())
+        addrs.push_back(addr);
+    }
+  }
+}
+
+std::vector<address> const *hosts_table::find(std::string_view name) const {
+  auto const it = _names.find(normalize_name(name));
+  return it != _names.end() ? &it->second : nullptr;
+}
+
+void parse_resolv_conf(std::string_view content, std::vector<full_address> &servers) {
+  constexpr std::string_view keyword = "nameserver";
+  while (!content.empty()) {
+    size_t const end = std::min(content.find('\n'), content.size());
+    std::string_view line = content.substr(0, end);
+    content.remove_prefix(std::min(end + 1, content.size()));
+    if (line.substr(0, keyword.size()) != keyword || line.size() == keyword.size() ||
+        (line[keyword.size()] != ' ' && line[keyword.size()] != '\t'))
+      continue;
+    line.remove_prefix(keyword.size());
+    line.remove_prefix(std::min(line.find_first_not_of(" \t"), line.size()));
+    line = line.substr(0, std::min(line.find_first_of(" \t\r#;"), line.size()));
+
+    full_address server;
+    if (!parse_endpoint(line, server))
+      continue;
+    if (!server.get_port())
+      server.set_port(e_dns_port);
+    servers.push_back(server);
+  }
+}
+
+resolver::~resolver() {
+  close();
+}
+
+#ifdef __linux__
+
+bool resolver::open(config const &conf) {
+  close();
+  _config = conf;
+  if (_config._servers.empty()) {
+    std::ifstream file("/etc/resolv.conf");
+    std::stringstream content;
+    content << file.rdbuf();
+    parse_resolv_conf(content.str(), _config._servers);
+  }
+  if (_config._servers.empty() || !_config._attempts)
+    return false;
+  for (auto &server : _config._servers) {
+    if (!server.get_port())
+      server.set_port(e_dns_port);
+  }
+
+  // dual stack socket reaches ipv4 servers by mapped addresses
+  _dual_stack = true;
+  _fd = socket(AF_INET6, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  int const off = 0;
+  if (_fd >= 0 && setsockopt(_fd, IPPROTO_IPV6, IPV6_V6ONLY, &off, sizeof(off)) != 0) {
+    ::close(_fd);
+    _fd = -1;
+  }
+  if (_fd < 0) {
+    _dual_stack = false;
+    _fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (_fd < 0)
+      return false;
+  }
+
+  _hosts = hosts_table();
+  if (!_config._hosts_path.empty())
+    _hosts.load(_config._hosts_path);
+  _random.seed(std::random_device()());
+  return true;
+}
+
+void resolver::close() noexcept {
+  if (_fd >= 0)
+    ::close(_fd);
+  _fd = -1;
+  _queries.clear();
+  _ids.clear();
+  _done.clear();
+}
+
+void resolver::send(query &q) noexcept {
+  full_address const &server = _config._servers[q._attempt % _config._servers.size()];
+  sockaddr_storage storage{};
+  socklen_t size = 0;
+  if (_dual_stack) {
+    auto *addr = reinterpret_cast<sockaddr_in6 *>(&storage);
+    addr->sin6_family = AF_INET6;
+    addr->sin6_port = htons(server.get_port());
+    if (server.get_address().get_version() == address::version::e_v4)
+      addr->sin6_addr = to_v4_mapped(server.get_address().to_v4()).to_native();
+    else
+      addr->sin6_addr = server.get_address().to_native_v6();
+    addr->sin6_scope_id = server.get_scope_id().value_or(0);
+    size = sizeof(sockaddr_in6);
+  } else {
+    if (server.get_address().get_version() != address::version::e_v4)
+      return;
+    auto *addr = reinterpret_cast<sockaddr_in *>(&storage);
+    addr->sin_family = AF_INET;
+    addr->sin_port = htons(server.get_port());
+    addr->sin_addr = server.get_address().to_native_v4();
+    size = sizeof(sockaddr_in);
+  }
+
+  uint8_t message[e_header_size + e_max_name + 4];
+  for (size_t i = 0; i < 2; ++i) {
+    if (q._answered[i])
+      continue;
+    size_t const message_size = build_query(q._name, q._ids[i], query_types[i], message);
+    // lost datagrams are handled by timeout
+    sendto(_fd, message, message_size, 0, reinterpret_cast<sockaddr const *>(&storage), size);
+  }
+}
+
+size_t resolver::process() {
+  uint8_t message[e_max_message];
+  while (_fd >= 0) {
+    sockaddr_storage storage{};
+    socklen_t storage_size = sizeof(storage);
+    ssize_t const size =
+      recvfrom(_fd, message, sizeof(message), 0, reinterpret_cast<sockaddr *>(&storage), &storage_size);
+    if (size < 0)
+      break;
+
+    full_address from;
+    if (storage.ss_family == AF_INET6) {
+      auto const &addr = reinterpret_cast<sockaddr_in6 const &>(storage);
+      v6::address const v6_addr(addr.sin6_addr);
+      v4::address v4_addr;
+      from = full_address(extract_v4_mapped(v6_addr, v4_addr) ? address(v4_addr) : address(v6_addr),
+                          ntohs(addr.sin6_port));
+    } else if (storage.ss_family == AF_INET) {
+      auto const &addr = reinterpret_cast<sockaddr_in const &>(storage);
+      from = full_address(address(addr.sin_addr), ntohs(addr.sin_port));
+    }
+    receive(message, static_cast<size_t>(size), from);
+  }
+
+  auto const now = clock::now();
+  if (now >= _next_eviction) {
+    evict(now);
+    _next_eviction = now + std::chrono::milliseconds(e_eviction_ms);
+  }
+  for (auto it = _queries.begin(); it != _queries.end();) {
+    auto const current = it++;
+    if (current->_deadline > now)
+      continue;
+    if (++current->_attempt >= _config._attempts * _config._servers.size()) {
+      finish(current, current->_failed ? resolve_error::e_server_failure : resolve_error::e_timeout);
+      continue;
+    }
+    current->_deadline = now + _config._timeout;
+    send(*current);
+  }
+  return complete();
+}
+
+size_t resolver::run_once(int timeout_ms) {
+  int const next = get_timeout_ms();
+  int const wait = next < 0 ? timeout_ms : (timeout_ms < 0 ? next : std::min(next, timeout_ms));
+  if (_fd >= 0 && !_queries.empty()) {
+    pollfd pfd{};
+    pfd.fd = _fd;
+    pfd.events = POLLIN;
+    poll(&pfd, 1, wait);
+  }
+  return process();
+}
+
+#else
+
+bool resolver::open(config const &) {
+  return false;
+}
+
+void resolver::close() noexcept {
+  _queries.clear();
+  _ids.clear();
+  _done.clear();
+}
+
+void resolver::send(query &) noexcept {}
+
+size_t resolver::process() {
+  return complete();
+}
+
+size_t resolver::run_once(int) {
+  return complete();
+}
+
+#endif // __linux__
+
+void resolver::resolve(std::string_view name, callback cb) {
+  resolve_result result;
+  address addr;
+  if (parse_address(name, addr)) {
+    result._addresses.push_back(addr);
+    cb(result);
+    return;
+  }
+
+  std::string normalized = normalize_name(name);
+  if (auto const *addrs = _hosts.find(normalized)) {
+    result._addresses = *addrs;
+    cb(result);
+    return;
+  }
+
+  if (auto const it = _cache.find(normalized); it != _cache.end()) {
+    if (it->second._expiration > clock::now()) {
+      result._addresses = it->second._addresses;
+      cb(result);
+      return;
+    }
+    _cache.erase(it);
+  }
+
+  for (auto &q : _queries) {
+    if (q._name == normalized) {
+      q._callbacks.push_back(std::move(cb));
+      return;
+    }
+  }
+
+  uint8_t message[e_header_size + e_max_name + 4];
+  if (!build_query(normalized, 0, e_type_a, message)) {
+    result._error = resolve_error::e_invalid_name;
+    cb(result);
+    return;
+  }
+  if (_fd < 0) {
+    result._error = resolve_error::e_server_failure;
+    cb(result);
+    return;
+  }
+
+  auto it = _queries.emplace(_queries.end());
+  it->_name = std::move(normalized);
+  it->_callbacks.push_back(std::move(cb));
+  it->_deadline = clock::now() + _config._timeout;
+  for (auto &id : it->_ids) {
+    do {
+      id = static_cast<uint16_t>(_random());
+    } while (_ids.count(id));
+    _ids.emplace(id, it);
+  }
+  send(*it);
+}
+
+void resolver::receive(uint8_t const *data, size_t size, full_address const &from) {
+  if (size < e_header_size)
+    return;
+  auto const id_it = _ids.find(load_be16(data));
+  if (id_it == _ids.end())
+    return;
+  auto const it = id_it->second;
+  query &q = *it;
+  // scope of link local server isn't compared
+  full_address const &server = _config._servers[q._attempt % _config._servers.size()];
+  if (from.get_address() != server.get_address() || from.get_port() != server.get_port())
+    return;
+  size_t const index = q._ids[0] == id_it->first ? 0 : 1;
+  uint16_t const flags = load_be16(data + 2);
+  if (!(flags & e_flag_response) || load_be16(data + 4) != 1)
+    return;
+  size_t offset = check_question(data, size, q._name, query_types[index]);
+  if (!offset)
+    return;
+
+  uint8_t const rcode = flags & 0x0f;
+  if (rcode == e_rcode_ok) {
+    // address records of answer section (cname chain is resolved by server)
+    for (uint16_t count = load_be16(data + 6); count && offset; --count) {
+      offset = skip_name(data, size, offset);
+      if (!offset || offset + 10 > size)
+        break;
+      uint16_t const type = load_be16(data + offset);
+      uint16_t const rclass = load_be16(data + offset + 2);
+      uint32_t const ttl = load_be32(data + offset + 4);
+      size_t const length = load_be16(data + offset + 8);
+      offset += 10;
+      if (offset + length > size)
+        break;
+      if (rclass == e_class_in && type == query_types[index] &&
+          length == (type == e_type_a ? size_t(v4::address::e_bytes_size) : size_t(v6::address::e_bytes_size))) {
+        address addr;
+        if (type == e_type_a) {
+          addr = address(v4::address(data[offset], data[offset + 1], data[offset + 2], data[offset + 3]));
+        } else {
+          uint8_t bytes[v6::address::e_bytes_size];
+          memcpy(bytes, data + offset, sizeof(bytes));
+          addr = address(v6::address(bytes));
+        }
+        if (std::find(q._addresses.begin(), q._addresses.end(), addr) == q._addresses.end())
+          q._addresses.push_back(addr);
+        q._ttl = std::min(q._ttl, ttl);
+      }
+      offset += length;
+    }
+  } else if (rcode != e_rcode_nxdomain) {
+    q._failed = true;
+  }
+  // records of truncated answer are used, but answer is incomplete (no tcp fallback)
+  if (flags & e_flag_truncated) {
+    q._truncated = true;
+    q._failed = true;
+  }
+
+  q._answered[index] = true;
+  _ids.erase(id_it);
+  if (q._answered[0] && q._answered[1]) {
+    resolve_error const error = !q._addresses.empty() ? resolve_error::e_ok
+                                : q._failed            ? resolve_error::e_server_failure
+                                                       : resolve_error::e_not_found;
+    finish(it, error);
+  }
+}
+
+void resolver::finish(std::list<query>::iterator it, resolve_error error) {
+  resolve_result result;
+  result._addresses = std::move(it->_addresses);
+  result._error = result._addresses.empty() ? error : resolve_error::e_ok;
+  // ipv4 addresses first, the order of answer records is kept
+  std::stable_partition(result._addresses.begin(), result._addresses.end(),
+                        [](address const &addr) { return addr.get_version() == address::version::e_v4; });
+  if (result._error == resolve_error::e_ok && !it->_truncated && it->_ttl && _config._max_ttl && _config._max_cache) {
+    auto const now = clock::now();
+    if (_cache.size() >= _config._max_cache && !_cache.count(it->_name)) {
+      evict(now);
+      // still full: drop entry which expires first
+      if (_cache.size() >= _config._max_cache) {
+        _cache.erase(std::min_element(_cache.begin(), _cache.end(), [](auto const &l, auto const &r) {
+          return l.second._expiration < r.second._expiration;
+        }));
+      }
+    }
+    _cache[it->_name] = cache_entry{result._addresses, now + std::chrono::seconds(std::min(it->_ttl, _config._max_ttl))};
+  }
+
+  for (size_t i = 0; i < 2; ++i) {
+    if (!it->_answered[i])
+      _ids.erase(it->_ids[i]);
+  }
+  _done.emplace_back(std::move(it->_callbacks), std::move(result));
+  _queries.erase(it);
+}
+
+void resolver::evict(clock::time_point now) {
+  for (auto it = _cache.begin(); it != _cache.end();)
+    it = it->second._expiration <= now ? _cache.erase(it) : std::next(it);
+}
+
+size_t resolver::complete() {
+  // callbacks can start new lookups
+  auto done = std::move(_done);
+  _done.clear();
+  for (auto const &[callbacks, result] : done) {
+    for (auto const &cb : callbacks)
+      cb(result);
+  }
+  return done.size();
+}
+
+int resolver::get_timeout_ms() const noexcept {
+  if (_queries.empty())
+    return -1;
+  auto deadline = _queries.front()._deadline;
+  for (auto const &q : _queries)
+    deadline = std::min(deadline, q._deadline);
+  auto const left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - clock::now()).count();
+  return left > 0 ? static_cast<int>(left) : 0;
+}
+
+} // namespace bro::net::proto::ip
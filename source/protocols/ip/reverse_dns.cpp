@@ -0,0 +1,161 @@
+#include <protocols/ip/reverse_dns.h>
+
+#include <algorithm>
+#include <cstring>
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif // __SSSE3__
+
+namespace bro::net::proto::ip {
+
+namespace {
+
+constexpr char hex_digits[] = "0123456789abcdef";
+constexpr std::string_view v4_suffix = "in-addr.arpa";
+constexpr std::string_view v6_suffix = "ip6.arpa";
+
+/**
+ * check if name ends with suffix (case insensitive) and strip it
+ */
+bool strip_suffix(std::string_view &name, std::string_view suffix) noexcept {
+  if (name.size() < suffix.size())
+    return false;
+  auto const tail = name.substr(name.size() - suffix.size());
+  for (size_t i = 0; i < suffix.size(); ++i) {
+    char c = tail[i];
+    if (c >= 'A' && c <= 'Z')
+      c = static_cast<char>(c - 'A' + 'a');
+    if (c != suffix[i])
+      return false;
+  }
+  name.remove_suffix(suffix.size());
+  return true;
+}
+
+int hex_value(char c) noexcept {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+bool parse_v4(std::string_view name, address &addr) noexcept {
+  uint8_t bytes[v4::address::e_bytes_size];
+  for (size_t i = 0; i < v4::address::e_bytes_size; ++i) {
+    unsigned value = 0;
+    size_t digits = 0;
+    for (; digits < name.size() && name[digits] != '.'; ++digits) {
+      char const c = name[digits];
+      if (c < '0' || c > '9' || digits == 3)
+        return false;
+      value = value * 10 + static_cast<unsigned>(c - '0');
+    }
+    if (!digits || value > 255 || digits == name.size())
+      return false;
+    bytes[v4::address::e_bytes_size - 1 - i] = static_cast<uint8_t>(value);
+    name.remove_prefix(digits + 1);
+  }
+  if (!name.empty())
+    return false;
+  addr = v4::address(bytes);
+  return true;
+}
+
+bool parse_v6(std::string_view name, address &addr) noexcept {
+  if (name.size() != 2 * 2 * v6::address::e_bytes_size)
+    return false;
+  uint8_t bytes[v6::address::e_bytes_size];
+  for (size_t i = 0; i < 2 * v6::address::e_bytes_size; ++i) {
+    int const nibble = hex_value(name[2 * i]);
+    if (nibble < 0 || name[2 * i + 1] != '.')
+      return false;
+    uint8_t &byte = bytes[v6::address::e_bytes_size - 1 - i / 2];
+    byte = (i % 2) ? static_cast<uint8_t>(byte | (nibble << 4)) : static_cast<uint8_t>(nibble);
+  }
+  addr = v6::address(bytes);
+  return true;
+}
+
+} // namespace
+
+char *to_ptr_name(char *out, v4::address const &addr) noexcept {
+  uint8_t bytes[v4::address::e_bytes_size];
+  uint32_t const data = addr.reverse_order().get_data();
+  memcpy(bytes, &data, sizeof(bytes));
+  for (size_t i = 0; i < v4::address::e_bytes_size; ++i) {
+    uint8_t const value = bytes[i];
+    if (value >= 100)
+      *out++ = static_cast<char>('0' + value / 100);
+    if (value >= 10)
+      *out++ = static_cast<char>('0' + value / 10 % 10);
+    *out++ = static_cast<char>('0' + value % 10);
+    *out++ = '.';
+  }
+  return std::copy(v4_suffix.begin(), v4_suffix.end(), out);
+}
+
+char *to_ptr_name(char *out, v6::address const &addr) noexcept {
+  uint8_t const *bytes = addr.get_data();
+#ifdef __SSSE3__
+  // reverse bytes, split into nibbles (low first), map to hex and interleave with dots
+  __m128i const data = _mm_loadu_si128(reinterpret_cast<__m128i const *>(bytes));
+  __m128i const reversed = _mm_shuffle_epi8(data, _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+  __m128i const mask = _mm_set1_epi8(0x0f);
+  __m128i const low = _mm_and_si128(reversed, mask);
+  __m128i const high = _mm_and_si128(_mm_srli_epi16(reversed, 4), mask);
+  __m128i const digits = _mm_loadu_si128(reinterpret_cast<__m128i const *>(hex_digits));
+  __m128i const first = _mm_shuffle_epi8(digits, _mm_unpacklo_epi8(low, high));
+  __m128i const second = _mm_shuffle_epi8(digits, _mm_unpackhi_epi8(low, high));
+  __m128i const dots = _mm_set1_epi8('.');
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_unpacklo_epi8(first, dots));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16), _mm_unpackhi_epi8(first, dots));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 32), _mm_unpacklo_epi8(second, dots));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 48), _mm_unpackhi_epi8(second, dots));
+  out += 4 * v6::address::e_bytes_size;
+#else
+  for (size_t i = v6::address::e_bytes_size; i-- > 0;) {
+    *out++ = hex_digits[bytes[i] & 0x0f];
+    *out++ = '.';
+    *out++ = hex_digits[bytes[i] >> 4];
+    *out++ = '.';
+  }
+#endif // __SSSE3__
+  return std::copy(v6_suffix.begin(), v6_suffix.end(), out);
+}
+
+char *to_ptr_name(char *out, address const &addr) noexcept {
+  switch (addr.get_version()) {
+  case address::version::e_v4:
+    return to_ptr_name(out, addr.to_v4());
+  case address::version::e_v6:
+    return to_ptr_name(out, addr.to_v6());
+  default:
+    break;
+  }
+  return out;
+}
+
+void to_ptr_names(address const *addrs, size_t size, char *out, size_t *lengths) noexcept {
+  for (size_t i = 0; i < size; ++i, out += e_max_ptr_name)
+    lengths[i] = static_cast<size_t>(to_ptr_name(out, addrs[i]) - out);
+}
+
+std::string to_ptr_name(address const &addr) {
+  char buffer[e_max_ptr_name];
+  return std::string(buffer, to_ptr_name(buffer, addr));
+}
+
+bool from_ptr_name(std::string_view name, address &addr) noexcept {
+  if (!name.empty() && name.back() == '.')
+    name.remove_suffix(1);
+  if (strip_suffix(name, v4_suffix))
+    return parse_v4(name, addr);
+  if (strip_suffix(name, v6_suffix))
+    return parse_v6(name, addr);
+  return false;
+}
+
+} // namespace bro::net::proto::ip
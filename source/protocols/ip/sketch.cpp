@@ -0,0 +1,315 @@
+#include <protocols/ip/sketch.h>
+#include <protocols/ip/numeric.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace bro::net::proto::ip {
+
+count_min_sketch::count_min_sketch(size_t width, size_t depth, uint64_t seed)
+  : _mask(round_up_pow2(width) - 1)
+  , _depth(depth ? depth : 1)
+  , _seed(seed) {
+  _counters.resize((_mask + 1) * _depth);
+}
+
+void count_min_sketch::add(address const &addr, uint64_t count) noexcept {
+  uint64_t const h1 = hash(addr, _seed);
+  uint64_t const h2 = detail::hash_mix(h1, detail::e_hash_k2) | 1;
+  uint64_t *row = _counters.data();
+  for (size_t i = 0; i < _depth; ++i, row += _mask + 1)
+    row[(h1 + i * h2) & _mask] += count;
+  _total += count;
+}
+
+uint64_t count_min_sketch::estimate(address const &addr) const noexcept {
+  uint64_t const h1 = hash(addr, _seed);
+  uint64_t const h2 = detail::hash_mix(h1, detail::e_hash_k2) | 1;
+  uint64_t res = UINT64_MAX;
+  uint64_t const *row = _counters.data();
+  for (size_t i = 0; i < _depth; ++i, row += _mask + 1)
+    res = std::min(res, row[(h1 + i * h2) & _mask]);
+  return res;
+}
+
+bool count_min_sketch::merge(count_min_sketch const &sketch) noexcept {
+  if (_mask != sketch._mask || _depth != sketch._depth || _seed != sketch._seed)
+    return false;
+  for (size_t i = 0; i < _counters.size(); ++i)
+    _counters[i] += sketch._counters[i];
+  _total += sketch._total;
+  return true;
+}
+
+void count_min_sketch::clear() noexcept {
+  std::fill(_counters.begin(), _counters.end(), 0);
+  _total = 0;
+}
+
+space_saving::space_saving(size_t capacity)
+  : _capacity(capacity) {
+  _entries.reserve(capacity);
+  _index.reserve(capacity);
+}
+
+void space_saving::swap_entries(size_t l, size_t r) noexcept {
+  std::swap(_entries[l], _entries[r]);
+  _index[_entries[l]._address] = l;
+  _index[_entries[r]._address] = r;
+}
+
+void space_saving::sift_up(size_t pos) noexcept {
+  while (pos) {
+    size_t const parent = (pos - 1) / 2;
+    if (_entries[parent]._count <= _entries[pos]._count)
+      break;
+    swap_entries(parent, pos);
+    pos = parent;
+  }
+}
+
+void space_saving::sift_down(size_t pos) noexcept {
+  size_t const size = _entries.size();
+  for (;;) {
+    size_t min = pos;
+    size_t const left = 2 * pos + 1;
+    size_t const right = left + 1;
+    if (left < size && _entries[left]._count < _entries[min]._count)
+      min = left;
+    if (right < size && _entries[right]._count < _entries[min]._count)
+      min = right;
+    if (min == pos)
+      break;
+    swap_entries(min, pos);
+    pos = min;
+  }
+}
+
+uint64_t space_saving::min_count() const noexcept {
+  // while summary isn't full every address is counted exactly
+  return _entries.size() < _capacity || _entries.empty() ? 0 : _entries.front()._count;
+}
+
+void space_saving::add(address const &addr, uint64_t count) {
+  _total += count;
+  if (!_capacity)
+    return;
+
+  if (auto it = _index.find(addr); it != _index.end()) {
+    size_t const pos = it->second;
+    _entries[pos]._count += count;
+    sift_down(pos);
+    return;
+  }
+
+  if (_entries.size() < _capacity) {
+    _entries.push_back({addr, count, 0});
+    _index[addr] = _entries.size() - 1;
+    sift_up(_entries.size() - 1);
+    return;
+  }
+
+  // replace address with minimal count
+  auto &root = _entries.front();
+  _index.erase(root._address);
+  root._error = root._count;
+  root._count += count;
+  root._address = addr;
+  _index[addr] = 0;
+  sift_down(0);
+}
+
+uint64_t space_saving::estimate(address const &addr) const noexcept {
+  auto it = _index.find(addr);
+  return it == _index.end() ? 0 : _entries[it->second]._count;
+}
+
+void space_saving::rebuild() {
+  _index.clear();
+  for (size_t i = 0; i < _entries.size(); ++i)
+    _index[_entries[i]._address] = i;
+  for (size_t i = _entries.size() / 2; i-- > 0;)
+    sift_down(i);
+}
+
+void space_saving::merge(space_saving const &summary) {
+  uint64_t const min = min_count();
+  uint64_t const other_min = summary.min_count();
+
+  // address missing in one summary could have at most its min count there
+  std::vector<entry> merged;
+  merged.reserve(_entries.size() + summary._entries.size());
+  for (auto const &ent : _entries) {
+    auto it = summary._index.find(ent._address);
+    if (it == summary._index.end()) {
+      merged.push_back({ent._address, ent._count + other_min, ent._error + other_min});
+    } else {
+      auto const &other = summary._entries[it->second];
+      merged.push_back({ent._address, ent._count + other._count, ent._error + other._error});
+    }
+  }
+  for (auto const &ent : summary._entries) {
+    if (_index.find(ent._address) == _index.end())
+      merged.push_back({ent._address, ent._count + min, ent._error + min});
+  }
+
+  if (merged.size() > _capacity) {
+    std::nth_element(merged.begin(), merged.begin() + _capacity, merged.end(),
+                     [](entry const &l, entry const &r) { return l._count > r._count; });
+    merged.resize(_capacity);
+  }
+  _entries = std::move(merged);
+  _total += summary._total;
+  rebuild();
+}
+
+std::vector<space_saving::entry> space_saving::top(size_t limit) const {
+  std::vector<entry> res(_entries);
+  auto const cmp = [](entry const &l, entry const &r) { return l._count > r._count; };
+  if (limit < res.size()) {
+    std::partial_sort(res.begin(), res.begin() + limit, res.end(), cmp);
+    res.resize(limit);
+  } else {
+    std::sort(res.begin(), res.end(), cmp);
+  }
+  return res;
+}
+
+std::vector<space_saving::entry> space_saving::above(uint64_t threshold) const {
+  std::vector<entry> res;
+  for (auto const &ent : _entries) {
+    if (ent._count >= threshold)
+      res.push_back(ent);
+  }
+  std::sort(res.begin(), res.end(), [](entry const &l, entry const &r) { return l._count > r._count; });
+  return res;
+}
+
+void space_saving::clear() noexcept {
+  _entries.clear();
+  _index.clear();
+  _total = 0;
+}
+
+hyperloglog::hyperloglog(uint8_t precision, uint64_t seed)
+  : _precision(std::clamp<uint8_t>(precision, 4, 18))
+  , _seed(seed) {
+  _registers.resize(size_t(1) << _precision);
+}
+
+void hyperloglog::add(address const &addr) noexcept {
+  uint64_t const h = hash(addr, _seed);
+  size_t const idx = h >> (64 - _precision);
+  uint64_t const rest = (h << _precision) | (uint64_t(1) << (_precision - 1));
+  uint8_t const rank = static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+  if (_registers[idx] < rank)
+    _registers[idx] = rank;
+}
+
+uint64_t hyperloglog::estimate() const noexcept {
+  double const m = static_cast<double>(_registers.size());
+  double sum = 0;
+  size_t zeros = 0;
+  for (auto reg : _registers) {
+    sum += std::ldexp(1.0, -reg);
+    zeros += !reg;
+  }
+
+  double alpha = 0.7213 / (1 + 1.079 / m);
+  if (_registers.size() == 16)
+    alpha = 0.673;
+  else if (_registers.size() == 32)
+    alpha = 0.697;
+  else if (_registers.size() == 64)
+    alpha = 0.709;
+
+  double res = alpha * m * m / sum;
+  if (res <= 2.5 * m && zeros)
+    res = m * std::log(m / static_cast<double>(zeros));
+  return static_cast<uint64_t>(res + 0.5);
+}
+
+bool hyperloglog::merge(hyperloglog const &counter) noexcept {
+  if (_precision != counter._precision || _seed != counter._seed)
+    return false;
+  for (size_t i = 0; i < _registers.size(); ++i)
+    _registers[i] = std::max(_registers[i], counter._registers[i]);
+  return true;
+}
+
+void hyperloglog::clear() noexcept {
+  std::fill(_registers.begin(), _registers.end(), 0);
+}
+
+hierarchical_heavy_hitters::hierarchical_heavy_hitters(size_t capacity,
+                                                       std::vector<uint8_t> v4_lengths,
+                                                       std::vector<uint8_t> v6_lengths)
+  : _v4(make_levels(capacity, address::version::e_v4, std::move(v4_lengths)))
+  , _v6(make_levels(capacity, address::version::e_v6, std::move(v6_lengths))) {}
+
+std::vector<hierarchical_heavy_hitters::level>
+hierarchical_heavy_hitters::make_levels(size_t capacity, address::version ver, std::vector<uint8_t> lengths) {
+  for (auto &len : lengths)
+    len = std::min(len, max_prefix_length(ver));
+  std::sort(lengths.begin(), lengths.end(), std::greater<uint8_t>());
+  lengths.erase(std::unique(lengths.begin(), lengths.end()), lengths.end());
+
+  std::vector<level> levels;
+  levels.reserve(lengths.size());
+  for (auto len : lengths)
+    levels.push_back({make_mask(ver, len), len, space_saving(capacity)});
+  return levels;
+}
+
+void hierarchical_heavy_hitters::add(address const &addr, uint64_t count) {
+  if (!addr.is_ipv4() && !addr.is_ipv6())
+    return;
+  auto &levels = addr.is_ipv4() ? _v4 : _v6;
+  for (auto &lvl : levels)
+    lvl._summary.add(addr & lvl._mask, count);
+}
+
+bool hierarchical_heavy_hitters::merge(hierarchical_heavy_hitters const &summary) {
+  auto const same_levels = [](std::vector<level> const &l, std::vector<level> const &r) {
+    return std::equal(l.begin(), l.end(), r.begin(), r.end(),
+                      [](level const &a, level const &b) { return a._length == b._length; });
+  };
+  if (!same_levels(_v4, summary._v4) || !same_levels(_v6, summary._v6))
+    return false;
+  for (size_t i = 0; i < _v4.size(); ++i)
+    _v4[i]._summary.merge(summary._v4[i]._summary);
+  for (size_t i = 0; i < _v6.size(); ++i)
+    _v6[i]._summary.merge(summary._v6[i]._summary);
+  return true;
+}
+
+std::vector<hierarchical_heavy_hitters::entry> hierarchical_heavy_hitters::query(uint64_t threshold) const {
+  std::vector<entry> res;
+  for (auto const *levels : {&_v4, &_v6}) {
+    size_t const first = res.size();
+    for (auto const &lvl : *levels) {
+      for (auto const &ent : lvl._summary.above(threshold)) {
+        prefix const pref(ent._address, lvl._length);
+        // discounted counts of reported descendants don't overlap
+        uint64_t reported = 0;
+        for (size_t i = first; i < res.size(); ++i) {
+          if (res[i]._prefix.get_length() > lvl._length && pref.contains(res[i]._prefix))
+            reported += res[i]._count;
+        }
+        uint64_t const count = ent._count > reported ? ent._count - reported : 0;
+        if (count >= threshold && count)
+          res.push_back({pref, count});
+      }
+    }
+  }
+  return res;
+}
+
+void hierarchical_heavy_hitters::clear() noexcept {
+  for (auto &lvl : _v4)
+    lvl._summary.clear();
+  for (auto &lvl : _v6)
+    lvl._summary.clear();
+}
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,151 @@
+#include <protocols/ip/sort.h>
+
+#include <algorithm>
+#include <array>
+#include <thread>
+
+namespace bro::net::proto::ip {
+
+namespace {
+
+/**
+ * arrays smaller than this are sorted with std::sort
+ */
+constexpr size_t small_size = 256;
+
+/**
+ * min number of elements per thread
+ */
+constexpr size_t min_chunk = 1 << 16;
+
+/**
+ * \brief radix key of address
+ *
+ * byte(addr, 0) is the least significant byte
+ */
+template <typename T> struct key_traits;
+
+template <> struct key_traits<v4::address> {
+  enum { e_size = v4::address::e_bytes_size };
+  static uint8_t byte(v4::address const &addr, size_t i) noexcept {
+    return static_cast<uint8_t>(addr.get_data() >> (8 * (e_size - 1 - i)));
+  }
+};
+
+template <> struct key_traits<v6::address> {
+  enum { e_size = v6::address::e_bytes_size };
+  static uint8_t byte(v6::address const &addr, size_t i) noexcept {
+    return addr.get_data()[e_size - 1 - i];
+  }
+};
+
+template <> struct key_traits<address> {
+  enum { e_size = v6::address::e_bytes_size + 1 };
+  static uint8_t byte(address const &addr, size_t i) noexcept {
+    if (i == v6::address::e_bytes_size)
+      return static_cast<uint8_t>(addr.get_version());
+    return addr.get_data()[v6::address::e_bytes_size - 1 - i];
+  }
+};
+
+template <> struct key_traits<full_address> {
+  enum { e_size = key_traits<address>::e_size + sizeof(uint16_t) };
+  static uint8_t byte(full_address const &addr, size_t i) noexcept {
+    if (i < sizeof(uint16_t))
+      return static_cast<uint8_t>(addr.get_port() >> (8 * i));
+    return key_traits<address>::byte(addr.get_address(), i - sizeof(uint16_t));
+  }
+};
+
+/**
+ * run func(0) ... func(threads - 1) in parallel
+ */
+template <typename Func> void run_parallel(size_t threads, Func const &func) {
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  for (size_t i = 1; i < threads; ++i)
+    workers.emplace_back(func, i);
+  func(0);
+  for (auto &worker : workers)
+    worker.join();
+}
+
+template <typename T> void radix_sort(T *addrs, size_t size, size_t threads) {
+  if (size < small_size) {
+    std::sort(addrs, addrs + size, network_order_less{});
+    return;
+  }
+
+  if (!threads)
+    threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+  threads = std::max<size_t>(1, std::min(threads, size / min_chunk));
+  size_t const chunk = (size + threads - 1) / threads;
+
+  using histogram = std::array<size_t, 256>;
+  std::vector<histogram> counts(threads);
+  std::vector<T> buffer(size);
+  T *src = addrs;
+  T *dst = buffer.data();
+
+  for (size_t pass = 0; pass < key_traits<T>::e_size; ++pass) {
+    run_parallel(threads, [&](size_t id) {
+      auto &count = counts[id];
+      count.fill(0);
+      size_t const last = std::min(size, (id + 1) * chunk);
+      for (size_t i = id * chunk; i < last; ++i)
+        ++count[key_traits<T>::byte(src[i], pass)];
+    });
+
+    // skip pass if all addresses have the same byte
+    bool trivial = false;
+    for (size_t b = 0; b < 256 && !trivial; ++b) {
+      size_t bucket = 0;
+      for (auto const &count : counts)
+        bucket += count[b];
+      trivial = bucket == size;
+    }
+    if (trivial)
+      continue;
+
+    // convert counts to offsets: every thread writes own part of every bucket
+    size_t offset = 0;
+    for (size_t b = 0; b < 256; ++b) {
+      for (auto &count : counts) {
+        size_t const bucket = count[b];
+        count[b] = offset;
+        offset += bucket;
+      }
+    }
+
+    run_parallel(threads, [&](size_t id) {
+      auto &pos = counts[id];
+      size_t const last = std::min(size, (id + 1) * chunk);
+      for (size_t i = id * chunk; i < last; ++i)
+        dst[pos[key_traits<T>::byte(src[i], pass)]++] = std::move(src[i]);
+    });
+    std::swap(src, dst);
+  }
+
+  if (src != addrs)
+    std::move(src, src + size, addrs);
+}
+
+} // namespace
+
+void sort(v4::address *addrs, size_t size, size_t threads) {
+  radix_sort(addrs, size, threads);
+}
+
+void sort(v6::address *addrs, size_t size, size_t threads) {
+  radix_sort(addrs, size, threads);
+}
+
+void sort(address *addrs, size_t size, size_t threads) {
+  radix_sort(addrs, size, threads);
+}
+
+void sort(full_address *addrs, size_t size, size_t threads) {
+  radix_sort(addrs, size, threads);
+}
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,139 @@
+#include <protocols/ip/stats.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bro::net::proto::ip::stats {
+
+namespace {
+
+constexpr size_t operations_size = static_cast<size_t>(operation::e_size);
+constexpr size_t counters_size = static_cast<size_t>(counter::e_size);
+
+/**
+ * \brief statistics of one thread
+ *
+ * only owner thread writes, so plain load + store is enough
+ */
+struct thread_stats {
+  std::atomic<uint64_t> _count[operations_size] = {};
+  std::atomic<uint64_t> _ticks[operations_size] = {};
+  std::atomic<uint64_t> _histogram[operations_size][e_histogram_buckets] = {};
+  std::atomic<uint64_t> _counters[counters_size] = {};
+
+  thread_stats();
+  ~thread_stats();
+};
+
+/**
+ * \brief all threads statistics
+ */
+struct registry {
+  std::mutex _mutex;                    ///< protects registry
+  std::vector<thread_stats *> _threads; ///< alive threads
+  snapshot _finished;                   ///< sum of finished threads
+  snapshot _baseline;                   ///< values at last reset
+};
+
+registry &get_registry() {
+  // never destroyed - thread_local stats can outlive static objects
+  static auto *reg = new registry;
+  return *reg;
+}
+
+thread_stats &local_stats() {
+  thread_local thread_stats stats;
+  return stats;
+}
+
+inline void add(std::atomic<uint64_t> &value, uint64_t delta) noexcept {
+  value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+void accumulate(snapshot &res, thread_stats const &stats) noexcept {
+  for (size_t op = 0; op < operations_size; ++op) {
+    res._operations[op]._count += stats._count[op].load(std::memory_order_relaxed);
+    res._operations[op]._ticks += stats._ticks[op].load(std::memory_order_relaxed);
+    for (size_t b = 0; b < e_histogram_buckets; ++b)
+      res._operations[op]._histogram[b] += stats._histogram[op][b].load(std::memory_order_relaxed);
+  }
+  for (size_t cnt = 0; cnt < counters_size; ++cnt)
+    res._counters[cnt] += stats._counters[cnt].load(std::memory_order_relaxed);
+}
+
+snapshot collect_raw(registry &reg) {
+  snapshot res = reg._finished;
+  for (auto const *stats : reg._threads)
+    accumulate(res, *stats);
+  return res;
+}
+
+double calibrate() {
+#if defined(__x86_64__) || defined(__i386__)
+  auto const start_time = std::chrono::steady_clock::now();
+  uint64_t const start = now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  uint64_t const ticks = now() - start;
+  auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time);
+  return ns.count() ? double(ticks) / double(ns.count()) : 1;
+#else
+  return 1;
+#endif
+}
+
+thread_stats::thread_stats() {
+  auto &reg = get_registry();
+  std::lock_guard<std::mutex> lock(reg._mutex);
+  reg._threads.push_back(this);
+}
+
+thread_stats::~thread_stats() {
+  auto &reg = get_registry();
+  std::lock_guard<std::mutex> lock(reg._mutex);
+  accumulate(reg._finished, *this);
+  reg._threads.erase(std::remove(reg._threads.begin(), reg._threads.end(), this), reg._threads.end());
+}
+
+} // namespace
+
+void record(operation op, uint64_t ticks) noexcept {
+  auto &stats = local_stats();
+  auto const idx = static_cast<size_t>(op);
+  size_t const bucket = std::min<size_t>(ticks ? 64 - __builtin_clzll(ticks) : 0, e_histogram_buckets - 1);
+  add(stats._count[idx], 1);
+  add(stats._ticks[idx], ticks);
+  add(stats._histogram[idx][bucket], 1);
+}
+
+void increment(counter cnt) noexcept {
+  add(local_stats()._counters[static_cast<size_t>(cnt)], 1);
+}
+
+snapshot collect() {
+  static double const ticks_per_ns = calibrate();
+  auto &reg = get_registry();
+  std::lock_guard<std::mutex> lock(reg._mutex);
+  snapshot res = collect_raw(reg);
+  for (size_t op = 0; op < operations_size; ++op) {
+    res._operations[op]._count -= reg._baseline._operations[op]._count;
+    res._operations[op]._ticks -= reg._baseline._operations[op]._ticks;
+    for (size_t b = 0; b < e_histogram_buckets; ++b)
+      res._operations[op]._histogram[b] -= reg._baseline._operations[op]._histogram[b];
+  }
+  for (size_t cnt = 0; cnt < counters_size; ++cnt)
+    res._counters[cnt] -= reg._baseline._counters[cnt];
+  res._ticks_per_ns = ticks_per_ns;
+  return res;
+}
+
+void reset() {
+  auto &reg = get_registry();
+  std::lock_guard<std::mutex> lock(reg._mutex);
+  reg._baseline = collect_raw(reg);
+}
+
+} // namespace bro::net::proto::ip::stats
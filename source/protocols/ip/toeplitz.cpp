@@ -0,0 +1,163 @@
+#include <protocols/ip/toeplitz.h>
+
+#include <cstring>
+
+namespace bro::net::proto::ip {
+
+namespace {
+
+enum : uint8_t {
+  e_tcp = 6, ///< tcp protocol
+  e_udp = 17 ///< udp protocol
+};
+
+inline uint8_t *put_port(uint8_t *out, uint16_t port) noexcept {
+  out[0] = static_cast<uint8_t>(port >> 8);
+  out[1] = static_cast<uint8_t>(port);
+  return out + 2;
+}
+
+} // namespace
+
+toeplitz::toeplitz(uint8_t const *key, size_t key_size)
+  : _table(e_max_input * 256) {
+  // hash of single set bit is 32 bit key window starting at that bit
+  for (size_t i = 0; i < e_max_input; ++i) {
+    uint32_t windows[8];
+    for (unsigned bit = 0; bit < 8; ++bit) {
+      uint8_t data[e_max_input] = {};
+      data[i] = static_cast<uint8_t>(0x80 >> bit);
+      windows[bit] = toeplitz_hash(key, key_size, data, i + 1);
+    }
+    for (unsigned value = 0; value < 256; ++value) {
+      uint32_t res = 0;
+      for (unsigned bit = 0; bit < 8; ++bit) {
+        if (value & (0x80 >> bit))
+          res ^= windows[bit];
+      }
+      _table[i * 256 + value] = res;
+    }
+  }
+}
+
+uint32_t toeplitz::hash(v4::address const &source, v4::address const &destination) const noexcept {
+  uint32_t const addrs[2] = {source.get_data(), destination.get_data()};
+  return hash(reinterpret_cast<uint8_t const *>(addrs), sizeof(addrs));
+}
+
+uint32_t toeplitz::hash(v4::address const &source, v4::address const &destination, uint16_t source_port,
+                        uint16_t destination_port) const noexcept {
+  uint8_t tuple[rss::e_v4_tuple_size];
+  uint32_t const addrs[2] = {source.get_data(), destination.get_data()};
+  memcpy(tuple, addrs, sizeof(addrs));
+  put_port(put_port(tuple + sizeof(addrs), source_port), destination_port);
+  return hash(tuple, sizeof(tuple));
+}
+
+uint32_t toeplitz::hash(v6::address const &source, v6::address const &destination) const noexcept {
+  uint8_t tuple[2 * v6::address::e_bytes_size];
+  memcpy(tuple, source.get_data(), v6::address::e_bytes_size);
+  memcpy(tuple + v6::address::e_bytes_size, destination.get_data(), v6::address::e_bytes_size);
+  return hash(tuple, sizeof(tuple));
+}
+
+uint32_t toeplitz::hash(v6::address const &source, v6::address const &destination, uint16_t source_port,
+                        uint16_t destination_port) const noexcept {
+  uint8_t tuple[rss::e_v6_tuple_size];
+  memcpy(tuple, source.get_data(), v6::address::e_bytes_size);
+  memcpy(tuple + v6::address::e_bytes_size, destination.get_data(), v6::address::e_bytes_size);
+  put_port(put_port(tuple + 2 * v6::address::e_bytes_size, source_port), destination_port);
+  return hash(tuple, sizeof(tuple));
+}
+
+uint32_t toeplitz::hash(address const &source, address const &destination) const noexcept {
+  if (source.get_version() != destination.get_version())
+    return 0;
+  if (source.is_ipv4())
+    return hash(source.to_v4(), destination.to_v4());
+  if (source.is_ipv6())
+    return hash(source.to_v6(), destination.to_v6());
+  return 0;
+}
+
+uint32_t toeplitz::hash(full_address const &source, full_address const &destination) const noexcept {
+  address const &src = source.get_address();
+  address const &dst = destination.get_address();
+  if (src.get_version() != dst.get_version())
+    return 0;
+  if (src.is_ipv4())
+    return hash(src.to_v4(), dst.to_v4(), source.get_port(), destination.get_port());
+  if (src.is_ipv6())
+    return hash(src.to_v6(), dst.to_v6(), source.get_port(), destination.get_port());
+  return 0;
+}
+
+void toeplitz::hash(full_address const *sources, full_address const *destinations, size_t size,
+                    uint32_t *res) const noexcept {
+  for (size_t i = 0; i < size; ++i)
+    res[i] = hash(sources[i], destinations[i]);
+}
+
+void toeplitz::hash(flow_keys const &keys, uint32_t *res) const noexcept {
+  for (size_t i = 0; i < keys._size; ++i) {
+    address const &src = keys._sources[i];
+    address const &dst = keys._destinations[i];
+    switch (keys._statuses[i]) {
+    case packet_status::e_ok:
+      if ((keys._protocols[i] == e_tcp || keys._protocols[i] == e_udp) && src.get_version() == dst.get_version()) {
+        res[i] = src.is_ipv4() ? hash(src.to_v4(), dst.to_v4(), keys._source_ports[i], keys._destination_ports[i])
+                               : hash(src.to_v6(), dst.to_v6(), keys._source_ports[i], keys._destination_ports[i]);
+        break;
+      }
+      [[fallthrough]];
+    case packet_status::e_fragment:
+    case packet_status::e_truncated:
+      res[i] = hash(src, dst);
+      break;
+    default:
+      res[i] = 0;
+      break;
+    }
+  }
+}
+
+uint32_t toeplitz_hash(uint8_t const *key, size_t key_size, uint8_t const *data, size_t size) noexcept {
+  auto const key_bit = [key, key_size](size_t bit) -> uint32_t {
+    return bit / 8 < key_size ? (key[bit / 8] >> (7 - bit % 8)) & 1 : 0;
+  };
+  // 32 bit window slides over key by one bit per input bit
+  uint32_t window = 0;
+  for (size_t bit = 0; bit < 32; ++bit)
+    window = (window << 1) | key_bit(bit);
+
+  uint32_t res = 0;
+  for (size_t i = 0; i < size; ++i) {
+    for (unsigned bit = 0; bit < 8; ++bit) {
+      if (data[i] & (0x80 >> bit))
+        res ^= window;
+      window = (window << 1) | key_bit(32 + i * 8 + bit);
+    }
+  }
+  return res;
+}
+
+uint32_t rss_hash(full_address const &source, full_address const &destination, uint8_t const *key,
+                  size_t key_size) noexcept {
+  address const &src = source.get_address();
+  address const &dst = destination.get_address();
+  if (src.get_version() != dst.get_version() || (!src.is_ipv4() && !src.is_ipv6()))
+    return 0;
+
+  uint8_t tuple[rss::e_v6_tuple_size];
+  size_t const addr_size = src.is_ipv4() ? size_t(v4::address::e_bytes_size) : size_t(v6::address::e_bytes_size);
+  memcpy(tuple, src.get_data(), addr_size);
+  memcpy(tuple + addr_size, dst.get_data(), addr_size);
+  uint8_t *ports = tuple + 2 * addr_size;
+  ports[0] = static_cast<uint8_t>(source.get_port() >> 8);
+  ports[1] = static_cast<uint8_t>(source.get_port());
+  ports[2] = static_cast<uint8_t>(destination.get_port() >> 8);
+  ports[3] = static_cast<uint8_t>(destination.get_port());
+  return toeplitz_hash(key, key_size, tuple, 2 * addr_size + 4);
+}
+
+} // namespace bro::net::proto::ip
@@ -0,0 +1,214 @@
+#include <protocols/ip/translate.h>
+
+#include <cstring>
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif // __SSSE3__
+
+namespace bro::net::proto::ip {
+
+static_assert(sizeof(v6::address) == v6::address::e_bytes_size, "address must be plain 16 bytes");
+static_assert(sizeof(v4::address) == v4::address::e_bytes_size, "address must be plain 4 bytes");
+
+namespace {
+
+enum {
+  e_u_octet = 8 ///< RFC 6052 reserved octet (bits 64-71)
+};
+
+constexpr uint8_t v4_mapped_prefix[] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff};
+constexpr uint8_t teredo_prefix[] = {0x20, 0x01, 0x00, 0x00};
+constexpr uint8_t sixtofour_prefix[] = {0x20, 0x02};
+
+inline v4::address make_v4(uint8_t const *bytes) noexcept {
+  uint32_t data;
+  memcpy(&data, bytes, sizeof(data));
+  return v4::address(data);
+}
+
+} // namespace
+
+nat64::nat64() noexcept {
+  set_prefix(prefix(address("64:ff9b::"), 96));
+}
+
+bool nat64::set_prefix(prefix const &pref) noexcept {
+  uint8_t const length = pref.get_length();
+  if (pref.get_version() != address::version::e_v6 ||
+      (length != 32 && length != 40 && length != 48 && length != 56 && length != 64 && length != 96))
+    return false;
+  v6::address const addr = pref.get_address().to_v6();
+  uint8_t const *bytes = addr.get_data();
+  if (bytes[e_u_octet])
+    return false;
+
+  _prefix = pref;
+  memcpy(_prefix_bytes, bytes, sizeof(_prefix_bytes));
+  memset(_mask, 0, sizeof(_mask));
+  memset(_mask, 0xff, length / 8);
+  _mask[e_u_octet] = 0xff;
+  memset(_embed, 0x80, sizeof(_embed));
+  memset(_extract, 0x80, sizeof(_extract));
+
+  // ipv4 bytes follow prefix and skip "u" octet
+  size_t pos = length / 8;
+  for (uint8_t i = 0; i < v4::address::e_bytes_size; ++i, ++pos) {
+    if (pos == e_u_octet)
+      ++pos;
+    _embed[pos] = i;
+    _extract[i] = static_cast<uint8_t>(pos);
+  }
+  return true;
+}
+
+v6::address nat64::embed(v4::address const &addr) const noexcept {
+  v6::address res;
+  embed(&addr, 1, &res);
+  return res;
+}
+
+bool nat64::extract(v6::address const &addr, v4::address &res) const noexcept {
+  return extract(&addr, 1, &res) == 1;
+}
+
+void nat64::embed(v4::address const *addrs, size_t size, v6::address *res) const noexcept {
+#ifdef __SSSE3__
+  __m128i const prefix_bytes = _mm_load_si128(reinterpret_cast<__m128i const *>(_prefix_bytes));
+  __m128i const shuffle = _mm_load_si128(reinterpret_cast<__m128i const *>(_embed));
+  for (size_t i = 0; i < size; ++i) {
+    __m128i const v4_bytes = _mm_cvtsi32_si128(static_cast<int>(addrs[i].get_data()));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(res + i),
+                     _mm_or_si128(prefix_bytes, _mm_shuffle_epi8(v4_bytes, shuffle)));
+  }
+#else
+  for (size_t i = 0; i < size; ++i) {
+    uint8_t bytes[v6::address::e_bytes_size];
+    memcpy(bytes, _prefix_bytes, sizeof(bytes));
+    uint32_t const data = addrs[i].get_data();
+    uint8_t v4_bytes[v4::address::e_bytes_size];
+    memcpy(v4_bytes, &data, sizeof(v4_bytes));
+    for (size_t j = 0; j < v4::address::e_bytes_size; ++j)
+      bytes[_extract[j]] = v4_bytes[j];
+    res[i] = v6::address(bytes);
+  }
+#endif // __SSSE3__
+}
+
+size_t nat64::extract(v6::address const *addrs, size_t size, v4::address *res) const noexcept {
+  size_t extracted = 0;
+#ifdef __SSSE3__
+  __m128i const prefix_bytes = _mm_load_si128(reinterpret_cast<__m128i const *>(_prefix_bytes));
+  __m128i const mask = _mm_load_si128(reinterpret_cast<__m128i const *>(_mask));
+  __m128i const shuffle = _mm_load_si128(reinterpret_cast<__m128i const *>(_extract));
+  for (size_t i = 0; i < size; ++i) {
+    __m128i const bytes = _mm_loadu_si128(reinterpret_cast<__m128i const *>(addrs[i].get_data()));
+    uint32_t const match = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(bytes, mask), prefix_bytes)) == 0xffff;
+    uint32_t const data = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_shuffle_epi8(bytes, shuffle)));
+    res[i] = v4::address(data & (0 - match));
+    extracted += match;
+  }
+#else
+  uint64_t prefix_qwords[v6::address::e_qword_size], mask_qwords[v6::address::e_qword_size];
+  memcpy(prefix_qwords, _prefix_bytes, sizeof(prefix_qwords));
+  memcpy(mask_qwords, _mask, sizeof(mask_qwords));
+  for (size_t i = 0; i < size; ++i) {
+    uint8_t const *bytes = addrs[i].get_data();
+    uint64_t qwords[v6::address::e_qword_size];
+    memcpy(qwords, bytes, sizeof(qwords));
+    uint32_t const match =
+      ((qwords[0] & mask_qwords[0]) == prefix_qwords[0]) & ((qwords[1] & mask_qwords[1]) == prefix_qwords[1]);
+    uint8_t v4_bytes[v4::address::e_bytes_size];
+    for (size_t j = 0; j < v4::address::e_bytes_size; ++j)
+      v4_bytes[j] = bytes[_extract[j]];
+    uint32_t data;
+    memcpy(&data, v4_bytes, sizeof(data));
+    res[i] = v4::address(data & (0 - match));
+    extracted += match;
+  }
+#endif // __SSSE3__
+  return extracted;
+}
+
+v6::address to_v4_mapped(v4::address const &addr) noexcept {
+  v6::address res;
+  to_v4_mapped(&addr, 1, &res);
+  return res;
+}
+
+void to_v4_mapped(v4::address const *addrs, size_t size, v6::address *res) noexcept {
+  uint8_t bytes[v6::address::e_bytes_size] = {0};
+  memcpy(bytes, v4_mapped_prefix, sizeof(v4_mapped_prefix));
+  for (size_t i = 0; i < size; ++i) {
+    uint32_t const data = addrs[i].get_data();
+    memcpy(bytes + sizeof(v4_mapped_prefix), &data, sizeof(data));
+    res[i] = v6::address(bytes);
+  }
+}
+
+bool is_v4_mapped(v6::address const &addr) noexcept {
+  return !memcmp(addr.get_data(), v4_mapped_prefix, sizeof(v4_mapped_prefix));
+}
+
+bool extract_v4_mapped(v6::address const &addr, v4::address &res) noexcept {
+  return extract_v4_mapped(&addr, 1, &res) == 1;
+}
+
+size_t extract_v4_mapped(v6::address const *addrs, size_t size, v4::address *res) noexcept {
+  // ::ffff:0:0/96 in little endian qword and dword
+  constexpr uint32_t mapped_dword = 0xffff0000;
+  size_t extracted = 0;
+  for (size_t i = 0; i < size; ++i) {
+    uint8_t const *bytes = addrs[i].get_data();
+    uint64_t high;
+    uint32_t middle, low;
+    memcpy(&high, bytes, sizeof(high));
+    memcpy(&middle, bytes + 8, sizeof(middle));
+    memcpy(&low, bytes + 12, sizeof(low));
+    uint32_t const match = (high == 0) & (middle == mapped_dword);
+    res[i] = v4::address(low & (0 - match));
+    extracted += match;
+  }
+  return extracted;
+}
+
+bool extract_v4_compatible(v6::address const &addr, v4::address &res) noexcept {
+  uint8_t const *bytes = addr.get_data();
+  static constexpr uint8_t zeros[12] = {0};
+  if (memcmp(bytes, zeros, sizeof(zeros)))
+    return false;
+  v4::address const v4_addr = make_v4(bytes + sizeof(zeros));
+  if (__builtin_bswap32(v4_addr.get_data()) <= 1)
+    return false;
+  res = v4_addr;
+  return true;
+}
+
+v6::address to_6to4(v4::address const &addr) noexcept {
+  uint8_t bytes[v6::address::e_bytes_size] = {0};
+  memcpy(bytes, sixtofour_prefix, sizeof(sixtofour_prefix));
+  uint32_t const data = addr.get_data();
+  memcpy(bytes + sizeof(sixtofour_prefix), &data, sizeof(data));
+  return v6::address(bytes);
+}
+
+bool extract_6to4(v6::address const &addr, v4::address &res) noexcept {
+  uint8_t const *bytes = addr.get_data();
+  if (memcmp(bytes, sixtofour_prefix, sizeof(sixtofour_prefix)))
+    return false;
+  res = make_v4(bytes + sizeof(sixtofour_prefix));
+  return true;
+}
+
+bool extract_teredo(v6::address const &addr, teredo_info &info) noexcept {
+  uint8_t const *bytes = addr.get_data();
+  if (memcmp(bytes, teredo_prefix, sizeof(teredo_prefix)))
+    return false;
+  info._server = make_v4(bytes + 4);
+  info._flags = static_cast<uint16_t>((bytes[8] << 8) | bytes[9]);
+  // port and client address are obfuscated by inverting bits
+  info._port = static_cast<uint16_t>(~((bytes[10] << 8) | bytes[11]));
+  info._client = v4::address(~make_v4(bytes + 12).get_data());
+  return true;
+}
+
+} // namespace bro::net::proto::ip
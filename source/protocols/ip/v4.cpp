@@ -1,8 +1,12 @@
 #ifdef __linux__
 #include <arpa/inet.h>
 #endif
+#include <protocols/ip/format.h>
+#include <protocols/ip/stats.h>
 #include <protocols/ip/v4.h>
 
+#include <ostream>
+
 namespace bro::net::proto::ip::v4 {
 
 address::address(std::string const &addr) {
@@ -10,27 +14,30 @@ address::address(std::string const &addr) {
 }
 
 std::string address::to_string() const {
-  return address_to_string(_dword);
-}
-
-address address::reverse_order() const noexcept {
-  return address(__builtin_bswap32(_dword));
+  return address_to_string(_words[0]);
 }
 
 std::string address_to_string(uint32_t addr) {
-  return inet_ntoa({addr});
+  PROTOCOLS_STATS_TIMER(e_format);
+  PROTOCOLS_STATS_INCREMENT(e_string_alloc);
+  char buffer[e_max_v4_string];
+  return std::string(buffer, format_to(buffer, address(addr)));
 }
 
 bool string_to_address(std::string const &str_address, uint32_t &address) noexcept {
+  PROTOCOLS_STATS_TIMER(e_parse);
   bool rc{false};
 #ifdef __linux__
   rc = (1 == inet_pton(AF_INET, str_address.c_str(), &address));
 #endif
+  if (!rc)
+    PROTOCOLS_STATS_INCREMENT(e_parse_failed);
   return rc;
 }
 
 std::ostream &operator<<(std::ostream &strm, address const &address) {
-  return strm << address_to_string(address);
+  char buffer[e_max_v4_string];
+  return strm.write(buffer, format_to(buffer, address) - buffer);
 }
 
 } // namespace bro::net::proto::ip::v4
@@ -1,9 +1,13 @@
 #ifdef __linux__
 #include <arpa/inet.h>
 #endif
+#include <protocols/ip/format.h>
+#include <protocols/ip/stats.h>
 #include <protocols/ip/v6.h>
 #include <string.h>
 
+#include <ostream>
+
 namespace bro::net::proto::ip::v6 {
 
 address::address(std::string const &addr) noexcept {
@@ -21,6 +25,7 @@ address &address::operator=(in6_addr const &addr) noexcept {
 }
 
 in6_addr address::to_native() const noexcept {
+  PROTOCOLS_STATS_TIMER(e_native);
   in6_addr addr;
   memcpy(&addr, _bytes, ip::v6::address::e_bytes_size);
   return addr;
@@ -28,36 +33,31 @@ in6_addr address::to_native() const noexcept {
 
 #endif // __linux__
 
-address::address(uint8_t const (&addr)[e_bytes_size]) noexcept {
-  memcpy(_bytes, addr, e_bytes_size);
-}
-
 std::string address::to_string() const {
   return address_to_string(_bytes);
 }
 
-address address::reverse_order() const noexcept {
-  return address(__builtin_bswap64(_qword[1]), __builtin_bswap64(_qword[0]));
-}
-
 std::string address_to_string(uint8_t const (&addr)[address::e_bytes_size]) {
-  char buffer[256] = {0};
-#ifdef __linux__
-  inet_ntop(AF_INET6, addr, buffer, sizeof(buffer));
-#endif //__linux__
-  return buffer;
+  PROTOCOLS_STATS_TIMER(e_format);
+  PROTOCOLS_STATS_INCREMENT(e_string_alloc);
+  char buffer[e_max_v6_string];
+  return std::string(buffer, format_to(buffer, address(addr)));
 }
 
 bool string_to_address(std::string const &str_address, uint8_t const (&addr)[address::e_bytes_size]) noexcept {
+  PROTOCOLS_STATS_TIMER(e_parse);
   bool rc{false};
 #ifdef __linux__
   rc = 1 == inet_pton(AF_INET6, str_address.c_str(), (void *) addr);
 #endif // __linux__
+  if (!rc)
+    PROTOCOLS_STATS_INCREMENT(e_parse_failed);
   return rc;
 }
 
 std::ostream &operator<<(std::ostream &strm, address const &address) {
-  return strm << address_to_string(address);
+  char buffer[e_max_v6_string];
+  return strm.write(buffer, format_to(buffer, address) - buffer);
 }
 
 } // namespace bro::net::proto::ip::v6
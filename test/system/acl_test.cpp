@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/acl.h>
+
+#include <random>
+#include <vector>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::acl;
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::prefix;
+
+static uint32_t linear_match(std::vector<prefix> const &prefixes, address const &addr) {
+  for (size_t i = 0; i < prefixes.size(); ++i) {
+    if (prefixes[i].contains(addr))
+      return static_cast<uint32_t>(i);
+  }
+  return acl::e_no_match;
+}
+
+TEST(acl, first_match) {
+  std::vector<prefix> const prefixes = {prefix("10.1.0.0/16"), prefix("2001:db8::/32"), prefix("10.0.0.0/8"),
+                                        prefix("0.0.0.0/0"), prefix("::/0")};
+  acl const list(prefixes);
+  EXPECT_EQ(prefixes.size(), list.size());
+  EXPECT_EQ(0U, list.match(address("10.1.2.3")));
+  EXPECT_EQ(2U, list.match(address("10.2.2.3")));
+  EXPECT_EQ(3U, list.match(address("192.168.0.1")));
+  EXPECT_EQ(1U, list.match(address("2001:db8::1")));
+  EXPECT_EQ(4U, list.match(address("fe80::1")));
+  EXPECT_EQ(acl::e_no_match, list.match(address()));
+
+  acl const empty;
+  EXPECT_EQ(acl::e_no_match, empty.match(address("10.1.2.3")));
+  EXPECT_EQ(acl::e_no_match, empty.match(address("::1")));
+
+  // padding of ipv4 lanes doesn't match broadcast address
+  acl const single({prefix("10.0.0.0/8")});
+  EXPECT_EQ(acl::e_no_match, single.match(address("255.255.255.255")));
+}
+
+TEST(acl, random_batch) {
+  std::mt19937_64 gen(17);
+  // addresses and prefixes are drawn from small spaces to get many matches
+  auto const random_v4 = [&gen]() {
+    return address(bro::net::proto::ip::v4::address(static_cast<uint32_t>(gen() & 0x0f0f0f0f)));
+  };
+  auto const random_v6 = [&gen]() {
+    return address(bro::net::proto::ip::v6::address(gen() & 0x0f0f0f0f0f0f0f0fULL, gen() & 0x3));
+  };
+
+  for (size_t count : {1, 7, 8, 9, 30, 61}) {
+    std::vector<prefix> prefixes;
+    for (size_t i = 0; i < count; ++i) {
+      if (gen() % 2)
+        prefixes.emplace_back(random_v4(), static_cast<uint8_t>(gen() % 33));
+      else
+        prefixes.emplace_back(random_v6(), static_cast<uint8_t>(gen() % 129));
+    }
+    acl const list(prefixes);
+
+    std::vector<address> addrs;
+    std::vector<bro::net::proto::ip::v4::address> v4_addrs;
+    std::vector<bro::net::proto::ip::v6::address> v6_addrs;
+    for (size_t i = 0; i < 1003; ++i) {
+      addrs.push_back(random_v4());
+      v4_addrs.push_back(addrs.back().to_v4());
+      addrs.push_back(random_v6());
+      v6_addrs.push_back(addrs.back().to_v6());
+    }
+
+    std::vector<uint32_t> indices(addrs.size()), v4_indices(v4_addrs.size()), v6_indices(v6_addrs.size());
+    list.match(addrs.data(), addrs.size(), indices.data());
+    list.match(v4_addrs.data(), v4_addrs.size(), v4_indices.data());
+    list.match(v6_addrs.data(), v6_addrs.size(), v6_indices.data());
+    for (size_t i = 0; i < addrs.size(); ++i) {
+      uint32_t const expected = linear_match(prefixes, addrs[i]);
+      EXPECT_EQ(expected, indices[i]) << addrs[i].to_string();
+      EXPECT_EQ(expected, i % 2 ? v6_indices[i / 2] : v4_indices[i / 2]) << addrs[i].to_string();
+    }
+  }
+}
+
+} // namespace bro::protocols::test
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/aggregate.h>
+#include <protocols/ip/numeric.h>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::prefix;
+
+static std::vector<std::string> to_strings(std::vector<prefix> const &prefixes) {
+  std::vector<std::string> res;
+  for (auto const &pref : prefixes)
+    res.push_back(pref.to_string());
+  return res;
+}
+
+TEST(aggregate, numeric) {
+  address addr("192.168.0.1");
+  EXPECT_EQ(0xc0a80001u, static_cast<uint32_t>(bro::net::proto::ip::to_number(addr)));
+  EXPECT_EQ(addr, bro::net::proto::ip::to_address(0xc0a80001u, address::version::e_v4));
+  address addr6("2001:db8::1");
+  EXPECT_EQ(addr6, bro::net::proto::ip::to_address(bro::net::proto::ip::to_number(addr6), address::version::e_v6));
+}
+
+TEST(aggregate, range_to_prefixes) {
+  std::vector<prefix> res;
+  EXPECT_TRUE(bro::net::proto::ip::range_to_prefixes(address("10.0.0.1"), address("10.0.0.10"), res));
+  EXPECT_EQ((std::vector<std::string>{"10.0.0.1/32", "10.0.0.2/31", "10.0.0.4/30", "10.0.0.8/31", "10.0.0.10/32"}),
+            to_strings(res));
+
+  res.clear();
+  EXPECT_TRUE(bro::net::proto::ip::range_to_prefixes(address("0.0.0.0"), address("255.255.255.255"), res));
+  EXPECT_EQ((std::vector<std::string>{"0.0.0.0/0"}), to_strings(res));
+
+  res.clear();
+  EXPECT_TRUE(bro::net::proto::ip::range_to_prefixes(address("::"), address("ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff"), res));
+  EXPECT_EQ((std::vector<std::string>{"::/0"}), to_strings(res));
+
+  res.clear();
+  EXPECT_TRUE(bro::net::proto::ip::range_to_prefixes(address("2001:db8::"), address("2001:db8::1:ffff"), res));
+  EXPECT_EQ((std::vector<std::string>{"2001:db8::/111"}), to_strings(res));
+
+  EXPECT_FALSE(bro::net::proto::ip::range_to_prefixes(address("10.0.0.2"), address("10.0.0.1"), res));
+  EXPECT_FALSE(bro::net::proto::ip::range_to_prefixes(address("10.0.0.1"), address("::1"), res));
+}
+
+TEST(aggregate, addresses) {
+  std::vector<address> addrs;
+  for (int i = 255; i >= 0; --i)
+    addrs.emplace_back("10.0.1." + std::to_string(i));
+  addrs.emplace_back("10.0.2.0");
+  addrs.emplace_back("10.0.2.0");
+  addrs.emplace_back("fe80::1");
+  addrs.emplace_back("fe80::0");
+  EXPECT_EQ((std::vector<std::string>{"10.0.1.0/24", "10.0.2.0/32", "fe80::/127"}),
+            to_strings(bro::net::proto::ip::aggregate(addrs)));
+}
+
+TEST(aggregate, prefixes) {
+  std::vector<prefix> prefixes{prefix("10.0.0.0/25"), prefix("10.0.0.128/25"), prefix("10.0.0.64/26"),
+                               prefix("10.0.1.0/24"), prefix("2001:db8::/33"), prefix("2001:db8:8000::/33")};
+  EXPECT_EQ((std::vector<std::string>{"10.0.0.0/23", "2001:db8::/32"}),
+            to_strings(bro::net::proto::ip::aggregate(prefixes)));
+
+  std::vector<bro::net::proto::ip::address_range> ranges{{address("10.0.0.0"), address("10.0.0.127")},
+                                                         {address("10.0.0.100"), address("10.0.0.255")}};
+  EXPECT_EQ((std::vector<std::string>{"10.0.0.0/24"}), to_strings(bro::net::proto::ip::aggregate(ranges)));
+}
+
+TEST(aggregate, exclude) {
+  std::vector<prefix> from{prefix("10.0.0.0/8"), prefix("fe80::/10")};
+  std::vector<prefix> remove{prefix("10.128.0.0/9"), prefix("10.0.0.0/10"), prefix("fe80::/10")};
+  EXPECT_EQ((std::vector<std::string>{"10.64.0.0/10"}), to_strings(bro::net::proto::ip::exclude(from, remove)));
+
+  std::vector<prefix> hole{prefix("10.0.0.1/32")};
+  EXPECT_EQ((std::vector<std::string>{"10.0.0.0/32", "10.0.0.2/31"}),
+            to_strings(bro::net::proto::ip::exclude({prefix("10.0.0.0/30")}, hole)));
+}
+
+} // namespace bro::protocols::test
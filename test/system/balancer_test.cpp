@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/balancer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::full_address;
+using bro::net::proto::ip::jump_hash;
+using bro::net::proto::ip::maglev_balancer;
+using bro::net::proto::ip::maglev_table;
+using bro::net::proto::ip::rendezvous;
+
+static std::vector<full_address> make_backends(uint32_t count, uint32_t first = 0) {
+  std::vector<full_address> backends;
+  for (uint32_t i = first; i < first + count; ++i)
+    backends.emplace_back(address(bro::net::proto::ip::v4::address(__builtin_bswap32(0x0a000000U + i))), 8080);
+  return backends;
+}
+
+static full_address make_client(uint32_t index) {
+  return full_address(address(bro::net::proto::ip::v4::address(__builtin_bswap32(0xc0a80000U + index / 64))),
+                      static_cast<uint16_t>(1024 + index % 64));
+}
+
+TEST(balancer, jump_hash) {
+  EXPECT_EQ(0U, jump_hash(uint64_t(1), 0));
+  EXPECT_EQ(0U, jump_hash(uint64_t(1), 1));
+  // only clients of the new bucket move when bucket is added
+  size_t moved = 0;
+  for (uint32_t i = 0; i < 10000; ++i) {
+    uint32_t const before = jump_hash(make_client(i), 10);
+    uint32_t const after = jump_hash(make_client(i), 11);
+    EXPECT_LT(before, 10U);
+    if (before != after) {
+      EXPECT_EQ(10U, after);
+      ++moved;
+    }
+  }
+  EXPECT_GT(moved, 600U);
+  EXPECT_LT(moved, 1300U);
+}
+
+TEST(balancer, rendezvous) {
+  EXPECT_EQ(0U, rendezvous({}).lookup(make_client(0)));
+  auto backends = make_backends(10);
+  rendezvous const before(backends);
+  backends.erase(backends.begin() + 3);
+  rendezvous const after(backends);
+  std::vector<size_t> load(10);
+  for (uint32_t i = 0; i < 10000; ++i) {
+    size_t const prev = before.lookup(make_client(i));
+    size_t const next = after.lookup(make_client(i));
+    ++load[prev];
+    if (prev != 3) {
+      EXPECT_EQ(prev < 3 ? prev : prev - 1, next);
+    }
+  }
+  for (auto count : load) {
+    EXPECT_GT(count, 800U);
+    EXPECT_LT(count, 1200U);
+  }
+}
+
+TEST(balancer, maglev) {
+  maglev_table const empty({});
+  EXPECT_EQ(maglev_table::e_no_backend, empty.lookup(make_client(0)));
+  EXPECT_EQ(nullptr, empty.select(make_client(0)));
+
+  auto backends = make_backends(100);
+  maglev_table const table(backends);
+  EXPECT_EQ(uint32_t(maglev_table::e_default_size), table.size());
+  std::vector<uint32_t> load(backends.size());
+  for (uint32_t slot = 0; slot < table.size(); ++slot)
+    ++load[table.get_slot(slot)];
+  for (auto count : load) {
+    EXPECT_GE(count, table.size() / 100);
+    EXPECT_LE(count, table.size() / 100 + 1);
+  }
+
+  // removed backend and order of the rest change few other slots
+  full_address const removed = backends[42];
+  backends.erase(backends.begin() + 42);
+  std::reverse(backends.begin(), backends.end());
+  maglev_table const next(backends);
+  size_t moved = 0;
+  for (uint32_t slot = 0; slot < table.size(); ++slot) {
+    auto const &prev_backend = table.get_backends()[table.get_slot(slot)];
+    auto const &next_backend = next.get_backends()[next.get_slot(slot)];
+    if (!(prev_backend == removed) && !(prev_backend == next_backend))
+      ++moved;
+  }
+  EXPECT_LT(moved, table.size() / 50);
+
+  std::vector<full_address> clients;
+  for (uint32_t i = 0; i < 1000; ++i)
+    clients.push_back(make_client(i));
+  std::vector<uint32_t> res(clients.size());
+  next.lookup(clients.data(), clients.size(), res.data());
+  for (size_t i = 0; i < clients.size(); ++i) {
+    EXPECT_EQ(next.lookup(clients[i]), res[i]);
+    EXPECT_EQ(&next.get_backends()[res[i]], next.select(clients[i]));
+  }
+}
+
+TEST(balancer, maglev_weights) {
+  maglev_table const table(make_backends(3), {1, 0, 3}, 10007);
+  std::vector<uint32_t> load(3);
+  for (uint32_t slot = 0; slot < table.size(); ++slot)
+    ++load[table.get_slot(slot)];
+  EXPECT_EQ(0U, load[1]);
+  EXPECT_NEAR(load[2], 3 * load[0], 4U);
+  EXPECT_EQ(maglev_table::e_no_backend, maglev_table(make_backends(2), {0, 0}).lookup(make_client(0)));
+}
+
+TEST(balancer, maglev_size) {
+  // non prime sizes are rounded up, so every permutation covers all slots
+  for (uint32_t size : {2U, 1000U, 65536U}) {
+    for (uint32_t count : {1U, 3U, 10U}) {
+      maglev_table const table(make_backends(count), {}, size);
+      EXPECT_GE(table.size(), size);
+      for (uint32_t slot = 0; slot < table.size(); ++slot)
+        EXPECT_LT(table.get_slot(slot), count);
+    }
+  }
+  EXPECT_EQ(1009U, maglev_table(make_backends(3), {}, 1000).size());
+  EXPECT_EQ(uint32_t(maglev_table::e_default_size), maglev_table(make_backends(3), {}, 65536).size());
+  EXPECT_EQ(uint32_t(maglev_table::e_default_size), maglev_table(make_backends(3), {}, 1).size());
+
+  maglev_balancer balancer(1000);
+  balancer.update(make_backends(10));
+  EXPECT_EQ(1009U, balancer.read()->size());
+}
+
+TEST(balancer, maglev_balancer) {
+  maglev_balancer balancer(1009);
+  full_address backend;
+  EXPECT_FALSE(balancer.select(make_client(0), backend));
+
+  // readers always see complete table while backends change
+  std::atomic<bool> stop{false};
+  std::atomic<size_t> lookups{0};
+  std::thread reader([&] {
+    while (!stop.load()) {
+      full_address selected;
+      if (balancer.select(make_client(static_cast<uint32_t>(lookups.load())), selected)) {
+        EXPECT_EQ(8080, selected.get_port());
+      }
+      ++lookups;
+    }
+  });
+  for (uint32_t i = 1; i < 50; ++i)
+    balancer.update(make_backends(10, i));
+  stop = true;
+  reader.join();
+
+  ASSERT_TRUE(balancer.select(make_client(0), backend));
+  auto const table = balancer.read();
+  EXPECT_EQ(*table->select(make_client(0)), backend);
+  EXPECT_EQ(10U, table->get_backends().size());
+}
+
+} // namespace bro::protocols::test
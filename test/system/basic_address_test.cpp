@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/address.h>
+
+#include <random>
+#include <vector>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::basic_address;
+using bro::net::proto::ip::family;
+using bro::net::proto::ip::mask_addresses;
+
+namespace v4 = bro::net::proto::ip::v4;
+namespace v6 = bro::net::proto::ip::v6;
+
+static_assert(sizeof(v4::address) == v4::address::e_bytes_size);
+static_assert(sizeof(v6::address) == v6::address::e_bytes_size);
+static_assert(std::is_trivially_copyable_v<v4::address> && std::is_trivially_copyable_v<v6::address>);
+static_assert(v4::address::address_family == family::e_v4 && v6::address::address_family == family::e_v6);
+
+TEST(basic_address, core) {
+  v6::address const addr("fe80::23a1:b152");
+  basic_address<family::e_v6> const &core = addr;
+  EXPECT_EQ(addr.get_data(), core.get_bytes());
+  EXPECT_EQ(addr, v6::address(core));
+  EXPECT_EQ(v6::address("52b1:a123::80fe"), core.reverse_order());
+  EXPECT_EQ(v6::address("fe80::"), core & v6::address("ffff:ffff::"));
+  EXPECT_EQ(v4::address(10, 0, 0, 0), v4::address(10, 0, 0, 1) & v4::address(255, 0, 0, 0));
+  EXPECT_EQ(v4::address(0U), v4::address());
+  EXPECT_EQ(v6::address("::"), v6::address());
+
+  // order is the same as comparing words in memory
+  std::mt19937_64 gen(5);
+  for (int i = 0; i < 1000; ++i) {
+    uint64_t const first[2] = {gen(), gen() % 4}, second[2] = {gen() % 2 ? first[0] : gen(), gen() % 4};
+    bool const less = first[0] < second[0] || (first[0] == second[0] && first[1] < second[1]);
+    EXPECT_EQ(less, v6::address(first) < v6::address(second));
+    EXPECT_EQ(less, address(v6::address(first)) < address(v6::address(second)));
+  }
+}
+
+TEST(basic_address, dispatch) {
+  address const v4_addr("192.168.1.1"), v6_addr("fe80::1"), none{};
+  EXPECT_EQ(v4::address(192, 168, 1, 1), v4_addr.get<family::e_v4>());
+  EXPECT_EQ(v6::address("fe80::1"), v6_addr.get<family::e_v6>());
+
+  auto const size = [](auto const &addr) -> size_t { return sizeof(addr); };
+  EXPECT_EQ(4U, v4_addr.visit(size));
+  EXPECT_EQ(16U, v6_addr.visit(size));
+  EXPECT_EQ(0U, none.visit(size));
+
+  EXPECT_EQ(address("192.168.0.0"), v4_addr & address("255.255.0.0"));
+  EXPECT_EQ(address("fe80::"), v6_addr & address("ffff::"));
+  EXPECT_EQ(address(), none & v4_addr);
+  EXPECT_EQ(address("1.1.168.192"), v4_addr.reverse_order());
+  EXPECT_EQ(address(), none.reverse_order());
+  EXPECT_EQ("192.168.1.1", v4_addr.to_string());
+  EXPECT_EQ("", none.to_string());
+  EXPECT_EQ(v6::address(v4_addr.to_v4().get_data(), 0, 0, 0), address(v4_addr.to_v4()).to_v6());
+}
+
+TEST(basic_address, mask_addresses) {
+  std::mt19937_64 gen(9);
+  std::vector<v6::address> addrs, res(100);
+  for (size_t i = 0; i < res.size(); ++i)
+    addrs.emplace_back(gen(), gen());
+  v6::address const mask("ffff:ffff:ffff:ffff::");
+  mask_addresses(addrs.data(), addrs.size(), mask, res.data());
+  for (size_t i = 0; i < res.size(); ++i)
+    EXPECT_EQ(addrs[i] & mask, res[i]);
+
+  // in place
+  std::vector<v4::address> v4_addrs{v4::address(10, 1, 2, 3), v4::address(192, 168, 7, 9)};
+  mask_addresses(v4_addrs.data(), v4_addrs.size(), v4::address(255, 255, 255, 0), v4_addrs.data());
+  EXPECT_EQ(v4::address(10, 1, 2, 0), v4_addrs[0]);
+  EXPECT_EQ(v4::address(192, 168, 7, 0), v4_addrs[1]);
+}
+
+} // namespace bro::protocols::test
@@ -0,0 +1,255 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/classify.h>
+
+#include <cstring>
+#include <random>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::classify;
+using bro::net::proto::ip::flow_keys;
+using bro::net::proto::ip::packet;
+using bro::net::proto::ip::packet_status;
+
+/**
+ * \brief ethernet frame builder
+ */
+class frame {
+public:
+  explicit frame(std::initializer_list<uint16_t> vlans = {}) {
+    _data.resize(12, 0xaa);
+    for (auto vlan : vlans) {
+      put16(_data.size() == 12 ? 0x88a8 : 0x8100);
+      put16(vlan);
+    }
+  }
+
+  frame &ipv4(char const *src, char const *dst, uint8_t protocol, uint16_t fragment = 0, size_t options = 0) {
+    put16(0x0800);
+    _l3 = _data.size();
+    _data.push_back(static_cast<uint8_t>(0x45 + options / 4));
+    _data.push_back(0);
+    put16(0); // total length is set by finish
+    put16(0);
+    put16(fragment);
+    _data.push_back(64);
+    _data.push_back(protocol);
+    put16(0);
+    uint32_t const source = address(src).to_v4().get_data();
+    uint32_t const destination = address(dst).to_v4().get_data();
+    put(&source, sizeof(source));
+    put(&destination, sizeof(destination));
+    _data.resize(_data.size() + options, 1);
+    return *this;
+  }
+
+  frame &ipv6(char const *src, char const *dst, uint8_t next) {
+    put16(0x86dd);
+    _l3 = _data.size();
+    _v6 = true;
+    put16(0x6000);
+    put16(0);
+    put16(0); // payload length is set by finish
+    _data.push_back(next);
+    _data.push_back(64);
+    put(address(src).to_v6().get_data(), 16);
+    put(address(dst).to_v6().get_data(), 16);
+    return *this;
+  }
+
+  frame &extension(uint8_t next, size_t size) {
+    _data.push_back(next);
+    _data.push_back(static_cast<uint8_t>(size / 8 - 1));
+    _data.resize(_data.size() + size - 2, 0);
+    return *this;
+  }
+
+  frame &fragment(uint8_t next, uint16_t offset) {
+    _data.push_back(next);
+    _data.push_back(0);
+    put16(static_cast<uint16_t>(offset << 3));
+    put16(0);
+    put16(1);
+    return *this;
+  }
+
+  frame &ports(uint16_t src, uint16_t dst, size_t size = 8) {
+    _l4 = _data.size();
+    put16(src);
+    put16(dst);
+    _data.resize(_data.size() + size - 4, 0);
+    return *this;
+  }
+
+  std::vector<uint8_t> finish(size_t padding = 0) {
+    uint16_t const length = static_cast<uint16_t>(_data.size() - _l3 - (_v6 ? 40 : 0));
+    _data[_l3 + (_v6 ? 4 : 2)] = static_cast<uint8_t>(length >> 8);
+    _data[_l3 + (_v6 ? 5 : 3)] = static_cast<uint8_t>(length);
+    _data.resize(_data.size() + padding, 0);
+    return _data;
+  }
+
+  size_t l3() const noexcept {
+    return _l3;
+  }
+
+  size_t l4() const noexcept {
+    return _l4;
+  }
+
+private:
+  void put16(uint16_t value) {
+    _data.push_back(static_cast<uint8_t>(value >> 8));
+    _data.push_back(static_cast<uint8_t>(value));
+  }
+
+  void put(void const *data, size_t size) {
+    auto const *bytes = static_cast<uint8_t const *>(data);
+    _data.insert(_data.end(), bytes, bytes + size);
+  }
+
+  std::vector<uint8_t> _data;
+  size_t _l3 = 0;
+  size_t _l4 = 0;
+  bool _v6 = false;
+};
+
+TEST(classify, burst) {
+  frame tcp4;
+  tcp4.ipv4("10.0.0.1", "10.0.0.2", 6).ports(1234, 80, 20);
+  frame udp6({100, 200});
+  udp6.ipv6("2001:db8::1", "2001:db8::2", 0).extension(17, 16).ports(53, 5353);
+  frame options4({7});
+  options4.ipv4("192.168.1.1", "192.168.1.2", 17, 0x4000, 8).ports(1, 2);
+  frame icmp6;
+  icmp6.ipv6("fe80::1", "ff02::1", 58).ports(0x8000, 0);
+
+  std::vector<std::vector<uint8_t>> frames{tcp4.finish(6), udp6.finish(), options4.finish(), icmp6.finish()};
+  std::vector<packet> packets;
+  for (auto const &data : frames)
+    packets.push_back({data.data(), data.size()});
+
+  flow_keys keys(32);
+  EXPECT_EQ(4U, classify(packets.data(), packets.size(), keys));
+  EXPECT_EQ(4U, keys._size);
+
+  EXPECT_EQ(address("10.0.0.1"), keys._sources[0]);
+  EXPECT_EQ(address("10.0.0.2"), keys._destinations[0]);
+  EXPECT_EQ(1234, keys._source_ports[0]);
+  EXPECT_EQ(80, keys._destination_ports[0]);
+  EXPECT_EQ(6, keys._protocols[0]);
+  EXPECT_EQ(0, keys._vlans[0]);
+  EXPECT_EQ(tcp4.l3(), keys._l3_offsets[0]);
+  EXPECT_EQ(tcp4.l4(), keys._l4_offsets[0]);
+
+  EXPECT_EQ(address("2001:db8::1"), keys._sources[1]);
+  EXPECT_EQ(address("2001:db8::2"), keys._destinations[1]);
+  EXPECT_EQ(53, keys._source_ports[1]);
+  EXPECT_EQ(5353, keys._destination_ports[1]);
+  EXPECT_EQ(17, keys._protocols[1]);
+  EXPECT_EQ(100, keys._vlans[1]);
+  EXPECT_EQ(22, keys._l3_offsets[1]);
+  EXPECT_EQ(udp6.l4(), keys._l4_offsets[1]);
+
+  EXPECT_EQ(address("192.168.1.1"), keys._sources[2]);
+  EXPECT_EQ(1, keys._source_ports[2]);
+  EXPECT_EQ(2, keys._destination_ports[2]);
+  EXPECT_EQ(7, keys._vlans[2]);
+  EXPECT_EQ(options4.l4(), keys._l4_offsets[2]);
+
+  EXPECT_EQ(address("ff02::1"), keys._destinations[3]);
+  EXPECT_EQ(58, keys._protocols[3]);
+  EXPECT_EQ(0, keys._source_ports[3]);
+  EXPECT_EQ(icmp6.l4(), keys._l4_offsets[3]);
+}
+
+TEST(classify, statuses) {
+  frame fragment4;
+  fragment4.ipv4("1.1.1.1", "2.2.2.2", 17, 0x2010).ports(1, 2);
+  frame fragment6;
+  fragment6.ipv6("::1", "::2", 44).fragment(6, 10).ports(1, 2);
+  frame first_fragment6;
+  first_fragment6.ipv6("::1", "::2", 44).fragment(6, 0).ports(3, 4, 20);
+  frame truncated4;
+  truncated4.ipv4("1.1.1.1", "2.2.2.2", 6);
+  auto truncated = truncated4.finish();
+  truncated.push_back(0);
+  truncated.push_back(1);
+  auto bad_version = frame().ipv4("1.1.1.1", "2.2.2.2", 6).ports(1, 2).finish();
+  bad_version[14] = 0x65;
+  std::vector<uint8_t> arp(60, 0);
+  arp[12] = 0x08;
+  arp[13] = 0x06;
+
+  std::vector<std::vector<uint8_t>> frames{
+    fragment4.finish(), fragment6.finish(), first_fragment6.finish(), truncated, bad_version, arp, {1, 2, 3}};
+  std::vector<packet> packets;
+  for (auto const &data : frames)
+    packets.push_back({data.data(), data.size()});
+
+  flow_keys keys(8);
+  EXPECT_EQ(2U, classify(packets.data(), packets.size(), keys));
+  EXPECT_EQ(packet_status::e_fragment, keys._statuses[0]);
+  EXPECT_EQ(address("1.1.1.1"), keys._sources[0]);
+  EXPECT_EQ(0, keys._source_ports[0]);
+  EXPECT_EQ(packet_status::e_fragment, keys._statuses[1]);
+  EXPECT_EQ(6, keys._protocols[1]);
+  EXPECT_EQ(packet_status::e_ok, keys._statuses[2]);
+  EXPECT_EQ(6, keys._protocols[2]);
+  EXPECT_EQ(3, keys._source_ports[2]);
+  // two bytes after ip packet are ethernet padding, so no transport header
+  EXPECT_EQ(packet_status::e_ok, keys._statuses[3]);
+  EXPECT_EQ(0, keys._l4_offsets[3]);
+  EXPECT_EQ(packet_status::e_invalid, keys._statuses[4]);
+  EXPECT_EQ(address(), keys._sources[4]);
+  EXPECT_EQ(packet_status::e_not_ip, keys._statuses[5]);
+  EXPECT_EQ(packet_status::e_truncated, keys._statuses[6]);
+}
+
+TEST(classify, truncated_headers) {
+  frame tcp6;
+  tcp6.ipv6("2001:db8::1", "2001:db8::2", 0).extension(6, 8).ports(1, 2, 20);
+  auto const data = tcp6.finish();
+  flow_keys keys(1);
+  for (size_t size = 0; size < data.size(); ++size) {
+    packet const pkt{data.data(), size};
+    classify(&pkt, 1, keys);
+    if (size < tcp6.l4() + 4) {
+      EXPECT_EQ(packet_status::e_truncated, keys._statuses[0]) << size;
+      EXPECT_EQ(0, keys._source_ports[0]) << size;
+    } else {
+      EXPECT_EQ(packet_status::e_ok, keys._statuses[0]) << size;
+      EXPECT_EQ(2, keys._destination_ports[0]) << size;
+    }
+    EXPECT_EQ(size >= tcp6.l3() + 40, keys._sources[0] == address("2001:db8::1")) << size;
+  }
+}
+
+TEST(classify, capacity_and_garbage) {
+  std::mt19937 gen(5);
+  std::vector<std::vector<uint8_t>> frames(64);
+  std::vector<packet> packets;
+  for (auto &data : frames) {
+    data.resize(gen() % 128);
+    for (auto &byte : data)
+      byte = static_cast<uint8_t>(gen());
+    // make most of frames ip to reach deeper parsers
+    if (data.size() > 14) {
+      data[12] = (gen() % 2) ? 0x08 : 0x86;
+      data[13] = data[12] == 0x08 ? 0x00 : 0xdd;
+      data[14] = static_cast<uint8_t>((data[12] == 0x08 ? 0x40 : 0x60) | (data[14] & 0x0f));
+    }
+    packets.push_back({data.data(), data.size()});
+  }
+  flow_keys keys(16);
+  classify(packets.data(), packets.size(), keys);
+  EXPECT_EQ(16U, keys._size);
+  for (size_t i = 0; i < keys._size; ++i) {
+    EXPECT_LE(keys._l3_offsets[i], packets[i]._size);
+    EXPECT_LE(keys._l4_offsets[i], packets[i]._size);
+  }
+}
+
+} // namespace bro::protocols::test
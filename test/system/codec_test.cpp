@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/codec.h>
+
+#include <random>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::address_column;
+using bro::net::proto::ip::codec;
+using bro::net::proto::ip::encode_addresses;
+
+namespace v4 = bro::net::proto::ip::v4;
+namespace v6 = bro::net::proto::ip::v6;
+
+/**
+ * hosts of few /64 networks under one /48
+ */
+std::vector<address> make_clustered(size_t size, std::mt19937_64 &gen) {
+  std::vector<address> addrs(size);
+  for (auto &addr : addrs) {
+    uint64_t const net = 0x20010db800010000ULL | (gen() % 16);
+    addr = address(v6::address(__builtin_bswap64(net), __builtin_bswap64(gen() % 4096)));
+  }
+  return addrs;
+}
+
+void check_round_trip(std::vector<address> const &addrs) {
+  std::vector<uint8_t> data;
+  EXPECT_TRUE(encode_addresses(addrs.data(), addrs.size(), data));
+  address_column column;
+  EXPECT_TRUE(column.open(data.data(), data.size()));
+  EXPECT_EQ(addrs.size(), column.size());
+  EXPECT_EQ((addrs.size() + codec::e_block_size - 1) / codec::e_block_size, column.get_block_count());
+
+  std::vector<address> decoded(column.get_block_count() * codec::e_block_size);
+  column.decode(decoded.data());
+  decoded.resize(addrs.size());
+  EXPECT_EQ(addrs, decoded);
+  for (size_t i = 0; i < addrs.size(); ++i)
+    EXPECT_EQ(addrs[i], column.get(i)) << i;
+  EXPECT_EQ(address(), column.get(addrs.size()));
+  EXPECT_EQ(0U, column.decode_block(column.get_block_count(), decoded.data()));
+}
+
+TEST(codec, round_trip) {
+  std::mt19937_64 gen(1);
+  check_round_trip({});
+  check_round_trip({address("10.0.0.1")});
+  check_round_trip({address("::"), address("ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff"), address("255.255.255.255"),
+                    address("0.0.0.0"), address("::ffff:10.0.0.1"), address("10.0.0.1")});
+  check_round_trip(make_clustered(1000, gen));
+
+  // random, mixed and partial blocks
+  for (size_t size : {127, 128, 129, 1000}) {
+    std::vector<address> addrs(size);
+    for (auto &addr : addrs) {
+      if (gen() % 3)
+        addr = address(v6::address(gen(), gen()));
+      else
+        addr = address(v4::address(static_cast<uint32_t>(gen())));
+    }
+    check_round_trip(addrs);
+  }
+
+  // all widths of identifiers
+  for (unsigned width = 1; width <= 64; ++width) {
+    std::vector<address> addrs(200);
+    for (auto &addr : addrs) {
+      uint64_t const iid = width == 64 ? gen() : gen() & ((uint64_t(1) << width) - 1);
+      addr = address(v6::address(__builtin_bswap64(0x20010db8ULL << 32), __builtin_bswap64(iid)));
+    }
+    check_round_trip(addrs);
+  }
+}
+
+TEST(codec, compression) {
+  std::mt19937_64 gen(2);
+  auto const v6_addrs = make_clustered(100000, gen);
+  std::vector<uint8_t> data;
+  ASSERT_TRUE(encode_addresses(v6_addrs.data(), v6_addrs.size(), data));
+  EXPECT_GE(v6_addrs.size() * v6::address::e_bytes_size / data.size(), 4U);
+
+  // one /16 of ipv4 hosts
+  std::vector<address> v4_addrs(100000);
+  for (auto &addr : v4_addrs)
+    addr = address(v4::address(__builtin_bswap32(0x0a000000U | static_cast<uint32_t>(gen() % 65536))));
+  EXPECT_TRUE(encode_addresses(v4_addrs.data(), v4_addrs.size(), data));
+  // 16 bit identifiers and block headers
+  EXPECT_LE(data.size(), v4_addrs.size() * 2 + (v4_addrs.size() / codec::e_block_size + 1) * 28);
+}
+
+TEST(codec, invalid) {
+  std::vector<uint8_t> data;
+  address const unset[] = {address("10.0.0.1"), address()};
+  EXPECT_FALSE(encode_addresses(unset, 2, data));
+
+  std::mt19937_64 gen(3);
+  auto const addrs = make_clustered(300, gen);
+  EXPECT_TRUE(encode_addresses(addrs.data(), addrs.size(), data));
+  address_column column;
+  EXPECT_TRUE(column.open(data.data(), data.size()));
+  EXPECT_EQ(16U, column.get_prefix_count());
+
+  for (size_t size = 0; size < data.size(); ++size)
+    EXPECT_FALSE(column.open(data.data(), size)) << size;
+  EXPECT_EQ(0U, column.size());
+
+  auto broken = data;
+  broken[0] ^= 1;
+  EXPECT_FALSE(column.open(broken.data(), broken.size()));
+
+  // prefix index base of the first block is out of dictionary
+  broken = data;
+  broken[12 + 16 * sizeof(uint64_t) + 4 * sizeof(uint32_t) + 8] = 16;
+  EXPECT_FALSE(column.open(broken.data(), broken.size()));
+}
+
+} // namespace bro::protocols::test
@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/connection_table.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::connection_key;
+using bro::net::proto::ip::connection_table;
+using bro::net::proto::ip::full_address;
+using bro::net::proto::ip::rss_hash;
+
+connection_key make_key(uint32_t index) {
+  return {full_address(address(bro::net::proto::ip::v4::address(__builtin_bswap32(0x0a000000U + index))),
+                       static_cast<uint16_t>(1024 + index % 60000)),
+          full_address(address("192.168.0.1"), 443)};
+}
+
+TEST(connection_table, rss_hash) {
+  // Microsoft RSS verification suite (tcp with ipv4 and ipv6)
+  EXPECT_EQ(0x51ccc178U,
+            rss_hash(full_address(address("66.9.149.187"), 2794), full_address(address("161.142.100.80"), 1766)));
+  EXPECT_EQ(0xc626b0eaU,
+            rss_hash(full_address(address("199.92.111.2"), 14230), full_address(address("65.69.140.83"), 4739)));
+  EXPECT_EQ(0x40207d3dU, rss_hash(full_address(address("3ffe:2501:200:1fff::7"), 2794),
+                                  full_address(address("3ffe:2501:200:3::1"), 1766)));
+  EXPECT_EQ(0U, rss_hash(full_address(address("10.0.0.1"), 1), full_address(address("::1"), 1)));
+}
+
+TEST(connection_table, shard) {
+  connection_table<std::string> table(4);
+  ASSERT_EQ(4U, table.get_shard_count());
+
+  auto const key = make_key(1);
+  size_t const index = table.get_shard_index(key);
+  EXPECT_EQ((rss_hash(key._source, key._destination) & 127) % 4, index);
+  auto &owner = table.get_shard(key);
+  EXPECT_EQ(index, owner.get_index());
+
+  auto [value, inserted] = owner.insert(key, "state");
+  EXPECT_TRUE(inserted);
+  EXPECT_EQ("state", *value);
+  std::tie(value, inserted) = owner.insert(key, "other");
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ("state", *value);
+  EXPECT_EQ(1U, owner.size());
+  EXPECT_NE(nullptr, owner.find(key));
+  EXPECT_EQ(nullptr, owner.find(make_key(2)));
+
+  size_t const target = (index + 1) % 4;
+  EXPECT_FALSE(owner.migrate(make_key(2), target));
+  EXPECT_FALSE(owner.migrate(key, 4));
+  EXPECT_TRUE(owner.migrate(key, target));
+  EXPECT_EQ(nullptr, owner.find(key));
+  EXPECT_EQ(nullptr, table.get_shard(target).find(key));
+  ASSERT_EQ(1U, table.get_shard(target).poll());
+  EXPECT_EQ("state", *table.get_shard(target).find(key));
+  EXPECT_TRUE(table.get_shard(target).erase(key));
+  EXPECT_FALSE(table.get_shard(target).erase(key));
+
+  // pending messages are freed with table
+  table.get_shard(0).send(key, "pending");
+}
+
+TEST(connection_table, indirection) {
+  connection_table<int> table(2);
+  EXPECT_FALSE(table.set_indirection({}));
+  EXPECT_FALSE(table.set_indirection({0, 1, 0}));
+  EXPECT_FALSE(table.set_indirection({0, 2}));
+  EXPECT_TRUE(table.set_indirection({1}));
+  for (uint32_t i = 0; i < 100; ++i)
+    EXPECT_EQ(1U, table.get_shard_index(make_key(i)));
+}
+
+TEST(connection_table, migration) {
+  // every thread owns one shard and hands all connections to the next one
+  size_t const shard_count = 4;
+  uint32_t const connections = 10000;
+  connection_table<uint32_t> table(shard_count);
+  for (uint32_t i = 0; i < connections; ++i) {
+    auto const key = make_key(i);
+    table.get_shard(key).insert(key, i);
+  }
+
+  std::vector<size_t> sent(shard_count), received(shard_count);
+  for (size_t index = 0; index < shard_count; ++index)
+    sent[index] = table.get_shard(index).size();
+
+  std::vector<std::thread> threads;
+  for (size_t index = 0; index < shard_count; ++index) {
+    threads.emplace_back([&table, &sent, &received, index, shard_count] {
+      auto &own = table.get_shard(index);
+      std::vector<connection_key> keys;
+      own.for_each([&keys](connection_key const &key, uint32_t) { keys.push_back(key); });
+      for (auto const &key : keys)
+        own.migrate(key, (index + 1) % shard_count);
+      size_t const expected = sent[(index + shard_count - 1) % shard_count];
+      for (auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+           received[index] < expected && std::chrono::steady_clock::now() < deadline;)
+        received[index] += own.poll();
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  size_t total = 0;
+  for (size_t index = 0; index < shard_count; ++index) {
+    EXPECT_EQ(sent[(index + shard_count - 1) % shard_count], received[index]);
+    EXPECT_EQ(received[index], table.get_shard(index).size());
+    total += received[index];
+  }
+  EXPECT_EQ(connections, total);
+  for (uint32_t i = 0; i < connections; ++i) {
+    auto const key = make_key(i);
+    auto const *value = table.get_shard((table.get_shard_index(key) + 1) % shard_count).find(key);
+    ASSERT_NE(nullptr, value);
+    EXPECT_EQ(i, *value);
+  }
+}
+
+} // namespace bro::protocols::test
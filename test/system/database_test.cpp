@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/database.h>
+
+#include <cstdio>
+#include <map>
+#include <random>
+#include <unistd.h>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::database;
+using bro::net::proto::ip::database_builder;
+using bro::net::proto::ip::prefix;
+
+static std::string lookup(database const &db, char const *addr, uint8_t *length = nullptr) {
+  uint32_t offset = 0;
+  uint8_t prefix_length = 0;
+  if (!db.lookup(address(addr), offset, prefix_length))
+    return "-";
+  if (length)
+    *length = prefix_length;
+  return std::string(db.get_value(offset));
+}
+
+TEST(database, lookup) {
+  std::string const path = testing::TempDir() + "database_test.db";
+  database_builder builder;
+  EXPECT_TRUE(builder.insert(prefix("10.1.0.0/16"), "AS2"));
+  EXPECT_TRUE(builder.insert(prefix("10.0.0.0/8"), "AS1"));
+  EXPECT_TRUE(builder.insert(prefix("10.1.2.0/24"), "AS3"));
+  EXPECT_TRUE(builder.insert(prefix("192.168.0.1/32"), "AS1"));
+  EXPECT_TRUE(builder.insert(prefix("2001:db8::/32"), "AS6"));
+  EXPECT_TRUE(builder.insert(prefix("2001:db8:1::/48"), "AS7"));
+  EXPECT_FALSE(builder.insert(prefix(), "none"));
+  EXPECT_TRUE(builder.save(path));
+
+  database db;
+  EXPECT_TRUE(db.open(path));
+  uint8_t length = 0;
+  // 10.0.0.0/8 is split by 10.1.0.0/16, so 10.200.0.1 is in 10.128.0.0/9
+  EXPECT_EQ("AS1", lookup(db, "10.200.0.1", &length));
+  EXPECT_EQ(9, length);
+  EXPECT_EQ("AS2", lookup(db, "10.1.200.1", &length));
+  EXPECT_EQ(17, length);
+  EXPECT_EQ("AS3", lookup(db, "10.1.2.3", &length));
+  EXPECT_EQ(24, length);
+  EXPECT_EQ("AS1", lookup(db, "192.168.0.1", &length));
+  EXPECT_EQ(32, length);
+  EXPECT_EQ("-", lookup(db, "192.168.0.2"));
+  EXPECT_EQ("-", lookup(db, "11.0.0.1"));
+  EXPECT_EQ("AS3", lookup(db, "::ffff:10.1.2.3"));
+  EXPECT_EQ("AS3", lookup(db, "::10.1.2.3"));
+  EXPECT_EQ("AS6", lookup(db, "2001:db8:2::1", &length));
+  EXPECT_EQ(47, length);
+  EXPECT_EQ("AS7", lookup(db, "2001:db8:1::1", &length));
+  EXPECT_EQ(48, length);
+  EXPECT_EQ("-", lookup(db, "2001:db9::1"));
+
+  uint32_t first = 0, second = 0;
+  EXPECT_TRUE(db.lookup(address("10.200.0.1"), first));
+  EXPECT_TRUE(db.lookup(address("192.168.0.1"), second));
+  EXPECT_EQ(second, first);
+  EXPECT_TRUE(db.get_value(UINT32_MAX - 1).empty());
+
+  db.close();
+  EXPECT_FALSE(db.lookup(address("10.0.0.1"), first));
+  std::remove(path.c_str());
+}
+
+TEST(database, default_route) {
+  std::string const path = testing::TempDir() + "database_default_test.db";
+  database_builder builder;
+  EXPECT_TRUE(builder.insert(prefix("::/0"), "default"));
+  EXPECT_TRUE(builder.save(path));
+  database db;
+  EXPECT_TRUE(db.open(path));
+  EXPECT_EQ(1U, db.get_node_count());
+  EXPECT_EQ("default", lookup(db, "1.2.3.4"));
+  EXPECT_EQ("default", lookup(db, "fe80::1"));
+
+  database_builder empty;
+  EXPECT_TRUE(empty.save(path));
+  EXPECT_TRUE(db.open(path));
+  EXPECT_EQ("-", lookup(db, "1.2.3.4"));
+  std::remove(path.c_str());
+}
+
+TEST(database, invalid_file) {
+  std::string const path = testing::TempDir() + "database_invalid_test.db";
+  database_builder builder;
+  EXPECT_TRUE(builder.insert(prefix("10.0.0.0/8"), "AS1"));
+  EXPECT_TRUE(builder.save(path));
+
+  FILE *file = fopen(path.c_str(), "r+b");
+  ASSERT_NE(nullptr, file);
+  fseek(file, 0, SEEK_END);
+  long const size = ftell(file);
+  fclose(file);
+  EXPECT_EQ(0, truncate(path.c_str(), size - 1));
+
+  database db;
+  EXPECT_FALSE(db.open(path));
+
+  // trie runs past the end of file, data size wraps total size back to file size
+  long const crafted_size = 7100;
+  uint32_t const node_count = 1000;
+  uint64_t const data_size = uint64_t(crafted_size) - 64 - uint64_t(node_count) * 8;
+  EXPECT_EQ(0, truncate(path.c_str(), crafted_size));
+  file = fopen(path.c_str(), "r+b");
+  ASSERT_NE(nullptr, file);
+  fseek(file, 16, SEEK_SET);
+  fwrite(&node_count, sizeof(node_count), 1, file);
+  fseek(file, 24, SEEK_SET);
+  fwrite(&data_size, sizeof(data_size), 1, file);
+  fclose(file);
+  EXPECT_FALSE(db.open(path));
+  EXPECT_FALSE(db.open(testing::TempDir() + "no_such_database.db"));
+  std::remove(path.c_str());
+}
+
+TEST(database, random_prefixes) {
+  std::string const path = testing::TempDir() + "database_random_test.db";
+  std::mt19937 gen(9);
+  std::map<std::pair<uint32_t, uint8_t>, std::string> prefixes;
+  database_builder builder;
+  for (size_t i = 0; i < 2000; ++i) {
+    uint8_t const length = static_cast<uint8_t>(gen() % 17 + 8);
+    prefix const pref(address(bro::net::proto::ip::v4::address(static_cast<uint32_t>(gen() & 0xffff))), length);
+    std::string const value = "value" + std::to_string(gen() % 100);
+    EXPECT_TRUE(builder.insert(pref, value));
+    prefixes[{pref.get_address().to_v4().get_data(), length}] = value;
+  }
+  EXPECT_TRUE(builder.save(path));
+
+  database db;
+  EXPECT_TRUE(db.open(path));
+  for (size_t i = 0; i < 20000; ++i) {
+    address const addr(bro::net::proto::ip::v4::address(static_cast<uint32_t>(gen() & 0xffff)));
+    std::string expected = "-";
+    for (int length = 32; length >= 0; --length) {
+      prefix const pref(addr, static_cast<uint8_t>(length));
+      auto const it = prefixes.find({pref.get_address().to_v4().get_data(), static_cast<uint8_t>(length)});
+      if (it != prefixes.end()) {
+        expected = it->second;
+        break;
+      }
+    }
+    uint32_t offset = 0;
+    std::string const found = db.lookup(addr, offset) ? std::string(db.get_value(offset)) : "-";
+    EXPECT_EQ(expected, found) << addr.to_string();
+  }
+  std::remove(path.c_str());
+}
+
+} // namespace bro::protocols::test
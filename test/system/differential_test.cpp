@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/endpoint.h>
+#include <protocols/ip/format.h>
+
+#include <arpa/inet.h>
+#include <cstring>
+#include <random>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+
+/**
+ * \brief generator of almost valid address strings
+ *
+ * produces leading zeros, octets and groups out of range, "::" in every
+ * position (including twice), embedded ipv4 and wrong number of parts
+ */
+class address_strings {
+public:
+  explicit address_strings(uint32_t seed)
+    : _gen(seed) {}
+
+  std::string v4() {
+    size_t const octets = chance(10) ? _gen() % 6 : 4;
+    std::string str;
+    for (size_t i = 0; i < octets; ++i) {
+      if (i)
+        str += '.';
+      str += octet();
+    }
+    return str;
+  }
+
+  std::string v6() {
+    bool const embedded = chance(4);
+    size_t groups = (embedded ? 6 : 8);
+    if (chance(10))
+      groups = groups + 1 - _gen() % 3;
+    size_t const compress = chance(3) ? groups + 1 : _gen() % (groups + 1);
+    std::string str;
+    for (size_t i = 0; i < groups; ++i) {
+      if (i == compress) {
+        str += "::";
+        if (chance(3))
+          continue;
+      } else if (i) {
+        str += ':';
+      }
+      str += group();
+    }
+    if (compress == groups)
+      str += "::";
+    if (chance(20))
+      str += "::";
+    if (embedded) {
+      if (str.back() != ':')
+        str += ':';
+      str += v4();
+    }
+    return str;
+  }
+
+private:
+  bool chance(uint32_t one_of) {
+    return _gen() % one_of == 0;
+  }
+
+  std::string octet() {
+    uint32_t const value = chance(10) ? _gen() % 300 : _gen() % 256;
+    std::string str = std::to_string(value);
+    if (chance(10))
+      str.insert(0, 1 + _gen() % 2, '0');
+    return str;
+  }
+
+  std::string group() {
+    static char const digits[] = "0123456789abcdefABCDEF";
+    size_t const size = chance(20) ? _gen() % 6 : 1 + _gen() % 4;
+    std::string str;
+    for (size_t i = 0; i < size; ++i)
+      str += digits[_gen() % (sizeof(digits) - 1)];
+    return str;
+  }
+
+  std::mt19937 _gen;
+};
+
+static bool libc_parse(std::string const &str, uint8_t (&bytes)[16]) {
+  return inet_pton(str.find(':') != std::string::npos ? AF_INET6 : AF_INET, str.c_str(), bytes) == 1;
+}
+
+static void expect_same_as_libc(std::string const &str) {
+  address addr;
+  uint8_t expected[16];
+  bool const parsed = static_cast<bool>(bro::net::proto::ip::parse_address(str, addr));
+  ASSERT_EQ(libc_parse(str, expected), parsed) << str;
+  if (!parsed)
+    return;
+
+  char buffer[bro::net::proto::ip::e_max_v6_string];
+  char reference[INET6_ADDRSTRLEN];
+  if (addr.get_version() == address::version::e_v6) {
+    EXPECT_EQ(0, memcmp(addr.to_v6().get_data(), expected, 16)) << str;
+    inet_ntop(AF_INET6, expected, reference, sizeof(reference));
+  } else {
+    uint32_t const dword = addr.to_v4().get_data();
+    EXPECT_EQ(0, memcmp(&dword, expected, 4)) << str;
+    inet_ntop(AF_INET, expected, reference, sizeof(reference));
+  }
+  EXPECT_EQ(reference, std::string(buffer, bro::net::proto::ip::format_to(buffer, addr))) << str;
+  EXPECT_EQ(reference, addr.to_string()) << str;
+}
+
+TEST(differential, edge_cases) {
+  for (char const *str :
+       {"0.0.0.0", "255.255.255.255", "01.2.3.4", "1.2.3.04", "0x1.2.3.4", "1.2.3", "1.2.3.4.5", "1.2.3.4.", " 1.2.3.4",
+        "1.2.3.4 ", "::", ":::", "::1", "1::", ":1::", "::1:", "1::2::3", "::0:0:0:0:0:0:0", "::1:2:3:4:5:6:7",
+        "1:2:3:4:5:6:7::", "1:2:3:4::5:6:7:8", "1:2:3:4:5:6:7:8:9", "0001:2:3:4:5:6:7:8", "00001::", "::ffff:1.2.3.4",
+        "::ffff:01.2.3.4", "::ffff:1.2.3", "::1.2.3.4", "1:2:3:4:5:6:1.2.3.4", "1:2:3:4:5:6:7:1.2.3.4",
+        "1.2.3.4::", "1::1.2.3.4:5", "FFFF::ffff", "fe80::1%1", ""})
+    expect_same_as_libc(str);
+}
+
+TEST(differential, generated_strings) {
+  address_strings strings(17);
+  for (size_t i = 0; i < 50000; ++i) {
+    expect_same_as_libc(strings.v4());
+    expect_same_as_libc(strings.v6());
+  }
+}
+
+TEST(differential, random_bytes) {
+  std::mt19937_64 gen(23);
+  for (size_t i = 0; i < 50000; ++i) {
+    uint8_t bytes[16];
+    // mostly zero bytes make runs of zero groups and embedded ipv4 forms
+    for (auto &byte : bytes)
+      byte = (gen() % 3) ? 0 : static_cast<uint8_t>(gen());
+    if (gen() % 8 == 0)
+      bytes[10] = bytes[11] = 0xff;
+    char reference[INET6_ADDRSTRLEN];
+    inet_ntop(AF_INET6, bytes, reference, sizeof(reference));
+    expect_same_as_libc(reference);
+
+    uint32_t dword;
+    memcpy(&dword, bytes + 12, sizeof(dword));
+    in_addr native;
+    native.s_addr = dword;
+    char buffer[bro::net::proto::ip::e_max_v4_string];
+    EXPECT_EQ(inet_ntoa(native),
+              std::string(buffer, bro::net::proto::ip::format_to(buffer, bro::net::proto::ip::v4::address(dword))));
+  }
+}
+
+} // namespace bro::protocols::test
@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/endpoint.h>
+
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <random>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::endpoint_error;
+using bro::net::proto::ip::full_address;
+using bro::net::proto::ip::parse_endpoint;
+
+static std::string to_chars(full_address const &addr) {
+  char buffer[bro::net::proto::ip::e_max_endpoint_string];
+  return std::string(buffer, bro::net::proto::ip::endpoint_to_chars(buffer, addr));
+}
+
+TEST(endpoint, parse) {
+  full_address addr;
+  EXPECT_TRUE(parse_endpoint("192.168.0.1:8080", addr));
+  EXPECT_EQ(full_address(address("192.168.0.1"), 8080), addr);
+  EXPECT_FALSE(addr.get_scope_id());
+
+  EXPECT_TRUE(parse_endpoint("10.0.0.1", addr));
+  EXPECT_EQ(full_address(address("10.0.0.1"), 0), addr);
+
+  EXPECT_TRUE(parse_endpoint("[2001:db8::1]:443", addr));
+  EXPECT_EQ(full_address(address("2001:db8::1"), 443), addr);
+
+  EXPECT_TRUE(parse_endpoint("[::ffff:1.2.3.4]:65535", addr));
+  EXPECT_EQ(full_address(address("::ffff:1.2.3.4"), 65535), addr);
+
+  EXPECT_TRUE(parse_endpoint("[fe80::1%7]:22", addr));
+  EXPECT_EQ(full_address(address("fe80::1"), 22), addr);
+  EXPECT_EQ(7U, addr.get_scope_id());
+
+  EXPECT_TRUE(parse_endpoint("[fe80::1%lo]", addr));
+  EXPECT_EQ(full_address(address("fe80::1"), 0), addr);
+  EXPECT_EQ(if_nametoindex("lo"), addr.get_scope_id());
+
+  EXPECT_TRUE(parse_endpoint("fe80::1%3", addr));
+  EXPECT_EQ(full_address(address("fe80::1"), 0), addr);
+  EXPECT_EQ(3U, addr.get_scope_id());
+}
+
+TEST(endpoint, errors) {
+  struct {
+    char const *_str;
+    endpoint_error _error;
+    size_t _position;
+  } const cases[] = {
+    {"", endpoint_error::e_empty, 0},
+    {"1.2.3:80", endpoint_error::e_invalid_address, 5},
+    {"1.2.3.256:80", endpoint_error::e_invalid_address, 8},
+    {"1.2.3.04", endpoint_error::e_invalid_address, 7},
+    {"1.2.3.4%1:80", endpoint_error::e_invalid_scope, 7},
+    {"1.2.3.4:", endpoint_error::e_invalid_port, 8},
+    {"1.2.3.4:65536", endpoint_error::e_invalid_port, 12},
+    {"1.2.3.4:8x", endpoint_error::e_invalid_port, 9},
+    {"[::1", endpoint_error::e_missing_bracket, 4},
+    {"[::1]80", endpoint_error::e_trailing_data, 5},
+    {"[::1]:", endpoint_error::e_invalid_port, 6},
+    {"[::g]:80", endpoint_error::e_invalid_address, 3},
+    {"[fe80::1%]:80", endpoint_error::e_invalid_scope, 9},
+    {"[fe80::1%no_such_interface]:80", endpoint_error::e_invalid_scope, 9},
+    {"[fe80::1%4294967296]:80", endpoint_error::e_invalid_scope, 9},
+    {"[fe80::1%0]:80", endpoint_error::e_invalid_scope, 9},
+    {"1:2:3", endpoint_error::e_invalid_address, 5},
+  };
+  for (auto const &test : cases) {
+    full_address addr;
+    auto const result = parse_endpoint(test._str, addr);
+    EXPECT_FALSE(result) << test._str;
+    EXPECT_EQ(test._error, result._error) << test._str;
+    EXPECT_EQ(test._position, result._position) << test._str;
+  }
+}
+
+TEST(endpoint, to_chars) {
+  EXPECT_EQ("192.168.0.1:80", to_chars(full_address(address("192.168.0.1"), 80)));
+  EXPECT_EQ("[2001:db8::1]:443", to_chars(full_address(address("2001:db8::1"), 443)));
+  full_address addr(address("fe80::1"), 22);
+  addr.set_scope_id(UINT32_MAX);
+  EXPECT_EQ("[fe80::1%4294967295]:22", to_chars(addr));
+  EXPECT_LE(to_chars(addr).size(), size_t(bro::net::proto::ip::e_max_endpoint_string));
+}
+
+TEST(endpoint, batch_round_trip) {
+  std::mt19937_64 gen(3);
+  std::vector<full_address> addrs;
+  for (size_t i = 0; i < 512; ++i) {
+    full_address addr;
+    if (i % 2)
+      addr = full_address(bro::net::proto::ip::v4::address(static_cast<uint32_t>(gen())), static_cast<uint16_t>(gen()));
+    else
+      addr = full_address(bro::net::proto::ip::v6::address(gen(), gen()), static_cast<uint16_t>(gen()));
+    if (i % 4 == 0)
+      addr.set_scope_id(static_cast<uint32_t>(gen()) | 1);
+    addrs.push_back(addr);
+  }
+
+  std::vector<std::string> strings;
+  for (auto const &addr : addrs)
+    strings.push_back(to_chars(addr));
+  std::vector<std::string_view> views(strings.begin(), strings.end());
+  std::vector<full_address> parsed(addrs.size());
+  std::vector<bro::net::proto::ip::endpoint_result> results(addrs.size());
+  EXPECT_EQ(addrs.size(),
+            bro::net::proto::ip::parse_endpoints(views.data(), views.size(), parsed.data(), results.data()));
+  for (size_t i = 0; i < addrs.size(); ++i) {
+    EXPECT_EQ(addrs[i], parsed[i]) << strings[i];
+    EXPECT_EQ(addrs[i].get_scope_id(), parsed[i].get_scope_id()) << strings[i];
+  }
+}
+
+TEST(endpoint, parse_address_matches_inet_pton) {
+  std::vector<std::string> inputs = {
+    "::",        "::1",        "1::",           ":",         ":::",       "1:2:3:4:5:6:7:8",  "1:2:3:4:5:6:7:8:9",
+    "1::2::3",   "::1.2.3.4",  "::ffff:1.2.3.4", "12345::",  "1:",        "1:2:3:4:5:6:1.2.3.4", "1:2:3:4:5:6:7:1.2.3.4",
+    "0.0.0.0",   "00.0.0.0",   "1.2.3.4.",      "1..2.3",    "::1.2.3",   "255.255.255.255",  "256.1.1.1",
+    "a.b.c.d"};
+  std::mt19937 gen(11);
+  char const alphabet[] = "0123456789abcdefABCDEF:.";
+  for (size_t i = 0; i < 20000; ++i) {
+    std::string str(gen() % 24, ' ');
+    for (auto &c : str)
+      c = alphabet[gen() % (sizeof(alphabet) - 1)];
+    inputs.push_back(str);
+  }
+
+  for (auto const &input : inputs) {
+    address addr;
+    bool const parsed = static_cast<bool>(bro::net::proto::ip::parse_address(input, addr));
+    bool const is_v6 = input.find(':') != std::string::npos;
+    unsigned char expected[16];
+    bool const reference = inet_pton(is_v6 ? AF_INET6 : AF_INET, input.c_str(), expected) == 1;
+    EXPECT_EQ(reference, parsed) << input;
+    if (parsed) {
+      EXPECT_EQ(address(input), addr) << input;
+    }
+  }
+}
+
+} // namespace bro::protocols::test
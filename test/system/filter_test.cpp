@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/filter.h>
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+
+static std::vector<bro::net::proto::ip::v4::address> make_v4(uint32_t first, uint32_t count) {
+  std::vector<bro::net::proto::ip::v4::address> res;
+  for (uint32_t i = 0; i < count; ++i)
+    res.emplace_back(first + i);
+  return res;
+}
+
+TEST(bloom_filter, contains) {
+  bro::net::proto::ip::bloom_filter filter(10000);
+  auto const added = make_v4(0, 10000);
+  for (auto const &addr : added)
+    EXPECT_TRUE(filter.add(addr));
+  filter.add(bro::net::proto::ip::v6::address("fe80::1"));
+
+  for (auto const &addr : added)
+    EXPECT_TRUE(filter.contains(addr));
+  EXPECT_TRUE(filter.contains(address("fe80::1")));
+
+  auto const other = make_v4(1000000, 10000);
+  auto const res = std::make_unique<bool[]>(other.size());
+  filter.contains(other.data(), other.size(), res.get());
+  size_t false_positives = 0;
+  for (size_t i = 0; i < other.size(); ++i) {
+    false_positives += res[i];
+    EXPECT_EQ(filter.contains(other[i]), res[i]);
+  }
+  EXPECT_LT(false_positives, 100u);
+}
+
+TEST(bloom_filter, save_load) {
+  std::string const path = testing::TempDir() + "bloom_filter_test.bin";
+  bro::net::proto::ip::bloom_filter filter(1000);
+  filter.add(address("10.0.0.1"));
+  ASSERT_TRUE(filter.save(path));
+
+  bro::net::proto::ip::bloom_filter loaded;
+  ASSERT_TRUE(loaded.load(path));
+  EXPECT_EQ(filter.get_size_in_bytes(), loaded.get_size_in_bytes());
+  EXPECT_TRUE(loaded.contains(address("10.0.0.1")));
+  EXPECT_FALSE(loaded.add(address("10.0.0.2")));
+  std::remove(path.c_str());
+}
+
+TEST(bloom_filter, corrupt_header) {
+  std::string const path = testing::TempDir() + "bloom_filter_corrupt_test.bin";
+  bro::net::proto::ip::bloom_filter filter(1000);
+  ASSERT_TRUE(filter.save(path));
+
+  // block count multiplied by block size wraps back to real data size
+  FILE *file = fopen(path.c_str(), "r+b");
+  ASSERT_NE(nullptr, file);
+  uint64_t size = 0;
+  fseek(file, 16, SEEK_SET);
+  ASSERT_EQ(1u, fread(&size, sizeof(size), 1, file));
+  size += uint64_t(1) << 59;
+  fseek(file, 16, SEEK_SET);
+  fwrite(&size, sizeof(size), 1, file);
+  fclose(file);
+
+  bro::net::proto::ip::bloom_filter loaded;
+  EXPECT_FALSE(loaded.load(path));
+  std::remove(path.c_str());
+}
+
+TEST(cuckoo_filter, contains) {
+  bro::net::proto::ip::cuckoo_filter filter(10000);
+  auto const added = make_v4(0, 10000);
+  for (auto const &addr : added)
+    EXPECT_TRUE(filter.add(addr));
+  EXPECT_EQ(10000u, filter.get_count());
+
+  auto const res = std::make_unique<bool[]>(added.size());
+  filter.contains(added.data(), added.size(), res.get());
+  for (size_t i = 0; i < added.size(); ++i)
+    EXPECT_TRUE(res[i]);
+
+  size_t false_positives = 0;
+  for (auto const &addr : make_v4(1000000, 10000))
+    false_positives += filter.contains(addr);
+  EXPECT_LT(false_positives, 100u);
+
+  for (auto const &addr : added)
+    EXPECT_TRUE(filter.remove(address(addr)));
+  EXPECT_EQ(0u, filter.get_count());
+  EXPECT_FALSE(filter.contains(added[0]));
+}
+
+TEST(cuckoo_filter, save_load) {
+  std::string const path = testing::TempDir() + "cuckoo_filter_test.bin";
+  bro::net::proto::ip::cuckoo_filter filter(1000);
+  filter.add(bro::net::proto::ip::v6::address("2001:db8::1"));
+  ASSERT_TRUE(filter.save(path));
+
+  bro::net::proto::ip::cuckoo_filter loaded;
+  ASSERT_TRUE(loaded.load(path));
+  EXPECT_EQ(1u, loaded.get_count());
+  EXPECT_TRUE(loaded.contains(address("2001:db8::1")));
+  EXPECT_FALSE(loaded.add(address("2001:db8::2")));
+  std::remove(path.c_str());
+}
+
+} // namespace bro::protocols::test
@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/format.h>
+#ifdef WITH_FMT
+#include <protocols/ip/fmt.h>
+#endif
+
+#include <arpa/inet.h>
+#include <cstring>
+#include <random>
+#include <sstream>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::format_spec;
+using bro::net::proto::ip::full_address;
+
+template <typename T> static std::string format(T const &addr, format_spec const &spec = {}) {
+  char buffer[bro::net::proto::ip::e_max_full_string];
+  return std::string(buffer, bro::net::proto::ip::format_to(buffer, addr, spec));
+}
+
+TEST(format, v4) {
+  bro::net::proto::ip::v4::address addr("10.0.200.1");
+  EXPECT_EQ("10.0.200.1", format(addr));
+  EXPECT_EQ("010.000.200.001", format(addr, {false, false, false, true}));
+  EXPECT_EQ("1.200.0.10", format(addr, {false, false, true, false}));
+}
+
+TEST(format, v6) {
+  bro::net::proto::ip::v6::address addr("fe80::23a1:b152");
+  EXPECT_EQ("fe80::23a1:b152", format(addr));
+  EXPECT_EQ("fe80:0000:0000:0000:0000:0000:23a1:b152", format(addr, {true, false, false, false}));
+  EXPECT_EQ("[fe80::23a1:b152]", format(addr, {false, true, false, false}));
+  EXPECT_EQ("52b1:a123::80fe", format(addr, {false, false, true, false}));
+  EXPECT_EQ("::", format(bro::net::proto::ip::v6::address("::")));
+}
+
+TEST(format, same_as_inet_ntop) {
+  std::mt19937_64 gen(7);
+  std::vector<std::string> samples{"::",          "::1",       "::2",         "1::",     "::ffff:1.2.3.4",
+                                   "::1.2.3.4",   "::ffff:0:1.2.3.4", "1:0:0:1:0:0:0:1", "0:0:1::",
+                                   "1:0:1:0:1:0:1:0", "::100",  "2001:db8::ff00:42:8329"};
+  for (int i = 0; i < 2000; ++i) {
+    uint8_t bytes[16];
+    for (auto &byte : bytes)
+      byte = (gen() % 3) ? 0 : static_cast<uint8_t>(gen());
+    char buffer[INET6_ADDRSTRLEN];
+    inet_ntop(AF_INET6, bytes, buffer, sizeof(buffer));
+    samples.emplace_back(buffer);
+  }
+  for (auto const &sample : samples) {
+    bro::net::proto::ip::v6::address addr(sample);
+    char buffer[INET6_ADDRSTRLEN];
+    auto native = addr.to_native();
+    inet_ntop(AF_INET6, &native, buffer, sizeof(buffer));
+    EXPECT_EQ(std::string(buffer), format(addr)) << sample;
+  }
+}
+
+TEST(format, full_address) {
+  full_address addr(address("fe80::1"), 8080);
+  EXPECT_EQ("fe80::1:8080", format(addr));
+  EXPECT_EQ("[fe80::1]:8080", format(addr, {false, true, false, false}));
+  EXPECT_EQ("10.0.0.1:0", format(full_address(address("10.0.0.1"), 0)));
+}
+
+TEST(format, to_chars) {
+  full_address const addr(address("ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff"), 65535);
+  std::string const expected = "[ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff]:65535";
+  format_spec const bracketed{false, true, false, false};
+  char buffer[bro::net::proto::ip::e_max_full_string];
+  for (size_t size = 0; size <= sizeof(buffer); ++size) {
+    auto const [end, ec] = bro::net::proto::ip::to_chars(buffer, buffer + size, addr, bracketed);
+    if (size < expected.size()) {
+      EXPECT_EQ(std::errc::value_too_large, ec);
+      EXPECT_EQ(buffer + size, end);
+    } else {
+      EXPECT_EQ(std::errc(), ec);
+      EXPECT_EQ(expected, std::string(buffer, end));
+    }
+  }
+  auto const res = bro::net::proto::ip::to_chars(buffer, buffer + 8, bro::net::proto::ip::v4::address("1.2.3.4"));
+  EXPECT_EQ(std::errc(), res.ec);
+  EXPECT_EQ("1.2.3.4", std::string(buffer, res.ptr));
+  EXPECT_EQ(std::errc::value_too_large, bro::net::proto::ip::to_chars(buffer, buffer + 6, address("fe80::1")).ec);
+}
+
+TEST(format, inline_string) {
+  using bro::net::proto::ip::to_inline_string;
+  std::mt19937_64 gen(3);
+  for (int i = 0; i < 1000; ++i) {
+    bro::net::proto::ip::v4::address const v4(static_cast<uint32_t>(gen()));
+    bro::net::proto::ip::v6::address const v6(gen() & 0xffff0000ffff00ffULL, gen() & 0xff00ffffffff0000ULL);
+    full_address const full(i % 2 ? address(v4) : address(v6), static_cast<uint16_t>(gen()));
+    EXPECT_EQ(v4.to_string(), to_inline_string(v4));
+    EXPECT_EQ(v6.to_string(), to_inline_string(v6));
+    EXPECT_EQ(address(v6).to_string(), to_inline_string(address(v6)));
+    EXPECT_EQ(full.to_string(), to_inline_string(full));
+    EXPECT_EQ(full.to_string(), to_inline_string(full).to_string());
+  }
+
+  // longest representations fit
+  auto const v4 = to_inline_string(bro::net::proto::ip::v4::address("255.255.255.255"));
+  static_assert(decltype(v4)::capacity() == 15);
+  EXPECT_EQ("255.255.255.255", v4);
+  auto const v6 = to_inline_string(address("::ffff:255.255.255.255"));
+  EXPECT_EQ("::ffff:255.255.255.255", v6);
+  EXPECT_EQ(v6.size(), strlen(v6.c_str()));
+  EXPECT_EQ("[fe80::1]:8080", to_inline_string(full_address(address("fe80::1"), 8080), {false, true, false, false}));
+  EXPECT_TRUE(to_inline_string(address()).empty());
+  EXPECT_EQ(":80", full_address(address(), 80).to_string());
+
+  std::ostringstream strm;
+  strm << to_inline_string(full_address(address("10.0.0.2"), 53));
+  EXPECT_EQ("10.0.0.2:53", strm.str());
+}
+
+TEST(format, ostream) {
+  std::ostringstream strm;
+  strm << address("10.0.0.1") << ' ' << bro::net::proto::ip::v6::address("fe80::1") << ' '
+       << full_address(address("10.0.0.2"), 53);
+  EXPECT_EQ("10.0.0.1 fe80::1 10.0.0.2:53", strm.str());
+}
+
+#ifdef WITH_FMT
+TEST(format, fmt) {
+  EXPECT_EQ("10.0.0.1", fmt::format("{}", address("10.0.0.1")));
+  EXPECT_EQ("010.000.000.001", fmt::format("{:z}", bro::net::proto::ip::v4::address("10.0.0.1")));
+  EXPECT_EQ("[fe80::1]:443", fmt::format("{:b}", full_address(address("fe80::1"), 443)));
+  EXPECT_EQ("fe80:0000:0000:0000:0000:0000:0000:0001",
+            fmt::format("{:e}", bro::net::proto::ip::v6::address("fe80::1")));
+  EXPECT_EQ("1.0.0.10", fmt::format("{:r}", address("10.0.0.1")));
+  EXPECT_THROW((void) fmt::format(fmt::runtime("{:x}"), address("10.0.0.1")), fmt::format_error);
+  EXPECT_THROW((void) fmt::format(fmt::runtime("{:bq}"), full_address(address("fe80::1"), 443)), fmt::format_error);
+}
+#endif // WITH_FMT
+
+#ifdef __cpp_lib_format
+TEST(format, std_format) {
+  address const addr("10.0.0.1");
+  EXPECT_EQ("1.0.0.10", std::vformat("{:r}", std::make_format_args(addr)));
+  EXPECT_THROW((void) std::vformat("{:x}", std::make_format_args(addr)), std::format_error);
+}
+#endif // __cpp_lib_format
+
+} // namespace bro::protocols::test
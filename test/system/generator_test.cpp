@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/generator.h>
+
+#include <set>
+#include <vector>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::prefix;
+namespace v4 = bro::net::proto::ip::v4;
+namespace v6 = bro::net::proto::ip::v6;
+
+TEST(generator, increment_decrement) {
+  using bro::net::proto::ip::decrement;
+  using bro::net::proto::ip::increment;
+  EXPECT_EQ(v4::address("10.0.1.0"), increment(v4::address("10.0.0.255")));
+  EXPECT_EQ(v4::address("0.0.0.0"), increment(v4::address("255.255.255.255")));
+  EXPECT_EQ(v4::address("10.0.0.254"), decrement(v4::address("10.0.1.0"), 2));
+  EXPECT_EQ(v6::address("2001:db8:0:1::"), increment(v6::address("2001:db8::ffff:ffff:ffff:ffff")));
+  EXPECT_EQ(v6::address("ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff"), decrement(v6::address("::")));
+}
+
+TEST(generator, address_view) {
+  std::vector<std::string> v4_addrs;
+  for (auto const &addr : bro::net::proto::ip::address_view<v4::address>(prefix("10.0.0.0/30")))
+    v4_addrs.push_back(addr.to_string());
+  EXPECT_EQ((std::vector<std::string>{"10.0.0.0", "10.0.0.1", "10.0.0.2", "10.0.0.3"}), v4_addrs);
+
+  size_t count = 0;
+  v6::address last;
+  bro::net::proto::ip::address_view<v6::address> const view(v6::address("::fffe"), v6::address("::1:1"));
+  for (auto it = view.begin(); it != view.end(); ++it, ++count)
+    last = *it;
+  EXPECT_EQ(4U, count);
+  EXPECT_EQ(v6::address("::1:1"), last);
+
+  // last address of space doesn't overflow
+  count = 0;
+  for (auto const &addr : bro::net::proto::ip::address_view<v4::address>(prefix("255.255.255.254/31"))) {
+    (void)addr;
+    ++count;
+  }
+  EXPECT_EQ(2U, count);
+
+  bro::net::proto::ip::address_view<v4::address> const empty(v4::address("10.0.0.2"), v4::address("10.0.0.1"));
+  EXPECT_TRUE(empty.begin() == empty.end());
+
+  // prefix of other family gives empty view
+  bro::net::proto::ip::address_view<v4::address> const v6_prefix(prefix("2001:db8::/126"));
+  EXPECT_TRUE(v6_prefix.begin() == v6_prefix.end());
+  bro::net::proto::ip::address_view<v6::address> const v4_prefix(prefix("10.0.0.0/30"));
+  EXPECT_TRUE(v4_prefix.begin() == v4_prefix.end());
+  bro::net::proto::ip::address_view<v4::address> const none{prefix()};
+  EXPECT_TRUE(none.begin() == none.end());
+}
+
+TEST(generator, random_generator) {
+  prefix const v4_prefix("192.168.0.0/20");
+  bro::net::proto::ip::random_generator gen(v4_prefix, 42);
+  std::vector<v4::address> addrs(4096);
+  EXPECT_TRUE(gen.generate(addrs.data(), addrs.size()));
+  std::set<v4::address> unique(addrs.begin(), addrs.end());
+  EXPECT_GT(unique.size(), 2500U);
+  for (auto const &addr : addrs)
+    EXPECT_TRUE(v4_prefix.contains(address(addr)));
+
+  // same seed gives same sequence, batches continue the stream
+  bro::net::proto::ip::random_generator same(v4_prefix, 42);
+  for (auto const &addr : addrs)
+    EXPECT_EQ(address(addr), same());
+  v6::address v6_addr;
+  EXPECT_FALSE(same.generate(&v6_addr, 1));
+
+  prefix const v6_prefix("2001:db8:aaaa::/48");
+  bro::net::proto::ip::random_generator v6_gen(v6_prefix, 1);
+  std::vector<address> v6_addrs(1024);
+  v6_gen.generate(v6_addrs.data(), v6_addrs.size());
+  for (auto const &addr : v6_addrs)
+    EXPECT_TRUE(v6_prefix.contains(addr));
+  EXPECT_EQ(v6_addrs.size(), std::set<address>(v6_addrs.begin(), v6_addrs.end()).size());
+}
+
+TEST(generator, permutation) {
+  prefix const v4_prefix("10.20.0.0/16");
+  bro::net::proto::ip::permutation const perm(v4_prefix, 7);
+  EXPECT_EQ(16, perm.get_host_bits());
+  std::set<address> seen;
+  size_t in_order = 0;
+  address prev;
+  for (auto const &addr : perm) {
+    EXPECT_TRUE(v4_prefix.contains(addr));
+    EXPECT_TRUE(seen.insert(addr).second) << addr.to_string();
+    if (prev.get_version() != address::version::e_none && bro::net::proto::ip::to_number(prev) + 1 ==
+                                                             bro::net::proto::ip::to_number(addr))
+      ++in_order;
+    prev = addr;
+  }
+  EXPECT_EQ(65536U, seen.size());
+  EXPECT_LT(in_order, 100U);
+
+  // different seed gives different order, random access matches iteration
+  bro::net::proto::ip::permutation const other(v4_prefix, 8);
+  EXPECT_NE(other[0], perm[0]);
+  EXPECT_EQ(perm[1000], *std::next(perm.begin(), 1000));
+
+  prefix const v6_prefix("2001:db8::/116");
+  std::set<address> v6_seen;
+  for (auto const &addr : bro::net::proto::ip::permutation(v6_prefix, 3)) {
+    EXPECT_TRUE(v6_prefix.contains(addr));
+    v6_seen.insert(addr);
+  }
+  EXPECT_EQ(4096U, v6_seen.size());
+
+  size_t count = 0;
+  for (auto const &addr : bro::net::proto::ip::permutation(prefix("10.0.0.1/32"))) {
+    EXPECT_EQ(address("10.0.0.1"), addr);
+    ++count;
+  }
+  EXPECT_EQ(1U, count);
+
+  bro::net::proto::ip::permutation const whole(prefix("::/0"), 5);
+  EXPECT_EQ(128, whole.get_host_bits());
+  EXPECT_NE(whole[1], whole[0]);
+}
+
+} // namespace bro::protocols::test
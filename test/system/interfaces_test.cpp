@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/full_address.h>
+#include <protocols/ip/interfaces.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+
+/**
+ * add or remove /128 address of loopback interface over netlink
+ *
+ * @return errno of kernel reply (0 if change is done)
+ */
+static int change_loopback_address(uint16_t type, address const &addr) {
+  struct {
+    nlmsghdr _header;
+    ifaddrmsg _message;
+    rtattr _attribute;
+    in6_addr _address;
+  } request{};
+  request._header.nlmsg_len = sizeof(request);
+  request._header.nlmsg_type = type;
+  request._header.nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK | (type == RTM_NEWADDR ? NLM_F_CREATE | NLM_F_EXCL : 0);
+  request._message.ifa_family = AF_INET6;
+  request._message.ifa_prefixlen = 128;
+  request._message.ifa_flags = IFA_F_NODAD;
+  request._message.ifa_index = if_nametoindex("lo");
+  request._attribute.rta_len = RTA_LENGTH(sizeof(in6_addr));
+  request._attribute.rta_type = IFA_LOCAL;
+  request._address = addr.to_native_v6();
+
+  int const fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+  if (fd < 0)
+    return errno;
+  int rc = EIO;
+  char reply[1024];
+  if (send(fd, &request, sizeof(request), 0) == ssize_t(sizeof(request)) &&
+      recv(fd, reply, sizeof(reply), 0) >= ssize_t(NLMSG_LENGTH(sizeof(nlmsgerr)))) {
+    auto const *header = reinterpret_cast<nlmsghdr const *>(reply);
+    if (header->nlmsg_type == NLMSG_ERROR)
+      rc = -reinterpret_cast<nlmsgerr const *>(NLMSG_DATA(header))->error;
+  }
+  close(fd);
+  return rc;
+}
+
+/**
+ * wait up to 2 seconds for condition
+ */
+template <typename Condition> static bool wait_for(Condition condition) {
+  for (int i = 0; i < 200; ++i) {
+    if (condition())
+      return true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return condition();
+}
+
+TEST(interfaces, table) {
+  std::vector<bro::net::proto::ip::interface> interfaces(2);
+  interfaces[0]._index = 1;
+  interfaces[0]._name = "lo";
+  interfaces[0]._addresses.push_back({address("127.0.0.1"), 8, 0, 1});
+  interfaces[1]._index = 2;
+  interfaces[1]._name = "eth0";
+  interfaces[1]._addresses.push_back({address("fe80::1"), 64, 2, 2});
+
+  bro::net::proto::ip::interface_table table(std::move(interfaces));
+  ASSERT_NE(nullptr, table.find(2));
+  EXPECT_EQ("eth0", table.find(2)->_name);
+  EXPECT_EQ(nullptr, table.find(3));
+  ASSERT_NE(nullptr, table.find(address("fe80::1")));
+  EXPECT_EQ(2u, table.find(address("fe80::1"))->_scope_id);
+  EXPECT_EQ(8u, table.find(address("127.0.0.1"))->_prefix_length);
+  EXPECT_EQ(nullptr, table.find(address("fe80::2")));
+}
+
+TEST(interfaces, load) {
+  auto table = bro::net::proto::ip::interface_table::load();
+  auto const *loopback = table->find(address("127.0.0.1"));
+  if (!loopback)
+    GTEST_SKIP() << "no loopback address";
+  EXPECT_EQ(8u, loopback->_prefix_length);
+  ASSERT_NE(nullptr, table->find(loopback->_index));
+  EXPECT_EQ(loopback->_index, table->find(loopback->_index)->_index);
+}
+
+TEST(interfaces, rcu_ptr) {
+  bro::net::proto::ip::rcu_ptr<int> value(std::make_unique<int const>(0));
+  std::atomic_bool stop{false};
+  std::atomic<int> last_seen{0};
+  std::thread reader([&] {
+    while (!stop) {
+      auto guard = value.read();
+      EXPECT_GE(*guard, last_seen.load());
+      last_seen = *guard;
+    }
+  });
+  for (int i = 1; i <= 1000; ++i)
+    value.update(std::make_unique<int const>(i));
+  stop = true;
+  reader.join();
+  EXPECT_EQ(1000, *value.read());
+}
+
+TEST(interfaces, monitor) {
+  bro::net::proto::ip::interface_monitor monitor;
+  EXPECT_TRUE(monitor.start());
+  {
+    auto table = monitor.get();
+    ASSERT_TRUE(table);
+  }
+  monitor.refresh();
+  monitor.stop();
+  EXPECT_TRUE(monitor.get());
+}
+
+TEST(interfaces, scope_id) {
+  auto const table = bro::net::proto::ip::interface_table::load();
+  auto const *loopback = table->find(address("::1"));
+  if (!loopback)
+    GTEST_SKIP() << "no ipv6 loopback address";
+  uint32_t scope_id = 1;
+  EXPECT_TRUE(bro::net::proto::ip::lookup_scope_id(address("::1"), scope_id));
+  EXPECT_EQ(loopback->_scope_id, scope_id);
+  EXPECT_FALSE(bro::net::proto::ip::lookup_scope_id(address("2001:db8::dead"), scope_id));
+  EXPECT_EQ(0u, scope_id);
+
+  bro::net::proto::ip::full_address const endpoint(address("::1"), 80);
+  EXPECT_EQ(loopback->_scope_id, endpoint.to_native_v6().sin6_scope_id);
+}
+
+TEST(interfaces, monitor_events) {
+  address const test_address("2001:db8:5c09::1");
+  bro::net::proto::ip::interface_monitor monitor;
+  ASSERT_TRUE(monitor.start());
+  ASSERT_EQ(nullptr, monitor.get()->find(test_address));
+  int const rc = change_loopback_address(RTM_NEWADDR, test_address);
+  if (rc == EPERM || rc == EACCES)
+    GTEST_SKIP() << "changing addresses is not permitted";
+  ASSERT_EQ(0, rc) << strerror(rc);
+
+  // snapshots of monitor and lookup_scope_id() follow netlink notifications
+  uint32_t scope_id = 0;
+  EXPECT_TRUE(wait_for([&] { return monitor.get()->find(test_address) != nullptr; }));
+  EXPECT_TRUE(bro::net::proto::ip::lookup_scope_id(test_address, scope_id));
+  ASSERT_EQ(0, change_loopback_address(RTM_DELADDR, test_address));
+  EXPECT_TRUE(wait_for([&] { return monitor.get()->find(test_address) == nullptr; }));
+  EXPECT_FALSE(bro::net::proto::ip::lookup_scope_id(test_address, scope_id));
+}
+
+} // namespace bro::protocols::test
@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/packet_ring.h>
+
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstring>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::flow_keys;
+using bro::net::proto::ip::packet;
+using bro::net::proto::ip::packet_ring;
+using bro::net::proto::ip::packet_status;
+
+/**
+ * \brief udp socket bound to loopback
+ */
+class udp_socket {
+public:
+  udp_socket() {
+    _fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t size = sizeof(addr);
+    bind(_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+    getsockname(_fd, reinterpret_cast<sockaddr *>(&addr), &size);
+    _port = ntohs(addr.sin_port);
+  }
+
+  ~udp_socket() {
+    ::close(_fd);
+  }
+
+  void send_to(uint16_t port, char const *data) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    sendto(_fd, data, strlen(data), 0, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+  }
+
+  uint16_t get_port() const noexcept {
+    return _port;
+  }
+
+private:
+  int _fd = -1;
+  uint16_t _port = 0;
+};
+
+TEST(packet_ring, loopback) {
+  packet_ring ring;
+  packet_ring::config conf;
+  conf._block_size = 1 << 16;
+  conf._block_count = 8;
+  conf._block_timeout_ms = 1;
+  if (!ring.open("lo", conf))
+    GTEST_SKIP() << "packet socket is not permitted: " << strerror(errno);
+  EXPECT_TRUE(ring.is_open());
+
+  udp_socket sender, receiver;
+  sender.send_to(receiver.get_port(), "packet ring test");
+
+  flow_keys keys(4);
+  std::vector<packet> frames(keys.capacity());
+  bool found = false;
+  auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!found && std::chrono::steady_clock::now() < deadline) {
+    size_t const size = ring.read(frames.data(), keys, 100);
+    for (size_t i = 0; i < size; ++i) {
+      if (keys._statuses[i] != packet_status::e_ok || keys._protocols[i] != 17 ||
+          keys._destination_ports[i] != receiver.get_port())
+        continue;
+      EXPECT_EQ(address("127.0.0.1"), keys.get_source(i).get_address());
+      EXPECT_EQ(sender.get_port(), keys.get_source(i).get_port());
+      EXPECT_EQ(address("127.0.0.1"), keys.get_destination(i).get_address());
+      std::string_view const payload(reinterpret_cast<char const *>(frames[i]._data) + keys._l4_offsets[i] + 8,
+                                     frames[i]._size - keys._l4_offsets[i] - 8);
+      EXPECT_EQ("packet ring test", payload);
+      found = true;
+    }
+  }
+  EXPECT_TRUE(found);
+
+  packet_ring::statistics stats;
+  EXPECT_TRUE(ring.get_statistics(stats));
+  EXPECT_GE(stats._packets, 1U);
+
+  ring.close();
+  EXPECT_FALSE(ring.is_open());
+  EXPECT_EQ(0U, ring.read(frames.data(), keys, 0));
+}
+
+TEST(packet_ring, invalid_interface) {
+  packet_ring ring;
+  EXPECT_FALSE(ring.open("no_such_interface"));
+  EXPECT_FALSE(ring.is_open());
+}
+
+} // namespace bro::protocols::test
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/prefix.h>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::prefix;
+
+TEST(prefix, ctor) {
+  prefix pref(address("192.168.1.17"), 16);
+  EXPECT_EQ("192.168.0.0/16", pref.to_string());
+  EXPECT_TRUE(pref.contains(address("192.168.200.1")));
+  EXPECT_FALSE(pref.contains(address("192.169.0.1")));
+  EXPECT_FALSE(pref.contains(address("fe80::1")));
+
+  prefix pref6("fe80::23a1:b152/10");
+  EXPECT_EQ("fe80::/10", pref6.to_string());
+  EXPECT_TRUE(pref6.contains(prefix("fe80::/64")));
+  EXPECT_FALSE(prefix("fe80::/64").contains(pref6));
+
+  prefix bad;
+  EXPECT_FALSE(bro::net::proto::ip::string_to_prefix("10.0.0.0/33", bad));
+  EXPECT_FALSE(bro::net::proto::ip::string_to_prefix("10.0.0.0", bad));
+}
+
+TEST(prefix, make_mask) {
+  EXPECT_EQ("255.255.240.0", address_to_string(make_mask(address::version::e_v4, 20)));
+  EXPECT_EQ("ffff:ffff:ffff:ff80::", address_to_string(make_mask(address::version::e_v6, 57)));
+  EXPECT_EQ("0.0.0.0", address_to_string(make_mask(address::version::e_v4, 0)));
+}
+
+} // namespace bro::protocols::test
@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/proxy_protocol.h>
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::full_address;
+namespace proxy = bro::net::proto::ip::proxy;
+
+static proxy::status parse(std::string const &str, proxy::header &hdr) {
+  return proxy::parse(reinterpret_cast<uint8_t const *>(str.data()), str.size(), hdr);
+}
+
+TEST(proxy_protocol, v1_parse) {
+  proxy::header hdr;
+  std::string const tcp4 = "PROXY TCP4 192.168.0.1 192.168.0.11 56324 443\r\nGET / HTTP/1.1\r\n";
+  EXPECT_EQ(proxy::status::e_ok, parse(tcp4, hdr));
+  EXPECT_EQ(1, hdr._version);
+  EXPECT_EQ(proxy::command::e_proxy, hdr._command);
+  EXPECT_EQ(proxy::transport::e_stream, hdr._transport);
+  EXPECT_EQ(full_address(address("192.168.0.1"), 56324), hdr._source);
+  EXPECT_EQ(full_address(address("192.168.0.11"), 443), hdr._destination);
+  EXPECT_EQ("GET / HTTP/1.1\r\n", tcp4.substr(hdr._size));
+
+  EXPECT_EQ(proxy::status::e_ok, parse("PROXY TCP6 2001:db8::1 ::1 1 65535\r\n", hdr));
+  EXPECT_EQ(full_address(address("2001:db8::1"), 1), hdr._source);
+  EXPECT_EQ(full_address(address("::1"), 65535), hdr._destination);
+
+  EXPECT_EQ(proxy::status::e_ok, parse("PROXY UNKNOWN ffff:f...f:ffff ffff:f...f:ffff 65535 65535\r\n", hdr));
+  EXPECT_EQ(proxy::transport::e_unspec, hdr._transport);
+  EXPECT_EQ(address::version::e_none, hdr._source.get_address().get_version());
+
+  for (char const *invalid : {"PROXY TCP4 192.168.0.1 192.168.0.11 56324\r\n",
+                              "PROXY TCP4 192.168.0.1 192.168.0.11 56324 443 1\r\n",
+                              "PROXY TCP4 ::1 ::1 1 1\r\n", "PROXY TCP6 1.2.3.4 1.2.3.4 1 1\r\n",
+                              "PROXY TCP4 1.2.3.4 1.2.3.4 1 65536\r\n", "PROXY TCP4  1.2.3.4 1.2.3.4 1 1\r\n",
+                              "PROXY TCP4 1.2.3.4 1.2.3.4 1 1\n", "PROXY UDP4 1.2.3.4 1.2.3.4 1 1\r\n",
+                              "PROXZ", "GET / HTTP/1.1\r\n"})
+    EXPECT_EQ(proxy::status::e_invalid, parse(invalid, hdr)) << invalid;
+
+  EXPECT_EQ(proxy::status::e_incomplete, parse("PRO", hdr));
+  EXPECT_EQ(proxy::status::e_incomplete, parse("PROXY TCP4 192.168.0.1", hdr));
+  EXPECT_EQ(proxy::status::e_invalid, parse("PROXY UNKNOWN " + std::string(200, 'x'), hdr));
+}
+
+TEST(proxy_protocol, v2_parse) {
+  // PROXY TCP4 127.0.0.1:4000 -> 127.0.0.2:80 with ALPN "h2" and NOOP
+  uint8_t const data[] = {0x0d, 0x0a, 0x0d, 0x0a, 0x00, 0x0d, 0x0a, 0x51, 0x55, 0x49, 0x54, 0x0a, 0x21, 0x11,
+                          0x00, 0x15, 0x7f, 0x00, 0x00, 0x01, 0x7f, 0x00, 0x00, 0x02, 0x0f, 0xa0, 0x00, 0x50,
+                          0x01, 0x00, 0x02, 'h',  '2',  0x04, 0x00, 0x01, 0x00, 0xaa};
+  proxy::header hdr;
+  EXPECT_EQ(proxy::status::e_ok, proxy::parse(data, sizeof(data), hdr));
+  EXPECT_EQ(2, hdr._version);
+  EXPECT_EQ(proxy::command::e_proxy, hdr._command);
+  EXPECT_EQ(proxy::transport::e_stream, hdr._transport);
+  EXPECT_EQ(full_address(address("127.0.0.1"), 4000), hdr._source);
+  EXPECT_EQ(full_address(address("127.0.0.2"), 80), hdr._destination);
+  EXPECT_EQ(sizeof(data) - 1, hdr._size);
+
+  proxy::tlv value;
+  ASSERT_TRUE(proxy::find_tlv(hdr, proxy::e_alpn, value));
+  EXPECT_EQ("h2", std::string(reinterpret_cast<char const *>(value._value), value._length));
+  ASSERT_TRUE(proxy::find_tlv(hdr, proxy::e_noop, value));
+  EXPECT_EQ(1, value._length);
+  EXPECT_FALSE(proxy::find_tlv(hdr, proxy::e_authority, value));
+
+  for (size_t size = 0; size < hdr._size; ++size)
+    EXPECT_EQ(proxy::status::e_incomplete, proxy::parse(data, size, hdr)) << size;
+
+  // tlv length runs past the header
+  std::vector<uint8_t> broken(data, data + sizeof(data));
+  broken[35] = 0x02;
+  EXPECT_EQ(proxy::status::e_invalid, proxy::parse(broken.data(), broken.size(), hdr));
+  // version 1 in binary header
+  broken.assign(data, data + sizeof(data));
+  broken[12] = 0x11;
+  EXPECT_EQ(proxy::status::e_invalid, proxy::parse(broken.data(), broken.size(), hdr));
+}
+
+TEST(proxy_protocol, round_trip) {
+  proxy::header hdr;
+  hdr._source = full_address(address("2001:db8::1"), 12345);
+  hdr._destination = full_address(address("2001:db8::2"), 443);
+
+  uint8_t buffer[256];
+  size_t size = proxy::serialize_v1(hdr, buffer, sizeof(buffer));
+  EXPECT_EQ("PROXY TCP6 2001:db8::1 2001:db8::2 12345 443\r\n",
+            std::string(reinterpret_cast<char const *>(buffer), size));
+  EXPECT_EQ(0U, proxy::serialize_v1(hdr, buffer, size - 1));
+  EXPECT_EQ(size, proxy::serialize_v1(hdr, buffer, size));
+
+  std::string const authority = "example.com";
+  proxy::tlv const tlvs[] = {{proxy::e_authority, static_cast<uint16_t>(authority.size()),
+                              reinterpret_cast<uint8_t const *>(authority.data())},
+                             {proxy::e_noop, 0, nullptr}};
+  size = proxy::serialize_v2(hdr, tlvs, 2, buffer, sizeof(buffer));
+  EXPECT_EQ(proxy::e_v2_header_size + 36 + 3 + authority.size() + 3, size);
+  EXPECT_EQ(0U, proxy::serialize_v2(hdr, tlvs, 2, buffer, size - 1));
+
+  proxy::header parsed;
+  EXPECT_EQ(proxy::status::e_ok, proxy::parse(buffer, size, parsed));
+  EXPECT_EQ(size, parsed._size);
+  EXPECT_EQ(hdr._source, parsed._source);
+  EXPECT_EQ(hdr._destination, parsed._destination);
+  proxy::tlv value;
+  ASSERT_TRUE(proxy::find_tlv(parsed, proxy::e_authority, value));
+  EXPECT_EQ(authority, std::string(reinterpret_cast<char const *>(value._value), value._length));
+
+  hdr._command = proxy::command::e_local;
+  size = proxy::serialize_v2(hdr, nullptr, 0, buffer, sizeof(buffer));
+  EXPECT_EQ(size_t(proxy::e_v2_header_size), size);
+  EXPECT_EQ(proxy::status::e_ok, proxy::parse(buffer, size, parsed));
+  EXPECT_EQ(proxy::command::e_local, parsed._command);
+  EXPECT_EQ(address::version::e_none, parsed._source.get_address().get_version());
+}
+
+TEST(proxy_protocol, mutations) {
+  proxy::header hdr;
+  hdr._source = full_address(address("10.1.2.3"), 1000);
+  hdr._destination = full_address(address("10.3.2.1"), 2000);
+  uint8_t const payload[] = {1, 2, 3, 4, 5};
+  proxy::tlv const tlvs[] = {{proxy::e_unique_id, sizeof(payload), payload}};
+
+  std::vector<std::vector<uint8_t>> seeds(2, std::vector<uint8_t>(256));
+  seeds[0].resize(proxy::serialize_v1(hdr, seeds[0].data(), seeds[0].size()));
+  seeds[1].resize(proxy::serialize_v2(hdr, tlvs, 1, seeds[1].data(), seeds[1].size()));
+
+  std::mt19937 gen(5);
+  for (size_t i = 0; i < 100000; ++i) {
+    auto data = seeds[i % seeds.size()];
+    for (size_t flips = gen() % 4 + 1; flips; --flips)
+      data[gen() % data.size()] = static_cast<uint8_t>(gen());
+    data.resize(gen() % (data.size() + 1));
+    proxy::header parsed;
+    if (data.empty()) {
+      EXPECT_EQ(proxy::status::e_incomplete, proxy::parse(nullptr, 0, parsed));
+      continue;
+    }
+    // parse must stay within buffer, copy it to exact size heap block for sanitizer
+    std::unique_ptr<uint8_t[]> exact(new uint8_t[data.size()]);
+    memcpy(exact.get(), data.data(), data.size());
+    if (proxy::parse(exact.get(), data.size(), parsed) == proxy::status::e_ok) {
+      ASSERT_LE(parsed._size, data.size());
+      proxy::tlv value;
+      for (size_t offset = 0; proxy::next_tlv(parsed, offset, value);)
+        ASSERT_LE(value._value + value._length, parsed._tlvs + parsed._tlvs_size);
+    }
+  }
+}
+
+} // namespace bro::protocols::test
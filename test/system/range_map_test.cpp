@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/range_map.h>
+
+#include <random>
+#include <string>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::address_range;
+using bro::net::proto::ip::range_entry;
+using bro::net::proto::ip::range_map;
+using bro::net::proto::ip::range_policy;
+
+using entries = std::vector<range_entry<std::string>>;
+
+TEST(range_map, lookup) {
+  range_map<std::string> const map(entries{{address("10.0.0.5"), address("10.0.1.17"), "a"},
+                                           {address("2001:db8::"), address("2001:db8::ffff"), "b"},
+                                           {address("192.168.0.1"), address("192.168.0.1"), "c"},
+                                           {address("0.0.0.0"), address("0.0.0.0"), "zero"},
+                                           {address("255.255.255.0"), address("255.255.255.255"), "max"},
+                                           {address("ffff::"), address("ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff"),
+                                            "max6"}});
+  EXPECT_EQ(6U, map.size());
+  EXPECT_FALSE(map.empty());
+
+  auto const find = [&map](char const *addr) {
+    auto const *value = map.find(address(addr));
+    return value ? *value : std::string("-");
+  };
+  EXPECT_EQ("-", find("10.0.0.4"));
+  EXPECT_EQ("a", find("10.0.0.5"));
+  EXPECT_EQ("a", find("10.0.0.255"));
+  EXPECT_EQ("a", find("10.0.1.17"));
+  EXPECT_EQ("-", find("10.0.1.18"));
+  EXPECT_EQ("c", find("192.168.0.1"));
+  EXPECT_EQ("-", find("192.168.0.2"));
+  EXPECT_EQ("zero", find("0.0.0.0"));
+  EXPECT_EQ("max", find("255.255.255.255"));
+  EXPECT_EQ("b", find("2001:db8::1"));
+  EXPECT_EQ("-", find("2001:db8::1:0"));
+  EXPECT_EQ("max6", find("ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff"));
+  // versions don't mix
+  EXPECT_EQ("-", find("::a00:5"));
+  EXPECT_EQ(nullptr, map.find(address()));
+
+  address_range range;
+  EXPECT_NE(nullptr, map.find(address("10.0.0.100"), range));
+  EXPECT_EQ(address_range(address("10.0.0.5"), address("10.0.1.17")), range);
+}
+
+TEST(range_map, policy) {
+  entries const input{{address("10.0.0.0"), address("10.0.0.255"), "wide"},
+                      {address("10.0.0.10"), address("10.0.0.19"), "narrow"},
+                      {address("10.0.0.15"), address("10.0.1.9"), "late"}};
+
+  range_map<std::string> const first(input, range_policy::e_first);
+  EXPECT_EQ(2U, first.size());
+  EXPECT_EQ("wide", *first.find(address("10.0.0.15")));
+  EXPECT_EQ("late", *first.find(address("10.0.1.0")));
+
+  range_map<std::string> const last(input, range_policy::e_last);
+  auto const last_entries = last.get_entries();
+  ASSERT_EQ(3U, last_entries.size());
+  EXPECT_EQ(address("10.0.0.9"), last_entries[0]._last);
+  EXPECT_EQ("narrow", last_entries[1]._value);
+  EXPECT_EQ(address("10.0.0.14"), last_entries[1]._last);
+  EXPECT_EQ("late", last_entries[2]._value);
+  EXPECT_EQ(address("10.0.1.9"), last_entries[2]._last);
+
+  range_map<std::string> const narrowest(input, range_policy::e_narrowest);
+  EXPECT_EQ("wide", *narrowest.find(address("10.0.0.5")));
+  EXPECT_EQ("narrow", *narrowest.find(address("10.0.0.19")));
+  EXPECT_EQ("late", *narrowest.find(address("10.0.0.20")));
+  EXPECT_EQ("wide", *narrowest.find(address("10.0.0.9")));
+  EXPECT_EQ("late", *narrowest.find(address("10.0.1.0")));
+}
+
+TEST(range_map, merge) {
+  // adjacent and overlapping ranges with equal values become one range
+  range_map<int> const map({{address("10.0.0.0"), address("10.0.0.9"), 1},
+                            {address("10.0.0.10"), address("10.0.0.19"), 1},
+                            {address("10.0.0.5"), address("10.0.0.30"), 1},
+                            {address("10.0.0.32"), address("10.0.0.40"), 1},
+                            {address("10.0.0.41"), address("10.0.0.50"), 2}});
+  auto const res = map.get_entries();
+  ASSERT_EQ(3U, res.size());
+  EXPECT_EQ(address("10.0.0.0"), res[0]._first);
+  EXPECT_EQ(address("10.0.0.30"), res[0]._last);
+  EXPECT_EQ(address("10.0.0.32"), res[1]._first);
+  EXPECT_EQ(2, res[2]._value);
+}
+
+TEST(range_map, invalid) {
+  range_map<int> const map({{address("10.0.0.9"), address("10.0.0.0"), 1},
+                            {address("10.0.0.0"), address("::1"), 2},
+                            {address(), address(), 3}});
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(nullptr, map.find(address("10.0.0.5")));
+  EXPECT_TRUE(range_map<int>().empty());
+}
+
+TEST(range_map, random) {
+  // compare with linear scan over small key space
+  std::mt19937 gen(1);
+  for (auto policy : {range_policy::e_first, range_policy::e_last, range_policy::e_narrowest}) {
+    std::vector<range_entry<int>> input;
+    for (int i = 0; i < 300; ++i) {
+      uint32_t first = gen() % 4096, last = gen() % 4096;
+      if (first > last)
+        std::swap(first, last);
+      last = std::min(last, first + static_cast<uint32_t>(gen() % 64));
+      bool const v6 = gen() % 2;
+      auto const make = [v6](uint32_t value) {
+        return v6 ? address(bro::net::proto::ip::to_v6_address(value))
+                  : address(bro::net::proto::ip::to_v4_address(value));
+      };
+      input.push_back({make(first), make(last), static_cast<int>(gen() % 4)});
+    }
+    range_map<int> const map(input, policy);
+
+    for (uint32_t key = 0; key < 4096 + 64; ++key) {
+      for (bool v6 : {false, true}) {
+        address const addr =
+          v6 ? address(bro::net::proto::ip::to_v6_address(key)) : address(bro::net::proto::ip::to_v4_address(key));
+        auto const number = [](address const &value) { return bro::net::proto::ip::to_number(value); };
+        auto const size = [&number](range_entry<int> const &range) {
+          return number(range._last) - number(range._first);
+        };
+        int const *expected = nullptr;
+        size_t expected_size = 0;
+        for (auto const &entry : input) {
+          if (entry._first.is_ipv6() != v6 || number(addr) < number(entry._first) || number(entry._last) < number(addr))
+            continue;
+          if (!expected || policy == range_policy::e_last ||
+              (policy == range_policy::e_narrowest && size(entry) <= expected_size)) {
+            expected = &entry._value;
+            expected_size = size(entry);
+          }
+        }
+        int const *value = map.find(addr);
+        ASSERT_EQ(expected == nullptr, value == nullptr) << addr.to_string();
+        if (value) {
+          EXPECT_EQ(*expected, *value) << addr.to_string();
+        }
+      }
+    }
+  }
+}
+
+} // namespace bro::protocols::test
@@ -0,0 +1,398 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/resolver.h>
+
+#include <arpa/inet.h>
+#include <map>
+#include <thread>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#ifdef __cpp_impl_coroutine
+#include <coroutine>
+#endif
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::full_address;
+using bro::net::proto::ip::hosts_table;
+using bro::net::proto::ip::make_endpoints;
+using bro::net::proto::ip::parse_resolv_conf;
+using bro::net::proto::ip::resolve_error;
+using bro::net::proto::ip::resolve_result;
+using bro::net::proto::ip::resolver;
+
+/**
+ * \brief dns server answering on loopback
+ */
+class stub_server {
+public:
+  struct record {
+    std::vector<address> _addresses;
+    uint32_t _ttl = 60;
+    uint8_t _rcode = 0;
+    bool _truncated = false;
+  };
+
+  stub_server() {
+    _fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t size = sizeof(addr);
+    bind(_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+    getsockname(_fd, reinterpret_cast<sockaddr *>(&addr), &size);
+    _port = ntohs(addr.sin_port);
+  }
+
+  ~stub_server() {
+    ::close(_fd);
+  }
+
+  full_address get_endpoint() const {
+    return full_address(address("127.0.0.1"), _port);
+  }
+
+  /**
+   * answer received queries (wait for the first one)
+   *
+   * @param answer false to drop queries
+   * @return number of received queries
+   */
+  size_t serve(bool answer = true) {
+    size_t count = 0;
+    pollfd pfd{};
+    pfd.fd = _fd;
+    pfd.events = POLLIN;
+    while (poll(&pfd, 1, count ? 50 : 1000) > 0) {
+      uint8_t query[512];
+      sockaddr_in from{};
+      socklen_t from_size = sizeof(from);
+      ssize_t const size = recvfrom(_fd, query, sizeof(query), 0, reinterpret_cast<sockaddr *>(&from), &from_size);
+      if (size <= 12)
+        break;
+      ++count;
+      if (answer)
+        reply(query, static_cast<size_t>(size), from);
+    }
+    return count;
+  }
+
+  std::map<std::string, record> _records;
+
+private:
+  void reply(uint8_t const *query, size_t size, sockaddr_in const &to) {
+    std::string name;
+    size_t offset = 12;
+    while (offset < size && query[offset]) {
+      if (!name.empty())
+        name += '.';
+      name.append(reinterpret_cast<char const *>(query + offset + 1), query[offset]);
+      offset += 1 + query[offset];
+    }
+    uint16_t const type = static_cast<uint16_t>((query[offset + 1] << 8) | query[offset + 2]);
+    offset += 5;
+
+    std::vector<uint8_t> out(query, query + offset);
+    out[2] = 0x81;
+    out[3] = 0x80;
+    auto const it = _records.find(name);
+    if (it != _records.end() && it->second._truncated)
+      out[2] |= 0x02;
+    if (it == _records.end()) {
+      out[3] |= 3;
+    } else if (it->second._rcode) {
+      out[3] |= it->second._rcode;
+    } else {
+      uint16_t count = 0;
+      for (auto const &addr : it->second._addresses) {
+        bool const v4 = addr.get_version() == address::version::e_v4;
+        if (v4 != (type == 1))
+          continue;
+        uint8_t const header[] = {0xc0,
+                                  0x0c,
+                                  0,
+                                  static_cast<uint8_t>(type),
+                                  0,
+                                  1,
+                                  static_cast<uint8_t>(it->second._ttl >> 24),
+                                  static_cast<uint8_t>(it->second._ttl >> 16),
+                                  static_cast<uint8_t>(it->second._ttl >> 8),
+                                  static_cast<uint8_t>(it->second._ttl),
+                                  0,
+                                  static_cast<uint8_t>(v4 ? 4 : 16)};
+        out.insert(out.end(), header, header + sizeof(header));
+        if (v4) {
+          auto const bytes = addr.to_v4().get_data();
+          auto const *data = reinterpret_cast<uint8_t const *>(&bytes);
+          out.insert(out.end(), data, data + 4);
+        } else {
+          auto const v6 = addr.to_v6();
+          out.insert(out.end(), v6.get_data(), v6.get_data() + 16);
+        }
+        ++count;
+      }
+      out[7] = static_cast<uint8_t>(count);
+    }
+    sendto(_fd, out.data(), out.size(), 0, reinterpret_cast<sockaddr const *>(&to), sizeof(to));
+  }
+
+  int _fd = -1;
+  uint16_t _port = 0;
+};
+
+resolver::config make_config(stub_server const &server) {
+  resolver::config conf;
+  conf._servers.push_back(server.get_endpoint());
+  conf._hosts_path.clear();
+  conf._timeout = std::chrono::milliseconds(100);
+  conf._attempts = 1;
+  return conf;
+}
+
+TEST(resolver, hosts) {
+  hosts_table hosts;
+  hosts.parse("# comment\n"
+              "127.0.0.1\tlocalhost Localhost.localdomain.\n"
+              "::1 localhost ip6-localhost # loopback\r\n"
+              "bad.address name\n"
+              "\n"
+              "10.0.0.1 LOCALHOST");
+  EXPECT_EQ(3U, hosts.size());
+  EXPECT_EQ(nullptr, hosts.find("bad.address"));
+  EXPECT_EQ(nullptr, hosts.find("name"));
+
+  auto const *addrs = hosts.find("localhost.");
+  ASSERT_NE(nullptr, addrs);
+  EXPECT_EQ((std::vector<address>{address("127.0.0.1"), address("::1"), address("10.0.0.1")}), *addrs);
+  addrs = hosts.find("LOCALHOST.localdomain");
+  ASSERT_NE(nullptr, addrs);
+  EXPECT_EQ(std::vector<address>{address("127.0.0.1")}, *addrs);
+}
+
+TEST(resolver, resolv_conf) {
+  std::vector<full_address> servers;
+  parse_resolv_conf("# generated\n"
+                    "nameserver 10.0.0.1\n"
+                    "nameserver\t2001:db8::1 # comment\n"
+                    "nameservers 10.0.0.2\n"
+                    "nameserver fe80::1%1\n"
+                    "nameserver bad\n"
+                    "search example.com\n",
+                    servers);
+  ASSERT_EQ(3U, servers.size());
+  EXPECT_EQ(full_address(address("10.0.0.1"), 53), servers[0]);
+  EXPECT_EQ(full_address(address("2001:db8::1"), 53), servers[1]);
+  EXPECT_EQ(address("fe80::1"), servers[2].get_address());
+  EXPECT_EQ(53, servers[2].get_port());
+  EXPECT_EQ(1U, servers[2].get_scope_id().value_or(0));
+
+  auto const endpoints = make_endpoints({address("10.0.0.1"), address("::1")}, 80);
+  EXPECT_EQ((std::vector<full_address>{full_address(address("10.0.0.1"), 80), full_address(address("::1"), 80)}),
+            endpoints);
+}
+
+TEST(resolver, immediate) {
+  stub_server server;
+  resolver res;
+  EXPECT_TRUE(res.open(make_config(server)));
+  res.get_hosts().parse("192.168.0.1 router");
+
+  std::vector<resolve_result> results;
+  auto const cb = [&](resolve_result const &result) { results.push_back(result); };
+  res.resolve("10.1.2.3", cb);
+  res.resolve("2001:db8::5", cb);
+  res.resolve("Router.", cb);
+  res.resolve("bad..name", cb);
+  res.resolve("bad name", cb);
+  res.resolve(std::string(64, 'a') + ".com", cb);
+  EXPECT_EQ(0U, res.get_pending());
+  ASSERT_EQ(6U, results.size());
+  EXPECT_EQ(std::vector<address>{address("10.1.2.3")}, results[0]._addresses);
+  EXPECT_EQ(std::vector<address>{address("2001:db8::5")}, results[1]._addresses);
+  EXPECT_EQ(std::vector<address>{address("192.168.0.1")}, results[2]._addresses);
+  for (size_t i = 3; i < results.size(); ++i) {
+    EXPECT_FALSE(results[i]);
+    EXPECT_EQ(resolve_error::e_invalid_name, results[i]._error);
+  }
+}
+
+TEST(resolver, query) {
+  stub_server server;
+  server._records["www.example.com"] = {{address("2001:db8::1"), address("192.0.2.1"), address("192.0.2.2")}, 60, 0};
+  server._records["nottl.example.com"] = {{address("192.0.2.3")}, 0, 0};
+  server._records["fail.example.com"] = {{}, 0, 2};
+
+  resolver res;
+  EXPECT_TRUE(res.open(make_config(server)));
+  EXPECT_EQ(-1, res.get_timeout_ms());
+
+  std::vector<resolve_result> results;
+  auto const cb = [&](resolve_result const &result) { results.push_back(result); };
+  // lookups of the same name are merged
+  res.resolve("WWW.example.com", cb);
+  res.resolve("www.example.com.", cb);
+  EXPECT_EQ(1U, res.get_pending());
+  EXPECT_GE(res.get_timeout_ms(), 0);
+  EXPECT_EQ(2U, server.serve());
+  EXPECT_EQ(1U, res.run_once(1000));
+  EXPECT_EQ(0U, res.get_pending());
+  EXPECT_EQ(2U, results.size());
+  std::vector<address> const expected{address("192.0.2.1"), address("192.0.2.2"), address("2001:db8::1")};
+  for (auto const &result : results) {
+    EXPECT_TRUE(result);
+    EXPECT_EQ(expected, result._addresses);
+  }
+
+  // cached
+  res.resolve("www.example.com", cb);
+  ASSERT_EQ(3U, results.size());
+  EXPECT_EQ(expected, results.back()._addresses);
+  EXPECT_EQ(0U, res.get_pending());
+
+  // zero ttl isn't cached
+  for (size_t i = 0; i < 2; ++i) {
+    res.resolve("nottl.example.com", cb);
+    EXPECT_EQ(2U, server.serve());
+    ASSERT_EQ(1U, res.run_once(1000));
+    EXPECT_EQ(std::vector<address>{address("192.0.2.3")}, results.back()._addresses);
+  }
+
+  res.resolve("missing.example.com", cb);
+  EXPECT_EQ(2U, server.serve());
+  ASSERT_EQ(1U, res.run_once(1000));
+  EXPECT_EQ(resolve_error::e_not_found, results.back()._error);
+
+  res.resolve("fail.example.com", cb);
+  EXPECT_EQ(2U, server.serve());
+  ASSERT_EQ(1U, res.run_once(1000));
+  EXPECT_EQ(resolve_error::e_server_failure, results.back()._error);
+}
+
+TEST(resolver, cache) {
+  stub_server server;
+  server._records["a.example.com"] = {{address("192.0.2.1")}, 60, 0, false};
+  server._records["b.example.com"] = {{address("192.0.2.2")}, 60, 0, false};
+  server._records["short.example.com"] = {{address("192.0.2.3")}, 1, 0, false};
+  server._records["tc.example.com"] = {{address("192.0.2.4")}, 60, 0, true};
+
+  auto conf = make_config(server);
+  conf._max_cache = 2;
+  resolver res;
+  EXPECT_TRUE(res.open(conf));
+  std::vector<resolve_result> results;
+  auto const lookup = [&](char const *name) {
+    res.resolve(name, [&](resolve_result const &result) { results.push_back(result); });
+    return res.get_pending() ? server.serve() : 0;
+  };
+
+  // truncated answer is used but isn't cached
+  for (size_t i = 0; i < 2; ++i) {
+    EXPECT_EQ(2U, lookup("tc.example.com"));
+    ASSERT_EQ(1U, res.run_once(1000));
+    EXPECT_EQ(std::vector<address>{address("192.0.2.4")}, results.back()._addresses);
+  }
+  EXPECT_EQ(0U, res.get_cache_size());
+
+  // full cache drops entry which expires first
+  for (char const *name : {"short.example.com", "a.example.com", "b.example.com"}) {
+    EXPECT_EQ(2U, lookup(name));
+    ASSERT_EQ(1U, res.run_once(1000));
+    EXPECT_TRUE(results.back());
+  }
+  EXPECT_EQ(2U, res.get_cache_size());
+  EXPECT_EQ(0U, lookup("a.example.com"));
+  EXPECT_EQ(0U, lookup("b.example.com"));
+  EXPECT_EQ(2U, lookup("short.example.com"));
+  EXPECT_EQ(1U, res.run_once(1000));
+
+}
+
+TEST(resolver, eviction) {
+  stub_server server;
+  server._records["example.com"] = {{address("192.0.2.1")}, 60, 0, false};
+
+  auto conf = make_config(server);
+  conf._max_ttl = 1;
+  resolver res;
+  EXPECT_TRUE(res.open(conf));
+  std::vector<resolve_result> results;
+  res.resolve("example.com", [&](resolve_result const &result) { results.push_back(result); });
+  EXPECT_EQ(2U, server.serve());
+  EXPECT_EQ(1U, res.run_once(1000));
+  EXPECT_EQ(1U, res.get_cache_size());
+
+  // expired entries are swept by process() without lookups of the same names
+  std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+  res.process();
+  EXPECT_EQ(0U, res.get_cache_size());
+}
+
+TEST(resolver, timeout) {
+  stub_server server;
+  resolver res;
+  EXPECT_TRUE(res.open(make_config(server)));
+
+  std::vector<resolve_result> results;
+  res.resolve("lost.example.com", [&](resolve_result const &result) { results.push_back(result); });
+  EXPECT_EQ(2U, server.serve(false));
+  auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (results.empty() && std::chrono::steady_clock::now() < deadline)
+    res.run_once(1000);
+  ASSERT_EQ(1U, results.size());
+  EXPECT_EQ(resolve_error::e_timeout, results[0]._error);
+  EXPECT_EQ(0U, res.get_pending());
+}
+
+TEST(resolver, closed) {
+  resolver res;
+  std::vector<resolve_result> results;
+  res.resolve("www.example.com", [&](resolve_result const &result) { results.push_back(result); });
+  ASSERT_EQ(1U, results.size());
+  EXPECT_EQ(resolve_error::e_server_failure, results[0]._error);
+}
+
+#ifdef __cpp_impl_coroutine
+/**
+ * \brief eagerly started coroutine without result
+ */
+struct task {
+  struct promise_type {
+    task get_return_object() noexcept {
+      return {};
+    }
+    std::suspend_never initial_suspend() noexcept {
+      return {};
+    }
+    std::suspend_never final_suspend() noexcept {
+      return {};
+    }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept {}
+  };
+};
+
+task lookup(resolver &res, std::string name, std::vector<resolve_result> &results) {
+  results.push_back(co_await res.async_resolve(name));
+  results.push_back(co_await res.async_resolve("10.0.0.1"));
+}
+
+TEST(resolver, coroutine) {
+  stub_server server;
+  server._records["www.example.com"] = {{address("192.0.2.1")}, 60, 0};
+  resolver res;
+  EXPECT_TRUE(res.open(make_config(server)));
+
+  std::vector<resolve_result> results;
+  lookup(res, "www.example.com", results);
+  EXPECT_TRUE(results.empty());
+  EXPECT_EQ(2U, server.serve());
+  EXPECT_EQ(1U, res.run_once(1000));
+  ASSERT_EQ(2U, results.size());
+  EXPECT_EQ(std::vector<address>{address("192.0.2.1")}, results[0]._addresses);
+  EXPECT_EQ(std::vector<address>{address("10.0.0.1")}, results[1]._addresses);
+}
+#endif // __cpp_impl_coroutine
+
+} // namespace bro::protocols::test
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/reverse_dns.h>
+
+#include <random>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::from_ptr_name;
+using bro::net::proto::ip::to_ptr_name;
+
+TEST(reverse_dns, v4_name) {
+  EXPECT_EQ("1.0.168.192.in-addr.arpa", to_ptr_name(address("192.168.0.1")));
+  EXPECT_EQ("255.255.255.255.in-addr.arpa", to_ptr_name(address("255.255.255.255")));
+  EXPECT_EQ("0.0.0.0.in-addr.arpa", to_ptr_name(address("0.0.0.0")));
+  EXPECT_EQ("", to_ptr_name(address()));
+}
+
+TEST(reverse_dns, v6_name) {
+  auto const name = to_ptr_name(address("2001:db8::567:89ab"));
+  EXPECT_EQ("b.a.9.8.7.6.5.0.0.0.0.0.0.0.0.0.0.0.0.0.0.0.0.0.8.b.d.0.1.0.0.2.ip6.arpa", name);
+  EXPECT_EQ(size_t(bro::net::proto::ip::e_v6_ptr_name), name.size());
+}
+
+TEST(reverse_dns, parse) {
+  address addr;
+  EXPECT_TRUE(from_ptr_name("1.0.168.192.in-addr.arpa", addr));
+  EXPECT_EQ(address("192.168.0.1"), addr);
+  EXPECT_TRUE(from_ptr_name("1.0.168.192.IN-ADDR.ARPA.", addr));
+  EXPECT_EQ(address("192.168.0.1"), addr);
+  EXPECT_TRUE(from_ptr_name("B.A.9.8.7.6.5.0.0.0.0.0.0.0.0.0.0.0.0.0.0.0.0.0.8.b.d.0.1.0.0.2.ip6.arpa.", addr));
+  EXPECT_EQ(address("2001:db8::567:89ab"), addr);
+
+  EXPECT_FALSE(from_ptr_name("", addr));
+  EXPECT_FALSE(from_ptr_name("in-addr.arpa", addr));
+  EXPECT_FALSE(from_ptr_name("0.168.192.in-addr.arpa", addr));
+  EXPECT_FALSE(from_ptr_name("1.1.0.168.192.in-addr.arpa", addr));
+  EXPECT_FALSE(from_ptr_name("256.0.168.192.in-addr.arpa", addr));
+  EXPECT_FALSE(from_ptr_name("1..168.192.in-addr.arpa", addr));
+  EXPECT_FALSE(from_ptr_name("1.0.168.192.ip6.arpa", addr));
+  EXPECT_FALSE(from_ptr_name("g.a.9.8.7.6.5.0.0.0.0.0.0.0.0.0.0.0.0.0.0.0.0.0.8.b.d.0.1.0.0.2.ip6.arpa", addr));
+  EXPECT_FALSE(from_ptr_name("ba.9.8.7.6.5.0.0.0.0.0.0.0.0.0.0.0.0.0.0.0.0.0.0.8.b.d.0.1.0.0.2.ip6.arpa", addr));
+  EXPECT_FALSE(from_ptr_name("1.0.168.192.example.com", addr));
+}
+
+TEST(reverse_dns, batch_round_trip) {
+  std::mt19937_64 gen(7);
+  std::vector<address> addrs;
+  for (size_t i = 0; i < 256; ++i) {
+    if (i % 2)
+      addrs.emplace_back(bro::net::proto::ip::v4::address(static_cast<uint32_t>(gen())));
+    else
+      addrs.emplace_back(bro::net::proto::ip::v6::address(gen(), gen()));
+  }
+
+  std::vector<char> names(addrs.size() * bro::net::proto::ip::e_max_ptr_name);
+  std::vector<size_t> lengths(addrs.size());
+  bro::net::proto::ip::to_ptr_names(addrs.data(), addrs.size(), names.data(), lengths.data());
+  for (size_t i = 0; i < addrs.size(); ++i) {
+    std::string_view const name(names.data() + i * bro::net::proto::ip::e_max_ptr_name, lengths[i]);
+    EXPECT_EQ(to_ptr_name(addrs[i]), name);
+    address parsed;
+    EXPECT_TRUE(from_ptr_name(name, parsed));
+    EXPECT_EQ(addrs[i], parsed);
+  }
+}
+
+} // namespace bro::protocols::test
@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/prefix.h>
+#include <protocols/ip/sketch.h>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::prefix;
+
+static address make_v4(uint32_t i) {
+  return address(bro::net::proto::ip::v4::address(__builtin_bswap32(i)));
+}
+
+TEST(sketch, hash) {
+  bro::net::proto::ip::v4::address v4("10.0.0.1");
+  bro::net::proto::ip::v6::address v6("fe80::1");
+  EXPECT_EQ(bro::net::proto::ip::hash(v4), bro::net::proto::ip::hash(address(v4)));
+  EXPECT_EQ(bro::net::proto::ip::hash(v6), bro::net::proto::ip::hash(address(v6)));
+  EXPECT_NE(bro::net::proto::ip::hash(v4), bro::net::proto::ip::hash(v4, 1));
+}
+
+TEST(sketch, count_min) {
+  bro::net::proto::ip::count_min_sketch sketch(1024, 4);
+  bro::net::proto::ip::count_min_sketch other(1024, 4);
+  for (uint32_t i = 0; i < 10000; ++i)
+    sketch.add(make_v4(i % 100));
+  other.add(address("fe80::1"), 500);
+
+  EXPECT_GE(sketch.estimate(make_v4(7)), 100u);
+  EXPECT_LE(sketch.estimate(make_v4(7)), 150u);
+  EXPECT_TRUE(sketch.merge(other));
+  EXPECT_GE(sketch.estimate(address("fe80::1")), 500u);
+  EXPECT_EQ(10500u, sketch.get_total());
+  EXPECT_FALSE(sketch.merge(bro::net::proto::ip::count_min_sketch(512, 4)));
+}
+
+TEST(sketch, space_saving) {
+  bro::net::proto::ip::space_saving summary(16);
+  for (uint32_t i = 0; i < 10000; ++i) {
+    summary.add(make_v4(1000 + i));
+    if (i % 4 == 0)
+      summary.add(make_v4(1));
+  }
+  auto top = summary.top(1);
+  ASSERT_EQ(1u, top.size());
+  EXPECT_EQ(make_v4(1), top[0]._address);
+  EXPECT_GE(top[0]._count, 2500u);
+  EXPECT_LE(top[0]._count - top[0]._error, 2500u);
+
+  bro::net::proto::ip::space_saving other(16);
+  other.add(address("fe80::1"), 5000);
+  summary.merge(other);
+  EXPECT_EQ(address("fe80::1"), summary.top(1)[0]._address);
+  EXPECT_EQ(16u, summary.size());
+}
+
+TEST(sketch, hyperloglog) {
+  bro::net::proto::ip::hyperloglog counter(12);
+  bro::net::proto::ip::hyperloglog other(12);
+  for (uint32_t i = 0; i < 50000; ++i) {
+    counter.add(make_v4(i));
+    other.add(make_v4(i + 25000));
+  }
+  EXPECT_NEAR(50000.0, double(counter.estimate()), 2500.0);
+  EXPECT_TRUE(counter.merge(other));
+  EXPECT_NEAR(75000.0, double(counter.estimate()), 3750.0);
+  EXPECT_FALSE(counter.merge(bro::net::proto::ip::hyperloglog(10)));
+}
+
+TEST(sketch, hierarchical_heavy_hitters) {
+  bro::net::proto::ip::hierarchical_heavy_hitters hhh(64);
+  // one heavy host and a heavy /24 spread over many hosts
+  hhh.add(address("10.0.0.1"), 1000);
+  for (uint32_t i = 0; i < 200; ++i)
+    hhh.add(address("192.168.7." + std::to_string(i)), 5);
+
+  auto res = hhh.query(500);
+  ASSERT_EQ(2u, res.size());
+  EXPECT_EQ(prefix("10.0.0.1/32"), res[0]._prefix);
+  EXPECT_EQ(1000u, res[0]._count);
+  EXPECT_EQ(prefix("192.168.7.0/24"), res[1]._prefix);
+  EXPECT_EQ(1000u, res[1]._count);
+}
+
+} // namespace bro::protocols::test
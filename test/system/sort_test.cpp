@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/sort.h>
+
+#include <algorithm>
+#include <random>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::full_address;
+
+template <typename T> static void check_sort(std::vector<T> addrs, size_t threads) {
+  auto expected = addrs;
+  std::stable_sort(expected.begin(), expected.end(), bro::net::proto::ip::network_order_less{});
+  bro::net::proto::ip::sort(addrs, threads);
+  EXPECT_TRUE(expected == addrs);
+}
+
+TEST(sort, v4) {
+  std::mt19937 gen(1);
+  std::vector<bro::net::proto::ip::v4::address> addrs;
+  for (size_t i = 0; i < 300000; ++i)
+    addrs.emplace_back(static_cast<uint32_t>(gen() & 0xff00ffff));
+  check_sort(addrs, 1);
+  check_sort(addrs, 4);
+
+  bro::net::proto::ip::v4::address small[] = {bro::net::proto::ip::v4::address("10.0.0.2"),
+                                              bro::net::proto::ip::v4::address("9.0.0.3"),
+                                              bro::net::proto::ip::v4::address("10.0.0.1")};
+  bro::net::proto::ip::sort(small, 3);
+  EXPECT_EQ("9.0.0.3", small[0].to_string());
+  EXPECT_EQ("10.0.0.1", small[1].to_string());
+  EXPECT_EQ("10.0.0.2", small[2].to_string());
+}
+
+TEST(sort, v6) {
+  std::mt19937_64 gen(2);
+  std::vector<bro::net::proto::ip::v6::address> addrs;
+  for (size_t i = 0; i < 300000; ++i)
+    addrs.emplace_back(gen() & 0xffff, gen());
+  check_sort(addrs, 1);
+  check_sort(addrs, 4);
+}
+
+TEST(sort, address) {
+  std::mt19937_64 gen(3);
+  std::vector<address> addrs;
+  for (size_t i = 0; i < 300000; ++i) {
+    if (i % 3)
+      addrs.emplace_back(bro::net::proto::ip::v4::address(static_cast<uint32_t>(gen())));
+    else
+      addrs.emplace_back(bro::net::proto::ip::v6::address(gen(), gen()));
+  }
+  check_sort(addrs, 1);
+  check_sort(addrs, 4);
+
+  std::vector<full_address> faddrs;
+  for (size_t i = 0; i < 300000; ++i)
+    faddrs.emplace_back(addrs[i % 10], static_cast<uint16_t>(gen()));
+  check_sort(faddrs, 1);
+  check_sort(faddrs, 4);
+}
+
+TEST(sort, unique_count) {
+  std::vector<address> addrs{address("10.0.0.2"), address("fe80::1"), address("10.0.0.1"), address("10.0.0.2"),
+                             address("10.0.0.2")};
+  bro::net::proto::ip::sort(addrs);
+  auto counts = bro::net::proto::ip::unique_count(addrs);
+  ASSERT_EQ(3u, addrs.size());
+  EXPECT_EQ(address("10.0.0.1"), addrs[0]);
+  EXPECT_EQ(address("10.0.0.2"), addrs[1]);
+  EXPECT_EQ(address("fe80::1"), addrs[2]);
+  EXPECT_EQ((std::vector<size_t>{1, 3, 1}), counts);
+}
+
+} // namespace bro::protocols::test
@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/address.h>
+#include <protocols/ip/stats.h>
+
+#include <thread>
+
+namespace bro::protocols::test {
+
+namespace stats = bro::net::proto::ip::stats;
+
+TEST(stats, collect) {
+  stats::reset();
+  std::thread worker([] {
+    bro::net::proto::ip::address addr("192.168.0.1");
+    bro::net::proto::ip::address bad("192.168.0.256");
+    EXPECT_EQ("192.168.0.1", addr.to_string());
+  });
+  worker.join();
+
+  auto const res = stats::collect();
+  auto const &parse = res._operations[static_cast<size_t>(stats::operation::e_parse)];
+  auto const &format = res._operations[static_cast<size_t>(stats::operation::e_format)];
+  if (!stats::enabled()) {
+    EXPECT_EQ(0u, parse._count);
+    return;
+  }
+
+  EXPECT_EQ(2u, parse._count);
+  EXPECT_EQ(1u, format._count);
+  EXPECT_EQ(1u, res._counters[static_cast<size_t>(stats::counter::e_parse_failed)]);
+  EXPECT_EQ(1u, res._counters[static_cast<size_t>(stats::counter::e_string_alloc)]);
+  uint64_t histogram = 0;
+  for (auto count : parse._histogram)
+    histogram += count;
+  EXPECT_EQ(2u, histogram);
+  EXPECT_GT(res._ticks_per_ns, 0);
+
+  stats::reset();
+  EXPECT_EQ(0u, stats::collect()._operations[static_cast<size_t>(stats::operation::e_parse)]._count);
+}
+
+} // namespace bro::protocols::test
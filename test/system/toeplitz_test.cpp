@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/toeplitz.h>
+
+#include <random>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::flow_keys;
+using bro::net::proto::ip::full_address;
+using bro::net::proto::ip::packet_status;
+using bro::net::proto::ip::rss;
+using bro::net::proto::ip::rss_hash;
+using bro::net::proto::ip::toeplitz;
+using bro::net::proto::ip::toeplitz_hash;
+
+/**
+ * Microsoft RSS verification suite
+ */
+struct rss_vector {
+  char const *_source;
+  uint16_t _source_port;
+  char const *_destination;
+  uint16_t _destination_port;
+  uint32_t _hash_2_tuple;
+  uint32_t _hash_4_tuple;
+};
+
+static rss_vector const vectors[] = {
+  {"66.9.149.187", 2794, "161.142.100.80", 1766, 0x323e8fc2, 0x51ccc178},
+  {"199.92.111.2", 14230, "65.69.140.83", 4739, 0xd718262a, 0xc626b0ea},
+  {"24.19.198.95", 12898, "12.22.207.184", 38024, 0xd2d0a5de, 0x5c2b394a},
+  {"38.27.205.30", 48228, "209.142.163.6", 2217, 0x82989176, 0xafc7327f},
+  {"153.39.163.191", 44251, "202.188.127.2", 1303, 0x5d1809c5, 0x10e828a2},
+  {"3ffe:2501:200:1fff::7", 2794, "3ffe:2501:200:3::1", 1766, 0x2cc18cd5, 0x40207d3d},
+  {"3ffe:501:8::260:97ff:fe40:efab", 14230, "ff02::1", 4739, 0x0f0c461c, 0xdde51bbf},
+  {"3ffe:1900:4545:3:200:f8ff:fe21:67cf", 44251, "fe80::200:f8ff:fe21:67cf", 38024, 0x4b61e985, 0x02d1feef},
+};
+
+TEST(toeplitz, verification_suite) {
+  toeplitz const hasher;
+  for (auto const &vec : vectors) {
+    address const src(vec._source), dst(vec._destination);
+    full_address const source(src, vec._source_port), destination(dst, vec._destination_port);
+    EXPECT_EQ(vec._hash_2_tuple, hasher.hash(src, dst)) << vec._source;
+    EXPECT_EQ(vec._hash_4_tuple, hasher.hash(source, destination)) << vec._source;
+    EXPECT_EQ(vec._hash_4_tuple, rss_hash(source, destination)) << vec._source;
+    if (src.is_ipv4()) {
+      EXPECT_EQ(vec._hash_2_tuple, hasher.hash(src.to_v4(), dst.to_v4()));
+      EXPECT_EQ(vec._hash_4_tuple, hasher.hash(src.to_v4(), dst.to_v4(), vec._source_port, vec._destination_port));
+    } else {
+      EXPECT_EQ(vec._hash_2_tuple, hasher.hash(src.to_v6(), dst.to_v6()));
+      EXPECT_EQ(vec._hash_4_tuple, hasher.hash(src.to_v6(), dst.to_v6(), vec._source_port, vec._destination_port));
+    }
+  }
+  EXPECT_EQ(0U, hasher.hash(address("10.0.0.1"), address("::1")));
+  EXPECT_EQ(0U, hasher.hash(address(), address()));
+  EXPECT_EQ(0U, hasher.hash(full_address(address("10.0.0.1"), 1), full_address(address("::1"), 1)));
+}
+
+TEST(toeplitz, random_key) {
+  // table driven hash matches bitwise one for any key and input
+  std::mt19937 gen(7);
+  for (size_t key_size : {size_t(0), size_t(16), size_t(rss::e_key_size), size_t(52)}) {
+    std::vector<uint8_t> key(key_size);
+    for (auto &byte : key)
+      byte = static_cast<uint8_t>(gen());
+    toeplitz const hasher(key.data(), key.size());
+    for (size_t i = 0; i < 200; ++i) {
+      uint8_t data[toeplitz::e_max_input];
+      for (auto &byte : data)
+        byte = static_cast<uint8_t>(gen());
+      size_t const size = gen() % (sizeof(data) + 1);
+      EXPECT_EQ(toeplitz_hash(key.data(), key.size(), data, size), hasher.hash(data, size));
+    }
+  }
+}
+
+TEST(toeplitz, burst) {
+  toeplitz const hasher;
+  size_t const size = sizeof(vectors) / sizeof(vectors[0]);
+  std::vector<full_address> sources, destinations;
+  for (auto const &vec : vectors) {
+    sources.emplace_back(address(vec._source), vec._source_port);
+    destinations.emplace_back(address(vec._destination), vec._destination_port);
+  }
+  std::vector<uint32_t> res(size);
+  hasher.hash(sources.data(), destinations.data(), size, res.data());
+  for (size_t i = 0; i < size; ++i)
+    EXPECT_EQ(vectors[i]._hash_4_tuple, res[i]);
+
+  // tcp, udp, icmp, fragment, not ip
+  flow_keys keys(8);
+  keys._size = 5;
+  uint8_t const protocols[] = {6, 17, 1, 6, 0};
+  packet_status const statuses[] = {packet_status::e_ok, packet_status::e_ok, packet_status::e_ok,
+                                    packet_status::e_fragment, packet_status::e_not_ip};
+  for (size_t i = 0; i < keys._size; ++i) {
+    keys._sources[i] = address(vectors[i]._source);
+    keys._destinations[i] = address(vectors[i]._destination);
+    keys._source_ports[i] = vectors[i]._source_port;
+    keys._destination_ports[i] = vectors[i]._destination_port;
+    keys._protocols[i] = protocols[i];
+    keys._statuses[i] = statuses[i];
+  }
+  keys._sources[4] = keys._destinations[4] = address();
+  std::vector<uint32_t> keys_res(keys._size, 1);
+  hasher.hash(keys, keys_res.data());
+  EXPECT_EQ(vectors[0]._hash_4_tuple, keys_res[0]);
+  EXPECT_EQ(vectors[1]._hash_4_tuple, keys_res[1]);
+  EXPECT_EQ(vectors[2]._hash_2_tuple, keys_res[2]);
+  EXPECT_EQ(vectors[3]._hash_2_tuple, keys_res[3]);
+  EXPECT_EQ(0U, keys_res[4]);
+}
+
+} // namespace bro::protocols::test
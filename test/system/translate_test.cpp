@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <gtest/gtest.h>
+#include <protocols/ip/translate.h>
+
+#include <random>
+#include <vector>
+
+namespace bro::protocols::test {
+
+using bro::net::proto::ip::address;
+using bro::net::proto::ip::nat64;
+using bro::net::proto::ip::prefix;
+namespace v4 = bro::net::proto::ip::v4;
+namespace v6 = bro::net::proto::ip::v6;
+
+TEST(translate, rfc6052_examples) {
+  // RFC 6052 section 2.4
+  struct {
+    char const *_prefix;
+    char const *_address;
+  } const cases[] = {
+    {"2001:db8::/32", "2001:db8:c000:221::"},
+    {"2001:db8:100::/40", "2001:db8:1c0:2:21::"},
+    {"2001:db8:122::/48", "2001:db8:122:c000:2:2100::"},
+    {"2001:db8:122:300::/56", "2001:db8:122:3c0:0:221::"},
+    {"2001:db8:122:344::/64", "2001:db8:122:344:c0:2:2100:0"},
+    {"2001:db8:122:344::/96", "2001:db8:122:344::192.0.2.33"},
+  };
+  v4::address const addr("192.0.2.33");
+  for (auto const &test : cases) {
+    nat64 translator;
+    EXPECT_TRUE(translator.set_prefix(prefix(test._prefix))) << test._prefix;
+    EXPECT_EQ(v6::address(test._address), translator.embed(addr)) << test._prefix;
+    v4::address extracted;
+    EXPECT_TRUE(translator.extract(v6::address(test._address), extracted)) << test._prefix;
+    EXPECT_EQ(addr, extracted);
+  }
+
+  nat64 const well_known;
+  EXPECT_EQ(v6::address("64:ff9b::192.0.2.33"), well_known.embed(addr));
+  v4::address extracted;
+  EXPECT_FALSE(well_known.extract(v6::address("64:ff9c::192.0.2.33"), extracted));
+}
+
+TEST(translate, invalid_prefix) {
+  nat64 translator;
+  EXPECT_FALSE(translator.set_prefix(prefix("2001:db8::/33")));
+  EXPECT_FALSE(translator.set_prefix(prefix("10.0.0.0/8")));
+  EXPECT_FALSE(translator.set_prefix(prefix("2001:db8:0:0:100::/96")));
+  EXPECT_EQ("64:ff9b::/96", translator.get_prefix().to_string());
+
+  // "u" octet must be zero
+  EXPECT_TRUE(translator.set_prefix(prefix("2001:db8::/32")));
+  v4::address extracted;
+  EXPECT_FALSE(translator.extract(v6::address("2001:db8:c000:221:100::"), extracted));
+  // suffix is ignored
+  EXPECT_TRUE(translator.extract(v6::address("2001:db8:c000:221:0:1::"), extracted));
+}
+
+TEST(translate, batch) {
+  std::mt19937 gen(13);
+  std::vector<v4::address> addrs(1000);
+  for (auto &addr : addrs)
+    addr = v4::address(static_cast<uint32_t>(gen()));
+
+  for (auto const *pref : {"2001:db8::/32", "2001:db8:100::/40", "2001:db8:122::/48", "2001:db8:122:300::/56",
+                           "2001:db8:122:344::/64", "64:ff9b::/96"}) {
+    nat64 translator;
+    EXPECT_TRUE(translator.set_prefix(prefix(pref)));
+    std::vector<v6::address> embedded(addrs.size());
+    translator.embed(addrs.data(), addrs.size(), embedded.data());
+    embedded.push_back(v6::address("2001:db9::1"));
+    std::vector<v4::address> extracted(embedded.size());
+    EXPECT_EQ(addrs.size(), translator.extract(embedded.data(), embedded.size(), extracted.data()));
+    for (size_t i = 0; i < addrs.size(); ++i) {
+      EXPECT_EQ(addrs[i], extracted[i]) << pref;
+      EXPECT_TRUE(prefix(pref).contains(address(embedded[i])));
+    }
+    EXPECT_EQ(v4::address("0.0.0.0"), extracted.back());
+  }
+}
+
+TEST(translate, embedded_ipv4) {
+  using namespace bro::net::proto::ip;
+  v4::address extracted;
+  EXPECT_EQ(v6::address("::ffff:1.2.3.4"), to_v4_mapped(v4::address("1.2.3.4")));
+  EXPECT_TRUE(is_v4_mapped(v6::address("::ffff:1.2.3.4")));
+  EXPECT_FALSE(is_v4_mapped(v6::address("::fffe:1.2.3.4")));
+  EXPECT_TRUE(extract_v4_mapped(v6::address("::ffff:1.2.3.4"), extracted));
+  EXPECT_EQ(v4::address("1.2.3.4"), extracted);
+  EXPECT_FALSE(extract_v4_mapped(v6::address("1::ffff:1.2.3.4"), extracted));
+
+  v4::address const mapped_in[] = {v4::address("10.0.0.1"), v4::address("10.0.0.2")};
+  v6::address mapped[3];
+  to_v4_mapped(mapped_in, 2, mapped);
+  mapped[2] = v6::address("2001:db8::1");
+  v4::address mapped_out[3];
+  EXPECT_EQ(2U, extract_v4_mapped(mapped, 3, mapped_out));
+  EXPECT_EQ(v4::address("10.0.0.2"), mapped_out[1]);
+  EXPECT_EQ(v4::address("0.0.0.0"), mapped_out[2]);
+
+  EXPECT_TRUE(extract_v4_compatible(v6::address("::1.2.3.4"), extracted));
+  EXPECT_EQ(v4::address("1.2.3.4"), extracted);
+  EXPECT_FALSE(extract_v4_compatible(v6::address("::1"), extracted));
+  EXPECT_FALSE(extract_v4_compatible(v6::address("::ffff:1.2.3.4"), extracted));
+
+  EXPECT_EQ(v6::address("2002:c000:204::"), to_6to4(v4::address("192.0.2.4")));
+  EXPECT_TRUE(extract_6to4(v6::address("2002:c000:204:1::1"), extracted));
+  EXPECT_EQ(v4::address("192.0.2.4"), extracted);
+  EXPECT_FALSE(extract_6to4(v6::address("2003:c000:204::"), extracted));
+
+  // RFC 4380 section 4 example
+  teredo_info info;
+  EXPECT_TRUE(extract_teredo(v6::address("2001:0000:4136:e378:8000:63bf:3fff:fdd2"), info));
+  EXPECT_EQ(v4::address("65.54.227.120"), info._server);
+  EXPECT_EQ(v4::address("192.0.2.45"), info._client);
+  EXPECT_EQ(40000, info._port);
+  EXPECT_EQ(0x8000, info._flags);
+  EXPECT_FALSE(extract_teredo(v6::address("2001:db8::1"), info));
+}
+
+} // namespace bro::protocols::test
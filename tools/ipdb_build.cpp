@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: BSD-3-Clause
+#include <protocols/ip/database.h>
+
+#include <fstream>
+#include <iostream>
+
+/**
+ * build prefix database from csv file
+ *
+ * every line is "prefix,value" (ex. "10.0.0.0/8,AS64512"), value is the rest
+ * of line. empty lines and lines starting with '#' are skipped.
+ */
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    std::cerr << "usage: " << argv[0] << " <input.csv> <output.db>" << std::endl;
+    return 1;
+  }
+
+  std::ifstream input(argv[1]);
+  if (!input) {
+    std::cerr << "couldn't open " << argv[1] << std::endl;
+    return 1;
+  }
+
+  bro::net::proto::ip::database_builder builder;
+  std::string line;
+  size_t line_number = 0, prefixes = 0;
+  while (std::getline(input, line)) {
+    ++line_number;
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    if (line.empty() || line[0] == '#')
+      continue;
+    auto const comma = line.find(',');
+    bro::net::proto::ip::prefix pref;
+    if (comma == std::string::npos || !bro::net::proto::ip::string_to_prefix(line.substr(0, comma), pref) ||
+        !builder.insert(pref, std::string_view(line).substr(comma + 1))) {
+      std::cerr << argv[1] << ":" << line_number << ": invalid line" << std::endl;
+      return 1;
+    }
+    ++prefixes;
+  }
+
+  if (!builder.save(argv[2])) {
+    std::cerr << "couldn't write " << argv[2] << std::endl;
+    return 1;
+  }
+  std::cout << prefixes << " prefixes written to " << argv[2] << std::endl;
+  return 0;
+}